@@ -0,0 +1,89 @@
+#include <StormByte/system/capture_buffer.hxx>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace StormByte::System;
+
+CaptureBuffer::CaptureBuffer(const CapturePolicy& policy):
+	m_policy(policy), m_ring_pos(0), m_ring_full(false), m_total(0) {
+	switch (m_policy.mode) {
+		case CapturePolicy::Mode::FULL:
+		case CapturePolicy::Mode::DISCARD:
+			m_policy.head = m_policy.tail = 0;
+			break;
+		case CapturePolicy::Mode::HEAD:
+			m_policy.tail = 0;
+			break;
+		case CapturePolicy::Mode::TAIL:
+			m_policy.head = 0;
+			break;
+		case CapturePolicy::Mode::HEAD_TAIL:
+			break;
+	}
+	m_head.reserve(m_policy.head);
+	m_ring.resize(m_policy.tail);
+}
+
+void CaptureBuffer::Append(std::string_view data) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_total += data.size();
+	if (m_policy.mode == CapturePolicy::Mode::FULL) {
+		m_head.append(data);
+		return;
+	}
+
+	const size_t head = std::min(data.size(), m_policy.head - m_head.size());
+	m_head.append(data.substr(0, head));
+	data.remove_prefix(head);
+
+	const size_t tail = m_ring.size();
+	if (data.empty() || tail == 0)
+		return;
+	if (data.size() >= tail) {
+		std::memcpy(m_ring.data(), data.data() + data.size() - tail, tail);
+		m_ring_pos = 0;
+		m_ring_full = true;
+		return;
+	}
+	const size_t first = std::min(data.size(), tail - m_ring_pos);
+	std::memcpy(m_ring.data() + m_ring_pos, data.data(), first);
+	std::memcpy(m_ring.data(), data.data() + first, data.size() - first);
+	if (m_ring_pos + data.size() >= tail)
+		m_ring_full = true;
+	m_ring_pos = (m_ring_pos + data.size()) % tail;
+}
+
+CaptureResult CaptureBuffer::Result() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	CaptureResult result;
+	result.total = m_total;
+
+	const size_t ring = m_ring_full ? m_ring.size() : m_ring_pos;
+	const uint64_t dropped = m_total - m_head.size() - ring;
+	result.truncated = dropped > 0;
+
+	result.data.reserve(m_head.size() + ring + MARKER.size() + 20);
+	result.data.append(m_head);
+	if (m_policy.mode == CapturePolicy::Mode::HEAD_TAIL && dropped > 0) {
+		const size_t at = MARKER.find("{}");
+		result.data.append(MARKER.substr(0, at));
+		result.data.append(std::to_string(dropped));
+		result.data.append(MARKER.substr(at + 2));
+	}
+	if (m_ring_full)
+		result.data.append(m_ring, m_ring_pos, std::string::npos);
+	result.data.append(m_ring, 0, m_ring_pos);
+	return result;
+}
+
+void ChunkLog::Append(Process::Stream stream, std::string_view data) {
+	// Stamped under the lock so timestamps never go backwards in the log
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_chunks.push_back(Process::Chunk { stream, std::chrono::steady_clock::now(), std::string(data) });
+}
+
+std::vector<Process::Chunk> ChunkLog::Take() noexcept {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return std::move(m_chunks);
+}
@@ -0,0 +1,154 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/capture.hxx>
+#include <StormByte/system/process.hxx>
+#include <StormByte/system/visibility.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	/**
+	 * @class CaptureBuffer
+	 * @brief Bounded store filled by a capture while the child runs.
+	 *
+	 * Storage is allocated once from the policy; the tail is a ring
+	 * overwritten in place.
+	 */
+	class STORMBYTE_SYSTEM_PRIVATE CaptureBuffer {
+		public:
+			/**
+			 * Text placed between head and tail; `{}` is replaced by the dropped byte count.
+			 */
+			static constexpr const std::string_view MARKER = "\n[... {} bytes truncated ...]\n";
+
+			/**
+			 * @param policy Policy.
+			 */
+			explicit CaptureBuffer(const CapturePolicy& policy);
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			CaptureBuffer(const CaptureBuffer&) = delete;
+
+			/**
+			 * Move constructor (deleted).
+			 */
+			CaptureBuffer(CaptureBuffer&&) = delete;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			CaptureBuffer& operator=(const CaptureBuffer&) = delete;
+
+			/**
+			 * Move assignment (deleted).
+			 */
+			CaptureBuffer& operator=(CaptureBuffer&&) = delete;
+
+			/**
+			 * Destructor.
+			 */
+			~CaptureBuffer() noexcept = default;
+
+			/**
+			 * Stores @p data according to the policy.
+			 * @param data Chunk.
+			 */
+			void Append(std::string_view data);
+
+			/**
+			 * @return What was kept so far.
+			 */
+			CaptureResult Result() const;
+
+		private:
+			CapturePolicy m_policy;		///< Policy
+			mutable std::mutex m_mutex;	///< Protects the storage
+			std::string m_head;			///< Head (or everything for FULL)
+			std::string m_ring;			///< Tail ring
+			size_t m_ring_pos;			///< Next ring write position
+			bool m_ring_full;			///< Ring wrapped at least once
+			uint64_t m_total;			///< Bytes seen
+	};
+
+	/**
+	 * @class ChunkLog
+	 * @brief Chunks of several streams in the order they were read.
+	 */
+	class STORMBYTE_SYSTEM_PRIVATE ChunkLog {
+		public:
+			/**
+			 * Constructor.
+			 */
+			ChunkLog() noexcept = default;
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			ChunkLog(const ChunkLog&) = delete;
+
+			/**
+			 * Move constructor (deleted).
+			 */
+			ChunkLog(ChunkLog&&) = delete;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			ChunkLog& operator=(const ChunkLog&) = delete;
+
+			/**
+			 * Move assignment (deleted).
+			 */
+			ChunkLog& operator=(ChunkLog&&) = delete;
+
+			/**
+			 * Destructor.
+			 */
+			~ChunkLog() noexcept = default;
+
+			/**
+			 * Records @p data, stamped now.
+			 * @param stream Origin.
+			 * @param data Chunk.
+			 */
+			void Append(Process::Stream stream, std::string_view data);
+
+			/**
+			 * @return Recorded chunks (moved out).
+			 */
+			std::vector<Process::Chunk> Take() noexcept;
+
+		private:
+			std::mutex m_mutex;						///< Protects m_chunks
+			std::vector<Process::Chunk> m_chunks;	///< Chunks in read order
+	};
+}
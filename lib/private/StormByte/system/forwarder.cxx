@@ -0,0 +1,278 @@
+#include <StormByte/system/executor.hxx>
+#include <StormByte/system/forwarder.hxx>
+#include <StormByte/system/pipe.hxx>
+#include <StormByte/system/reactor.hxx>
+#include <StormByte/system/reaper.hxx>
+#include <StormByte/system/tracer.hxx>
+
+#ifdef UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef LINUX
+#include <poll.h>
+#include <sys/epoll.h>
+#endif
+
+using namespace StormByte::System;
+
+namespace {
+	#ifdef LINUX
+	constexpr const size_t PUMP_CHUNK = 256 * 1024;
+	constexpr const int PUMP_ROUNDS = 16;			///< Reads per pump before yielding the worker
+
+	/**
+	 * Opens a new description of the pipe end @p fd, so O_NONBLOCK on it does
+	 * not leak into writers and readers still using the Pipe (a dup() would
+	 * share the flag).
+	 */
+	int Reopen(int fd, int mode) noexcept {
+		const std::string path = "/proc/self/fd/" + std::to_string(fd);
+		return ::open(path.c_str(), mode | O_NONBLOCK | O_CLOEXEC);
+	}
+	#endif
+}
+
+std::future<void> Forwarder::Start(Pipe& source, Pipe& target, std::vector<Filter> filters,
+	std::function<void()> broken, Executor& executor, int64_t id) {
+	return Launch(source, &target, std::move(filters), std::move(broken), executor, id);
+}
+
+std::future<void> Forwarder::Drain(Pipe& source, Filter consumer, Executor& executor, int64_t id) {
+	std::vector<Filter> filters;
+	filters.push_back(std::move(consumer));
+	return Launch(source, nullptr, std::move(filters), std::function<void()>(), executor, id);
+}
+
+std::future<void> Forwarder::Launch(Pipe& source, Pipe* target, std::vector<Filter> filters,
+	std::function<void()> broken, Executor& executor, int64_t id) {
+	std::shared_ptr<State> state = std::make_shared<State>();
+	state->source = &source;
+	state->target = target;
+	// Stateful stages get fresh state for this link
+	state->filters.reserve(filters.size());
+	for (const Filter& filter: filters)
+		state->filters.push_back(filter.Instantiate());
+	state->broken = std::move(broken);
+	state->executor = &executor;
+	state->id = id;
+	state->started = Tracer::On() ? Tracer::Now() : 0;
+	std::future<void> done = state->done.get_future();
+
+	#ifdef LINUX
+	state->reactor = Reactor::Instance();
+	if (state->reactor) {
+		state->in = Reopen(source.ReadHandle(), O_RDONLY);
+		state->out = target ? Reopen(target->WriteHandle(), O_WRONLY) : -1;
+		if (state->in >= 0 && (!target || state->out >= 0)) {
+			Chain(*state, Sink(&state->pending));
+			state->executor->Post([state] { Pump(state); });
+			return done;
+		}
+		for (int* fd: { &state->in, &state->out }) {
+			if (*fd >= 0)
+				::close(*fd);
+			*fd = -1;
+		}
+	}
+	#endif
+
+	Chain(*state, target ? Sink(target) : Sink(&state->pending));
+	state->executor->PostLongRunning([state] {
+		Run(*state);
+		if (state->started)
+			Tracer::Complete("forward", state->started, state->id);
+		state->done.set_value();
+		Reaper::Wake();
+	});
+	return done;
+}
+
+void Forwarder::Chain(State& state, Sink output) {
+	// sinks[i] feeds filter n - i; reserved up front because sinks point at each other
+	const size_t n = state.filters.size();
+	state.sinks.reserve(n + 1);
+	state.sinks.push_back(std::move(output));
+	for (size_t i = 1; i <= n; i++)
+		state.sinks.push_back(Sink(&state.filters[n - i], &state.sinks[i - 1]));
+}
+
+void Forwarder::Finish(State& state) {
+	const size_t n = state.filters.size();
+	for (size_t k = 0; k < n && !state.sinks[0].Closed(); k++) {
+		if (state.filters[k].m_finish)
+			state.filters[k].m_finish(state.sinks[n - k - 1]);
+	}
+}
+
+void Forwarder::TraceRead(State& state, uint64_t start, size_t bytes) noexcept {
+	if (bytes == 0) {
+		Tracer::Instant("eof", state.id);
+		return;
+	}
+	if (!state.received) {
+		state.received = true;
+		Tracer::Instant("first-byte", state.id, bytes);
+	}
+	Tracer::Complete("read", start, state.id, bytes);
+}
+
+void Forwarder::Run(State& state) {
+	Sink& input = state.sinks.back();
+#ifdef UNIX
+	std::vector<char> buffer(Pipe::MAX_READ_BYTES);
+	ssize_t bytes_read;
+	do {
+		const uint64_t start = Tracer::On() ? Tracer::Now() : 0;
+		bytes_read = state.source->Read(buffer, Pipe::MAX_READ_BYTES);
+		if (start && bytes_read >= 0)
+			TraceRead(state, start, static_cast<size_t>(bytes_read));
+		if (bytes_read > 0) {
+			const uint64_t write_start = start ? Tracer::Now() : 0;
+			input.Write(std::string_view(buffer.data(), static_cast<size_t>(bytes_read)));
+			state.pending.clear();
+			if (write_start)
+				Tracer::Complete("write", write_start, state.id, static_cast<uint64_t>(bytes_read));
+		}
+	} while ((bytes_read > 0 || (bytes_read < 0 && errno == EINTR)) && !input.Closed());
+#else
+	std::vector<CHAR> buffer(Pipe::MAX_READ_BYTES);
+	DWORD bytes_read;
+	do {
+		const uint64_t start = Tracer::On() ? Tracer::Now() : 0;
+		bytes_read = state.source->Read(buffer, static_cast<DWORD>(Pipe::MAX_READ_BYTES));
+		if (start)
+			TraceRead(state, start, bytes_read);
+		if (bytes_read > 0) {
+			const uint64_t write_start = start ? Tracer::Now() : 0;
+			input.Write(std::string_view(buffer.data(), bytes_read));
+			state.pending.clear();
+			if (write_start)
+				Tracer::Complete("write", write_start, state.id, bytes_read);
+		}
+	} while (bytes_read > 0 && !input.Closed());
+#endif
+	Finish(state);
+	state.pending.clear();
+	const bool chunks_written = !state.sinks[0].Closed();
+	if (state.target)
+		state.target->CloseWrite();
+
+	if (!chunks_written) {
+		if (state.broken)
+			state.broken();
+#ifdef UNIX
+		while (state.source->Read(buffer, Pipe::MAX_READ_BYTES) > 0);
+#else
+		while (state.source->Read(buffer, static_cast<DWORD>(Pipe::MAX_READ_BYTES)) > 0);
+#endif
+	}
+}
+
+#ifdef LINUX
+void Forwarder::Pump(std::shared_ptr<State> state) {
+	thread_local std::vector<char> buffer(PUMP_CHUNK);
+	const int in = state->in;
+
+	// A link moved to the blocking pool keeps the worker until it is done
+	for (int round = 0; round < PUMP_ROUNDS; round += state->blocking ? 0 : 1) {
+		// Output first: nothing is read while the target is full
+		if (!state->closed && state->target) {
+			const int out = state->out;
+			const size_t already = state->written;
+			const uint64_t start = state->pending.size() > already && Tracer::On() ? Tracer::Now() : 0;
+			while (state->written < state->pending.size()) {
+				const ssize_t bytes = ::write(out, state->pending.data() + state->written, state->pending.size() - state->written);
+				if (bytes > 0) {
+					state->written += static_cast<size_t>(bytes);
+				} else if (bytes < 0 && errno == EINTR) {
+					continue;
+				} else if (bytes < 0 && errno == EAGAIN) {
+					if (!Rearm(state, out, EPOLLOUT))
+						continue;
+					if (start && state->written > already)
+						Tracer::Complete("write", start, state->id, state->written - already);
+					return;
+				} else {
+					Break(*state);
+					break;
+				}
+			}
+			if (start && state->written > already)
+				Tracer::Complete("write", start, state->id, state->written - already);
+		}
+		state->pending.clear();
+		state->written = 0;
+
+		if (state->finished) {
+			state->reactor->Forget(in);
+			::close(in);
+			state->in = -1;
+			if (!state->closed && state->target)
+				CloseTarget(*state);
+			if (state->started)
+				Tracer::Complete("forward", state->started, state->id);
+			state->done.set_value();
+			Reaper::Wake();
+			return;
+		}
+		if (state->eof) {
+			if (!state->closed)
+				Finish(*state);
+			state->finished = true;
+			continue;
+		}
+
+		const uint64_t start = Tracer::On() ? Tracer::Now() : 0;
+		const ssize_t bytes = ::read(in, buffer.data(), buffer.size());
+		if (start && bytes >= 0)
+			TraceRead(*state, start, static_cast<size_t>(bytes));
+		if (bytes > 0) {
+			if (!state->closed)
+				state->sinks.back().Write(std::string_view(buffer.data(), static_cast<size_t>(bytes)));
+		} else if (bytes < 0 && errno == EINTR) {
+			continue;
+		} else if (bytes < 0 && errno == EAGAIN) {
+			if (Rearm(state, in, EPOLLIN))
+				return;
+		} else {
+			state->eof = true;
+		}
+	}
+	// Busy link: let other tasks run
+	state->executor->Post([state] { Pump(state); });
+}
+
+bool Forwarder::Rearm(const std::shared_ptr<State>& state, int fd, uint32_t events) {
+	if (state->blocking) {
+		pollfd ready { fd, static_cast<short>(events == EPOLLIN ? POLLIN : POLLOUT), 0 };
+		while (::poll(&ready, 1, -1) < 0 && errno == EINTR);
+		return false;
+	}
+	if (state->reactor->Watch(fd, events, [state] {
+		state->executor->Post([state] { Pump(state); });
+	}))
+		return true;
+	// Not watchable (epoll_ctl failure): the link goes on blocking, nothing is lost
+	state->blocking = true;
+	state->executor->PostLongRunning([state] { Pump(state); });
+	return true;
+}
+
+void Forwarder::Break(State& state) {
+	state.closed = true;
+	state.sinks[0].m_closed = true;
+	CloseTarget(state);
+	if (state.broken)
+		state.broken();
+}
+
+void Forwarder::CloseTarget(State& state) {
+	// The consumer sees EOF once both descriptions are gone
+	state.reactor->Forget(state.out);
+	::close(state.out);
+	state.out = -1;
+	state.target->CloseWrite();
+}
+#endif
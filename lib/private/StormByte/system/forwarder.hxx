@@ -0,0 +1,180 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/filter.hxx>
+#include <StormByte/system/visibility.h>
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	class Executor;	///< Forward declaration
+	class Pipe;		///< Forward declaration
+	#ifdef LINUX
+	class Reactor;	///< Forward declaration
+	#endif
+
+	/**
+	 * @class Forwarder
+	 * @brief Moves data from one pipe to another through optional filters.
+	 *
+	 * On Linux both pipe ends are reopened as private nonblocking descriptions
+	 * (the Pipe descriptors stay blocking for their other users) and the copy
+	 * is driven by the shared @ref Reactor: an idle link holds no thread, and
+	 * each readiness event runs a short pump on the executor workers. Elsewhere,
+	 * or if reopening fails, a blocking loop runs on the executor blocking pool.
+	 */
+	class STORMBYTE_SYSTEM_PRIVATE Forwarder {
+		public:
+			/**
+			 * Starts forwarding until @p source reaches EOF; @p target is closed at the end.
+			 * @param source Pipe whose read end is consumed.
+			 * @param target Pipe whose write end is fed.
+			 * @param filters Stages applied in order (may be empty).
+			 * @param broken Called once if @p target stops accepting data; the rest of
+			 * @p source is then discarded.
+			 * @param executor Executor running the work; must outlive the returned future.
+			 * @param id Process id the link is traced under (see @ref Tracer).
+			 * @return Future ready once @p source reached EOF.
+			 */
+			static std::future<void> Start(Pipe& source, Pipe& target, std::vector<Filter> filters,
+				std::function<void()> broken, Executor& executor, int64_t id);
+
+			/**
+			 * Consumes @p source until EOF, handing every chunk to @p consumer
+			 * (whatever it writes to its sink is dropped).
+			 * @param source Pipe whose read end is consumed.
+			 * @param consumer Stage receiving the data.
+			 * @param executor Executor running the work; must outlive the returned future.
+			 * @param id Process id the link is traced under (see @ref Tracer).
+			 * @return Future ready once @p source reached EOF.
+			 */
+			static std::future<void> Drain(Pipe& source, Filter consumer, Executor& executor, int64_t id);
+
+		private:
+			/**
+			 * @struct State
+			 * @brief One forwarding link.
+			 */
+			struct State {
+				Pipe* source;							///< Source pipe
+				Pipe* target;							///< Target pipe (nullptr when draining)
+				std::vector<Filter> filters;			///< Stages
+				std::vector<Sink> sinks;				///< sinks[0] is the output, sinks.back() the input
+				std::string pending;					///< Output not yet written
+				std::function<void()> broken;			///< Target gone callback
+				Executor* executor;						///< Executor (owned by the producer process)
+				std::promise<void> done;				///< Completion
+				int64_t id = 0;							///< Traced process id
+				uint64_t started = 0;					///< Trace start (0 if not traced)
+				bool received = false;					///< First byte read
+				#ifdef LINUX
+				Reactor* reactor = nullptr;				///< Readiness source
+				int in = -1;							///< Private nonblocking source description
+				int out = -1;							///< Private nonblocking target description (-1 when draining)
+				size_t written = 0;						///< Bytes of pending already written
+				bool eof = false;						///< Source reached EOF
+				bool finished = false;					///< Finish hooks ran
+				bool closed = false;					///< Target gone
+				bool blocking = false;					///< Pumped on the blocking pool (no readiness watch)
+				#endif
+			};
+
+			/**
+			 * Starts a link.
+			 * @param source Source pipe.
+			 * @param target Target pipe, or nullptr to drop the output.
+			 * @param filters Stages.
+			 * @param broken Target gone callback.
+			 * @param executor Executor.
+			 * @param id Traced process id.
+			 * @return Completion.
+			 */
+			static std::future<void> Launch(Pipe& source, Pipe* target, std::vector<Filter> filters,
+				std::function<void()> broken, Executor& executor, int64_t id);
+
+			/**
+			 * Builds the sink chain for @p state.
+			 * @param state State.
+			 * @param output Final sink.
+			 */
+			static void Chain(State& state, Sink output);
+
+			/**
+			 * Runs every finish hook in order.
+			 * @param state State.
+			 */
+			static void Finish(State& state);
+
+			/**
+			 * Traces a read of @p bytes that began at @p start.
+			 * @param state State.
+			 * @param start Value of Tracer::Now() before the read.
+			 * @param bytes Bytes read (0 is EOF).
+			 */
+			static void TraceRead(State& state, uint64_t start, size_t bytes) noexcept;
+
+			/**
+			 * Blocking forwarding loop.
+			 * @param state State.
+			 */
+			static void Run(State& state);
+
+			#ifdef LINUX
+			/**
+			 * Nonblocking step: writes pending output, then reads, until it would block.
+			 * @param state State.
+			 */
+			static void Pump(std::shared_ptr<State> state);
+
+			/**
+			 * Waits for @p fd readiness, then pumps again. If the reactor can not
+			 * watch it, the link moves to the blocking pool and from then on waits
+			 * in place with poll().
+			 * @param state State.
+			 * @param fd Descriptor.
+			 * @param events EPOLLIN or EPOLLOUT.
+			 * @return true if Pump() runs again later, false if @p fd is ready now.
+			 */
+			static bool Rearm(const std::shared_ptr<State>& state, int fd, uint32_t events);
+
+			/**
+			 * Closes the target after a write failure and notifies.
+			 * @param state State.
+			 */
+			static void Break(State& state);
+
+			/**
+			 * Closes the private target description and the target write end.
+			 * @param state State.
+			 */
+			static void CloseTarget(State& state);
+			#endif
+	};
+}
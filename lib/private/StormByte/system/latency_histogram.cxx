@@ -0,0 +1,55 @@
+#include <StormByte/system/latency_histogram.hxx>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+using namespace StormByte::System;
+
+LatencyHistogram::LatencyHistogram() noexcept: m_count(0) {
+	for (auto& bucket: m_buckets)
+		bucket.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds latency) noexcept {
+	const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+	m_buckets[Index(micros > 0 ? static_cast<uint64_t>(micros) : 0)].fetch_add(1, std::memory_order_relaxed);
+	m_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::Count() const noexcept {
+	return m_count.load(std::memory_order_relaxed);
+}
+
+std::optional<std::chrono::nanoseconds> LatencyHistogram::Percentile(double fraction) const noexcept {
+	const uint64_t count = Count();
+	if (count == 0)
+		return std::nullopt;
+	// Nearest rank; concurrent records only make the walk stop a bucket later
+	const uint64_t rank = std::clamp<uint64_t>(static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count))), 1, count);
+	uint64_t seen = 0;
+	for (size_t i = 0; i < BUCKETS; i++) {
+		seen += m_buckets[i].load(std::memory_order_relaxed);
+		if (seen >= rank)
+			return std::chrono::microseconds(UpperBound(i));
+	}
+	return std::chrono::microseconds(UpperBound(BUCKETS - 1));
+}
+
+size_t LatencyHistogram::Index(uint64_t micros) noexcept {
+	// Values below SUB_BUCKETS get a bucket each; above, 8 per power of two
+	if (micros < SUB_BUCKETS)
+		return static_cast<size_t>(micros);
+	const unsigned exponent = std::min<unsigned>(static_cast<unsigned>(std::bit_width(micros)) - 1, MAX_BITS);
+	const uint64_t sub = exponent == MAX_BITS && micros >> MAX_BITS > 1 ? SUB_BUCKETS - 1 : (micros >> (exponent - SUB_BITS)) & (SUB_BUCKETS - 1);
+	return SUB_BUCKETS * (exponent - SUB_BITS + 1) + static_cast<size_t>(sub);
+}
+
+uint64_t LatencyHistogram::UpperBound(size_t index) noexcept {
+	if (index < SUB_BUCKETS)
+		return index;
+	const unsigned exponent = static_cast<unsigned>(index / SUB_BUCKETS) + SUB_BITS - 1;
+	const uint64_t sub = index % SUB_BUCKETS;
+	const uint64_t width = uint64_t(1) << (exponent - SUB_BITS);
+	return ((SUB_BUCKETS + sub) << (exponent - SUB_BITS)) + width - 1;
+}
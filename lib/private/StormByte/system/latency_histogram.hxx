@@ -0,0 +1,123 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	/**
+	 * @class LatencyHistogram
+	 * @brief Lock-free log-linear histogram of durations.
+	 *
+	 * Microsecond resolution; each power of two is split into 8 buckets, so a
+	 * percentile is within 12.5% of the true value. Covers about 12 days.
+	 * Recording is a single relaxed atomic increment.
+	 */
+	class STORMBYTE_SYSTEM_PRIVATE LatencyHistogram {
+		public:
+			/**
+			 * Empty histogram.
+			 */
+			LatencyHistogram() noexcept;
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			LatencyHistogram(const LatencyHistogram&) = delete;
+
+			/**
+			 * Move constructor (deleted).
+			 */
+			LatencyHistogram(LatencyHistogram&&) = delete;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+			/**
+			 * Move assignment (deleted).
+			 */
+			LatencyHistogram& operator=(LatencyHistogram&&) = delete;
+
+			/**
+			 * Destructor.
+			 */
+			~LatencyHistogram() noexcept = default;
+
+			/**
+			 * Adds one sample.
+			 * @param latency Duration (clamped to the covered range).
+			 */
+			void Record(std::chrono::nanoseconds latency) noexcept;
+
+			/**
+			 * @return Samples recorded.
+			 */
+			uint64_t Count() const noexcept;
+
+			/**
+			 * @param fraction Percentile in [0, 1].
+			 * @return Upper bound of the bucket holding that rank, or nothing if empty.
+			 */
+			std::optional<std::chrono::nanoseconds> Percentile(double fraction) const noexcept;
+
+		private:
+			static constexpr const unsigned SUB_BITS = 3;					///< log2 of buckets per power of two
+			static constexpr const unsigned SUB_BUCKETS = 1u << SUB_BITS;	///< Buckets per power of two
+			static constexpr const unsigned MAX_BITS = 40;					///< Largest value: 2^40 us
+			static constexpr const size_t BUCKETS = SUB_BUCKETS * (MAX_BITS - SUB_BITS + 2);	///< Bucket count (linear ones first)
+
+			std::array<std::atomic<uint64_t>, BUCKETS> m_buckets;	///< Counts
+			std::atomic<uint64_t> m_count;							///< Total
+
+			/**
+			 * @param micros Value.
+			 * @return Its bucket.
+			 */
+			static size_t Index(uint64_t micros) noexcept;
+
+			/**
+			 * @param index Bucket.
+			 * @return Largest value it holds, in microseconds.
+			 */
+			static uint64_t UpperBound(size_t index) noexcept;
+	};
+
+	/**
+	 * @struct LatencyProfile
+	 * @brief Run latencies of a @ref Command, shared by its copies.
+	 */
+	struct STORMBYTE_SYSTEM_PRIVATE LatencyProfile {
+		LatencyHistogram first_byte;	///< Spawn to first output byte
+		LatencyHistogram exit;			///< Spawn to end of output
+	};
+}
@@ -0,0 +1,74 @@
+#include <StormByte/system/mapped_file.hxx>
+
+#ifdef UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <sstream>
+#endif
+
+using namespace StormByte::System;
+
+#ifdef UNIX
+MappedFile::MappedFile() noexcept: m_data(nullptr), m_size(0) {}
+
+MappedFile::~MappedFile() noexcept {
+	if (m_data)
+		munmap(m_data, m_size);
+}
+
+std::shared_ptr<const MappedFile> MappedFile::Open(const std::filesystem::path& file) noexcept {
+	const int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return nullptr;
+	// The mapping keeps the pages alive on its own
+	std::shared_ptr<const MappedFile> mapped = Map(fd);
+	close(fd);
+	return mapped;
+}
+
+std::shared_ptr<const MappedFile> MappedFile::Map(int fd) noexcept {
+	std::shared_ptr<MappedFile> mapped(new (std::nothrow) MappedFile());
+	struct stat st;
+	if (!mapped || fstat(fd, &st) != 0)
+		return nullptr;
+	if (st.st_size > 0) {
+		void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED)
+			return nullptr;
+		mapped->m_data = data;
+		mapped->m_size = static_cast<size_t>(st.st_size);
+	}
+	return mapped;
+}
+
+std::string_view MappedFile::View() const noexcept {
+	return std::string_view(static_cast<const char*>(m_data), m_size);
+}
+#else
+MappedFile::MappedFile() noexcept {}
+
+MappedFile::~MappedFile() noexcept {}
+
+std::shared_ptr<const MappedFile> MappedFile::Open(const std::filesystem::path& file) noexcept {
+	try {
+		std::ifstream in(file, std::ios::binary);
+		if (!in)
+			return nullptr;
+		std::shared_ptr<MappedFile> mapped(new MappedFile());
+		std::stringstream ss;
+		ss << in.rdbuf();
+		mapped->m_data = ss.str();
+		return mapped;
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+std::string_view MappedFile::View() const noexcept {
+	return m_data;
+}
+#endif
@@ -0,0 +1,101 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	/**
+	 * @class MappedFile
+	 * @brief Read-only view of a whole file.
+	 *
+	 * Memory-mapped on UNIX, so the pages come straight from the page cache
+	 * and stay valid after the file is unlinked or replaced; read into
+	 * memory elsewhere.
+	 */
+	class STORMBYTE_SYSTEM_PRIVATE MappedFile {
+		public:
+			/**
+			 * @param file File.
+			 * @return Mapping, or nullptr if @p file can not be opened or mapped.
+			 */
+			static std::shared_ptr<const MappedFile> Open(const std::filesystem::path& file) noexcept;
+
+			#ifdef UNIX
+			/**
+			 * @param fd Open descriptor (left open).
+			 * @return Mapping of the whole file, or nullptr if it can not be mapped.
+			 */
+			static std::shared_ptr<const MappedFile> Map(int fd) noexcept;
+			#endif
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			MappedFile(const MappedFile&) = delete;
+
+			/**
+			 * Move constructor (deleted).
+			 */
+			MappedFile(MappedFile&&) = delete;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			MappedFile& operator=(const MappedFile&) = delete;
+
+			/**
+			 * Move assignment (deleted).
+			 */
+			MappedFile& operator=(MappedFile&&) = delete;
+
+			/**
+			 * Unmaps the file.
+			 */
+			~MappedFile() noexcept;
+
+			/**
+			 * @return File contents.
+			 */
+			std::string_view View() const noexcept;
+
+		private:
+			#ifdef UNIX
+			void* m_data;				///< Mapping (nullptr for an empty file)
+			size_t m_size;				///< Mapping size
+			#else
+			std::string m_data;			///< Contents
+			#endif
+
+			/**
+			 * Empty view.
+			 */
+			MappedFile() noexcept;
+	};
+}
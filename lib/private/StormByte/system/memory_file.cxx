@@ -0,0 +1,65 @@
+#include <StormByte/system/exception.hxx>
+#include <StormByte/system/mapped_file.hxx>
+#include <StormByte/system/memory_file.hxx>
+
+#ifdef UNIX
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <string>
+#include <unistd.h>
+#ifdef LINUX
+#include <sys/mman.h>
+#endif
+
+using namespace StormByte::System;
+
+namespace {
+	std::string TemporaryDirectory() {
+		std::error_code ec;
+		const std::filesystem::path dir = std::filesystem::temp_directory_path(ec);
+		return ec ? std::string("/tmp") : dir.string();
+	}
+
+	int CreateAnonymous() {
+	#ifdef LINUX
+		int fd = memfd_create("stormbyte-output", MFD_CLOEXEC);
+		if (fd >= 0)
+			return fd;
+		// No memfd (old kernel or seccomp): a nameless file in the temporary directory
+		fd = open(TemporaryDirectory().c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+		if (fd >= 0)
+			return fd;
+	#endif
+		std::string name = TemporaryDirectory() + "/stormbyte-output-XXXXXX";
+		// Close-on-exec from creation: a child forked meanwhile never inherits it
+		const int named = mkostemp(name.data(), O_CLOEXEC);
+		if (named < 0)
+			return -1;
+		unlink(name.c_str());
+		return named;
+	}
+}
+
+MemoryFile::MemoryFile(): m_fd(CreateAnonymous()) {
+	if (m_fd < 0)
+		throw Exception("Can not create output file: " + std::string(std::strerror(errno)));
+}
+
+MemoryFile::~MemoryFile() noexcept {
+	if (m_fd >= 0)
+		close(m_fd);
+}
+
+void MemoryFile::Bind(int dest) const noexcept {
+	// dup2 clears close-on-exec on the copy
+	dup2(m_fd, dest);
+}
+
+std::shared_ptr<const MappedFile> MemoryFile::Map() const {
+	if (!m_mapped)
+		m_mapped = MappedFile::Map(m_fd);
+	return m_mapped;
+}
+#endif
@@ -0,0 +1,95 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#ifdef UNIX
+#include <memory>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	class MappedFile;	///< Forward declaration
+
+	/**
+	 * @class MemoryFile
+	 * @brief Anonymous file a child writes its output to instead of a pipe.
+	 *
+	 * A `memfd` on Linux, falling back to an `O_TMPFILE` file and then to an
+	 * unlinked `mkstemp()` file in the temporary directory; it has no name in
+	 * any case, so it disappears with its last descriptor or mapping. The
+	 * descriptor is close-on-exec: the child only gets the copy bound to its
+	 * standard stream.
+	 */
+	class STORMBYTE_SYSTEM_PRIVATE MemoryFile {
+		public:
+			/**
+			 * Creates the file.
+			 * @throw Exception if no anonymous file can be created.
+			 */
+			MemoryFile();
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			MemoryFile(const MemoryFile&) = delete;
+
+			/**
+			 * Move constructor (deleted).
+			 */
+			MemoryFile(MemoryFile&&) = delete;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			MemoryFile& operator=(const MemoryFile&) = delete;
+
+			/**
+			 * Move assignment (deleted).
+			 */
+			MemoryFile& operator=(MemoryFile&&) = delete;
+
+			/**
+			 * Closes the descriptor (an existing mapping stays valid).
+			 */
+			~MemoryFile() noexcept;
+
+			/**
+			 * Child side (after fork): makes the file descriptor @p dest.
+			 * @param dest Descriptor to replace.
+			 * @note Async-signal-safe.
+			 */
+			void Bind(int dest) const noexcept;
+
+			/**
+			 * Maps what was written so far; later calls return the same mapping.
+			 * @return Mapping (nullptr if it can not be mapped).
+			 */
+			std::shared_ptr<const MappedFile> Map() const;
+
+		private:
+			int m_fd;											///< Descriptor
+			mutable std::shared_ptr<const MappedFile> m_mapped;	///< First mapping
+	};
+}
+#endif
@@ -0,0 +1,98 @@
+#include <StormByte/system/murmur_hash.hxx>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace StormByte::System;
+
+namespace {
+	constexpr const uint64_t C1 = 0x87c37b91114253d5ULL;
+	constexpr const uint64_t C2 = 0x4cf5ad432745937fULL;
+
+	constexpr uint64_t Rotl(uint64_t x, int r) noexcept {
+		return (x << r) | (x >> (64 - r));
+	}
+
+	constexpr uint64_t Mix(uint64_t k) noexcept {
+		k ^= k >> 33;
+		k *= 0xff51afd7ed558ccdULL;
+		k ^= k >> 33;
+		k *= 0xc4ceb9fe1a85ec53ULL;
+		k ^= k >> 33;
+		return k;
+	}
+
+	// Little-endian load, as the reference implementation on x86-64
+	uint64_t Load(const unsigned char* data, size_t size) noexcept {
+		uint64_t value = 0;
+		for (size_t i = 0; i < size; i++)
+			value |= static_cast<uint64_t>(data[i]) << (8 * i);
+		return value;
+	}
+}
+
+MurmurHash::MurmurHash(uint32_t seed) noexcept:
+	m_h1(seed), m_h2(seed), m_length(0), m_tail {}, m_tail_size(0) {}
+
+void MurmurHash::Update(std::string_view data) noexcept {
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data.data());
+	size_t size = data.size();
+	m_length += size;
+
+	if (m_tail_size > 0) {
+		const size_t take = std::min(size, BLOCK - m_tail_size);
+		std::memcpy(m_tail.data() + m_tail_size, bytes, take);
+		m_tail_size += take;
+		bytes += take;
+		size -= take;
+		if (m_tail_size < BLOCK)
+			return;
+		Block(m_tail.data());
+		m_tail_size = 0;
+	}
+	for (; size >= BLOCK; bytes += BLOCK, size -= BLOCK)
+		Block(bytes);
+	std::memcpy(m_tail.data(), bytes, size);
+	m_tail_size = size;
+}
+
+void MurmurHash::Field(std::string_view data) noexcept {
+	unsigned char size[8];
+	for (size_t i = 0; i < sizeof(size); i++)
+		size[i] = static_cast<unsigned char>(static_cast<uint64_t>(data.size()) >> (8 * i));
+	Update(std::string_view(reinterpret_cast<const char*>(size), sizeof(size)));
+	Update(data);
+}
+
+MurmurHash::Digest MurmurHash::Finish() const noexcept {
+	uint64_t h1 = m_h1, h2 = m_h2;
+	if (m_tail_size > 0) {
+		uint64_t k1 = Load(m_tail.data(), std::min<size_t>(m_tail_size, 8));
+		uint64_t k2 = m_tail_size > 8 ? Load(m_tail.data() + 8, m_tail_size - 8) : 0;
+		if (m_tail_size > 8) {
+			k2 *= C2; k2 = Rotl(k2, 33); k2 *= C1; h2 ^= k2;
+		}
+		k1 *= C1; k1 = Rotl(k1, 31); k1 *= C2; h1 ^= k1;
+	}
+
+	h1 ^= m_length;
+	h2 ^= m_length;
+	h1 += h2;
+	h2 += h1;
+	h1 = Mix(h1);
+	h2 = Mix(h2);
+	h1 += h2;
+	h2 += h1;
+	return { h1, h2 };
+}
+
+void MurmurHash::Block(const unsigned char* block) noexcept {
+	uint64_t k1 = Load(block, 8);
+	uint64_t k2 = Load(block + 8, 8);
+
+	k1 *= C1; k1 = Rotl(k1, 31); k1 *= C2; m_h1 ^= k1;
+	m_h1 = Rotl(m_h1, 27); m_h1 += m_h2; m_h1 = m_h1 * 5 + 0x52dce729;
+
+	k2 *= C2; k2 = Rotl(k2, 33); k2 *= C1; m_h2 ^= k2;
+	m_h2 = Rotl(m_h2, 31); m_h2 += m_h1; m_h2 = m_h2 * 5 + 0x38495ab5;
+}
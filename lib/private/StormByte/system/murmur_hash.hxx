@@ -0,0 +1,82 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	/**
+	 * @class MurmurHash
+	 * @brief Incremental MurmurHash3 x64_128 (non-cryptographic).
+	 *
+	 * Data may be fed in pieces of any size; the digest equals the one-shot
+	 * MurmurHash3_x64_128 of the concatenation.
+	 */
+	class STORMBYTE_SYSTEM_PRIVATE MurmurHash {
+		public:
+			using Digest = std::array<uint64_t, 2>;	///< h1, h2
+
+			/**
+			 * @param seed Seed.
+			 */
+			explicit MurmurHash(uint32_t seed = 0) noexcept;
+
+			/**
+			 * Feeds @p data.
+			 * @param data Bytes.
+			 */
+			void Update(std::string_view data) noexcept;
+
+			/**
+			 * Feeds the size of @p data, then @p data, so adjacent fields can not collide.
+			 * @param data Field.
+			 */
+			void Field(std::string_view data) noexcept;
+
+			/**
+			 * @return Digest of everything fed so far (the state is left unchanged).
+			 */
+			Digest Finish() const noexcept;
+
+		private:
+			static constexpr const size_t BLOCK = 16;		///< Block size
+
+			uint64_t m_h1;									///< State
+			uint64_t m_h2;									///< State
+			uint64_t m_length;								///< Bytes fed
+			std::array<unsigned char, BLOCK> m_tail;		///< Partial block
+			size_t m_tail_size;								///< Bytes in m_tail
+
+			/**
+			 * Mixes one full block.
+			 * @param block 16 bytes.
+			 */
+			void Block(const unsigned char* block) noexcept;
+	};
+}
@@ -70,6 +70,14 @@ bool Pipe::ReadEOF() const {
 
 	return ((poll_data.revents & POLLHUP) == POLLHUP) || ((poll_data.revents & POLLERR) == POLLERR);
 }
+
+int Pipe::ReadHandle() const noexcept {
+	return m_fd[0];
+}
+
+int Pipe::WriteHandle() const noexcept {
+	return m_fd[1];
+}
 #else
 void Pipe::ReadHandleInformation(DWORD mask, DWORD flags) {
 	HandleInformation(m_fd[0], mask, flags);
@@ -102,43 +110,37 @@ DWORD Pipe::Read(std::vector<CHAR>& buffer, DWORD size) const {
 
 #ifdef UNIX
 bool Pipe::WriteAtomic(std::string&& data) {
-	if (data.empty())
-		return true;
+	return WriteAtomic(std::string_view(data));
+}
 
-	std::string out = std::move(data);
+bool Pipe::WriteAtomic(std::string_view data) {
 	bool can_continue = true;
 
-	do {
-		const size_t chunk_size = (out.length() > static_cast<size_t>(PIPE_BUF)) ? static_cast<size_t>(PIPE_BUF) : out.length();
-		const ssize_t bytes_written = ::write(m_fd[1], out.c_str(), chunk_size);
-		if (bytes_written < 0 || static_cast<size_t>(bytes_written) != chunk_size) {
-			can_continue = false;
+	while (!data.empty() && can_continue) {
+		const size_t chunk_size = (data.length() > static_cast<size_t>(PIPE_BUF)) ? static_cast<size_t>(PIPE_BUF) : data.length();
+		const ssize_t bytes_written = ::write(m_fd[1], data.data(), chunk_size);
+		if (bytes_written < 0 || static_cast<size_t>(bytes_written) != chunk_size)
 			break;
-		}
-		out.erase(0, chunk_size);
+		data.remove_prefix(chunk_size);
 		can_continue = !WriteEOF();
-	} while (!out.empty() && can_continue);
-	return out.empty();
+	}
+	return data.empty();
 }
 #else
 bool Pipe::WriteAtomic(std::string&& data) {
-	if (data.empty())
-		return true;
-
-	std::string out = std::move(data);
-	bool can_continue = true;
+	return WriteAtomic(std::string_view(data));
+}
 
-	do {
-		const size_t chunk_size = (out.length() > 4096) ? 4096 : out.length();
+bool Pipe::WriteAtomic(std::string_view data) {
+	while (!data.empty()) {
+		const size_t chunk_size = (data.length() > 4096) ? 4096 : data.length();
 		DWORD dwWritten = 0;
-		if (!WriteFile(m_fd[1], out.c_str(), static_cast<DWORD>(chunk_size), &dwWritten, NULL) ||
-			dwWritten != static_cast<DWORD>(chunk_size)) {
-			can_continue = false;
+		if (!WriteFile(m_fd[1], data.data(), static_cast<DWORD>(chunk_size), &dwWritten, NULL) ||
+			dwWritten != static_cast<DWORD>(chunk_size))
 			break;
-		}
-		out.erase(0, chunk_size);
-	} while (!out.empty() && can_continue);
-	return out.empty();
+		data.remove_prefix(chunk_size);
+	}
+	return data.empty();
 }
 #endif
 
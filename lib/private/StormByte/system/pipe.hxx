@@ -22,6 +22,7 @@
 #include <StormByte/system/visibility.h>
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 #ifdef WINDOWS
@@ -116,6 +117,16 @@ namespace StormByte::System {
 			 * @return true if the read end reports HUP/ERR.
 			 */
 			bool ReadEOF() const;
+
+			/**
+			 * @return Read fd (-1 if closed).
+			 */
+			int ReadHandle() const noexcept;
+
+			/**
+			 * @return Write fd (-1 if closed).
+			 */
+			int WriteHandle() const noexcept;
 			#else
 			/**
 			 * Sets handle information on the read end.
@@ -164,6 +175,13 @@ namespace StormByte::System {
 			 */
 			bool WriteAtomic(std::string&& str);
 
+			/**
+			 * Writes @p data in chunks until complete or peer closes (no copy).
+			 * @param data Data. Empty view succeeds immediately.
+			 * @return true if all data was written.
+			 */
+			bool WriteAtomic(std::string_view data);
+
 			/**
 			 * Closes the read end.
 			 */
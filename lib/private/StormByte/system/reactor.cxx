@@ -0,0 +1,108 @@
+#include <StormByte/system/reactor.hxx>
+
+#ifdef LINUX
+#include <cerrno>
+#include <memory>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+using namespace StormByte::System;
+
+namespace {
+	constexpr const int MAX_EVENTS = 64;
+}
+
+Reactor* Reactor::Instance() noexcept {
+	static std::unique_ptr<Reactor> instance = [] {
+		std::unique_ptr<Reactor> reactor(new Reactor());
+		if (reactor->m_epoll < 0)
+			reactor.reset();
+		return reactor;
+	}();
+	return instance.get();
+}
+
+Reactor::Reactor() noexcept: m_epoll(-1), m_wakeup(-1), m_stop(false) {
+	const int epoll = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll < 0)
+		return;
+	const int wakeup = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	epoll_event event {};
+	event.events = EPOLLIN;
+	event.data.fd = wakeup;
+	if (wakeup < 0 || epoll_ctl(epoll, EPOLL_CTL_ADD, wakeup, &event) < 0) {
+		if (wakeup >= 0)
+			close(wakeup);
+		close(epoll);
+		return;
+	}
+	m_epoll = epoll;
+	m_wakeup = wakeup;
+	m_thread = std::thread(&Reactor::Loop, this);
+}
+
+Reactor::~Reactor() noexcept {
+	if (m_thread.joinable()) {
+		m_stop.store(true);
+		const uint64_t one = 1;
+		(void)!write(m_wakeup, &one, sizeof(one));
+		m_thread.join();
+	}
+	if (m_wakeup >= 0)
+		close(m_wakeup);
+	if (m_epoll >= 0)
+		close(m_epoll);
+}
+
+bool Reactor::Watch(int fd, uint32_t events, std::function<void()> ready) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto [it, added] = m_watches.try_emplace(fd);
+	it->second = std::move(ready);
+
+	epoll_event event {};
+	event.events = events | EPOLLONESHOT;
+	event.data.fd = fd;
+	// Registered once, re-armed with MOD afterwards
+	if (epoll_ctl(m_epoll, added ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event) < 0) {
+		m_watches.erase(it);
+		return false;
+	}
+	return true;
+}
+
+void Reactor::Forget(int fd) noexcept {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_watches.erase(fd) > 0)
+		epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+void Reactor::Loop() {
+	epoll_event events[MAX_EVENTS];
+	while (!m_stop.load()) {
+		const int count = epoll_wait(m_epoll, events, MAX_EVENTS, -1);
+		if (count < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		for (int i = 0; i < count; i++) {
+			const int fd = events[i].data.fd;
+			if (fd == m_wakeup)
+				continue;
+			std::function<void()> ready;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				auto it = m_watches.find(fd);
+				if (it == m_watches.end())
+					continue;
+				// One-shot: the fd stays registered but disarmed until the next Watch
+				ready = std::move(it->second);
+				it->second = nullptr;
+			}
+			if (ready)
+				ready();
+		}
+	}
+}
+#endif
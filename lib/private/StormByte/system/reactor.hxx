@@ -0,0 +1,110 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#ifdef LINUX
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	/**
+	 * @class Reactor
+	 * @brief Process-wide epoll thread delivering one-shot readiness callbacks.
+	 *
+	 * Callbacks run on the reactor thread and must only hand work off (post
+	 * to an executor); they never block.
+	 */
+	class STORMBYTE_SYSTEM_PRIVATE Reactor {
+		public:
+			/**
+			 * @return Shared instance, or nullptr if epoll is unavailable.
+			 */
+			static Reactor* Instance() noexcept;
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			Reactor(const Reactor&) = delete;
+
+			/**
+			 * Move constructor (deleted).
+			 */
+			Reactor(Reactor&&) = delete;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			Reactor& operator=(const Reactor&) = delete;
+
+			/**
+			 * Move assignment (deleted).
+			 */
+			Reactor& operator=(Reactor&&) = delete;
+
+			/**
+			 * Stops the reactor thread.
+			 */
+			~Reactor() noexcept;
+
+			/**
+			 * Arms a one-shot watch on @p fd.
+			 * @param fd Nonblocking descriptor.
+			 * @param events EPOLLIN or EPOLLOUT.
+			 * @param ready Called once when @p fd is ready (or hung up / in error).
+			 * @return false if @p fd could not be watched.
+			 */
+			bool Watch(int fd, uint32_t events, std::function<void()> ready);
+
+			/**
+			 * Removes @p fd; call before closing it. No-op if not watched.
+			 * @param fd Descriptor.
+			 */
+			void Forget(int fd) noexcept;
+
+		private:
+			int m_epoll;											///< epoll descriptor
+			int m_wakeup;											///< eventfd used to stop the thread
+			std::atomic<bool> m_stop;								///< Stop flag
+			std::mutex m_mutex;										///< Protects m_watches
+			std::unordered_map<int, std::function<void()>> m_watches;	///< Registered fds and pending callbacks
+			std::thread m_thread;									///< Reactor thread
+
+			/**
+			 * Creates the epoll instance; check @ref m_epoll afterwards.
+			 */
+			Reactor() noexcept;
+
+			/**
+			 * Event loop.
+			 */
+			void Loop();
+	};
+}
+#endif
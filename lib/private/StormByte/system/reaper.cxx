@@ -0,0 +1,176 @@
+#include <StormByte/system/executor.hxx>
+#include <StormByte/system/reaper.hxx>
+#include <StormByte/system/tracer.hxx>
+#ifdef LINUX
+#include <StormByte/system/reactor.hxx>
+#endif
+
+#ifdef UNIX
+#include <cerrno>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#ifdef LINUX
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+
+using namespace StormByte::System;
+
+std::atomic<uint64_t> Reaper::s_events { 0 };
+
+Reaper& Reaper::Instance() {
+	static Reaper instance;
+	return instance;
+}
+
+Reaper::Reaper(): m_stop(false) {
+	for (auto& slot: m_exits)
+		slot.store(0, std::memory_order_relaxed);
+	m_thread = std::thread(&Reaper::Loop, this);
+}
+
+Reaper::~Reaper() noexcept {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	Wake();
+	if (m_thread.joinable())
+		m_thread.join();
+}
+
+void Reaper::Adopt(Target target, std::function<void()> prepare, std::vector<std::future<void>> pending,
+	std::function<void(Code)> done, std::shared_ptr<void> keep) {
+	std::shared_ptr<Adoption> adoption = std::make_shared<Adoption>();
+	adoption->target = target;
+	adoption->prepare = std::move(prepare);
+	adoption->completion.pending = std::move(pending);
+	adoption->completion.done = std::move(done);
+	adoption->completion.keep = std::move(keep);
+
+#if defined(LINUX) && defined(SYS_pidfd_open)
+	// No thread per child: the pidfd turns readable once the child exits
+	Reactor* reactor = Reactor::Instance();
+	const int pidfd = reactor ? static_cast<int>(syscall(SYS_pidfd_open, target, 0)) : -1;
+	if (pidfd >= 0) {
+		adoption->pidfd = pidfd;
+		if (reactor->Watch(pidfd, EPOLLIN, [this, reactor, adoption] {
+			reactor->Forget(adoption->pidfd);
+			close(adoption->pidfd);
+			adoption->pidfd = -1;
+			Reap(*adoption);
+		}))
+			return;
+		close(pidfd);
+		adoption->pidfd = -1;
+	}
+#endif
+
+	Executor::Default()->PostLongRunning([this, adoption] {
+#ifdef UNIX
+		siginfo_t info;
+		while (waitid(P_PID, static_cast<id_t>(adoption->target), &info, WEXITED | WNOWAIT) == -1 && errno == EINTR);
+#else
+		WaitForSingleObject(adoption->target, INFINITE);
+#endif
+		Reap(*adoption);
+	});
+}
+
+std::optional<Reaper::Code> Reaper::ExitCode(uint32_t id) const noexcept {
+	if (id == 0)
+		return std::nullopt;
+	for (size_t probe = 0; probe < EXIT_PROBES; probe++) {
+		const uint64_t entry = m_exits[(id + probe) & (EXIT_SLOTS - 1)].load(std::memory_order_acquire);
+		if (entry == 0)
+			break;
+		if (static_cast<uint32_t>(entry >> 32) == id)
+			return static_cast<Code>(static_cast<uint32_t>(entry));
+	}
+	return std::nullopt;
+}
+
+void Reaper::Reap(Adoption& adoption) {
+	if (adoption.prepare)
+		adoption.prepare();
+#ifdef UNIX
+	int status = 0;
+	pid_t reaped;
+	while ((reaped = waitpid(adoption.target, &status, 0)) == -1 && errno == EINTR);
+	const Code code = reaped == adoption.target && WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+	Record(static_cast<uint32_t>(adoption.target), code);
+	if (Tracer::On())
+		Tracer::Instant("reap", adoption.target);
+#else
+	Code code = static_cast<Code>(-1);
+	GetExitCodeProcess(adoption.target, &code);
+	Record(GetProcessId(adoption.target), code);
+	if (Tracer::On())
+		Tracer::Instant("reap", GetProcessId(adoption.target));
+#endif
+	adoption.completion.code = code;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_queue.push_back(std::move(adoption.completion));
+	}
+	Wake();
+}
+
+void Reaper::Wake() noexcept {
+	s_events.fetch_add(1, std::memory_order_release);
+	s_events.notify_all();
+}
+
+void Reaper::Record(uint32_t id, Code code) noexcept {
+	const uint64_t entry = (static_cast<uint64_t>(id) << 32) | static_cast<uint32_t>(code);
+	const size_t home = id & (EXIT_SLOTS - 1);
+	for (size_t probe = 0; probe < EXIT_PROBES; probe++) {
+		std::atomic<uint64_t>& slot = m_exits[(home + probe) & (EXIT_SLOTS - 1)];
+		uint64_t current = slot.load(std::memory_order_acquire);
+		if (static_cast<uint32_t>(current >> 32) == id) {
+			slot.store(entry, std::memory_order_release);
+			return;
+		}
+		if (current == 0 && slot.compare_exchange_strong(current, entry, std::memory_order_acq_rel))
+			return;
+	}
+	m_exits[home].store(entry, std::memory_order_release);
+}
+
+void Reaper::Loop() {
+	// Completions whose pending work is still running; only rechecked after a Wake()
+	std::vector<Completion> waiting;
+	while (true) {
+		// Loaded first: a Wake() during the scan makes the wait below return at once
+		const uint64_t seen = s_events.load(std::memory_order_acquire);
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_stop)
+				break;
+			std::move(m_queue.begin(), m_queue.end(), std::back_inserter(waiting));
+			m_queue.clear();
+		}
+
+		for (size_t i = 0; i < waiting.size();) {
+			const bool finished = std::all_of(waiting[i].pending.begin(), waiting[i].pending.end(), [](const std::future<void>& pending) {
+				return !pending.valid() || pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+			});
+			if (!finished) {
+				i++;
+				continue;
+			}
+			Completion completion = std::move(waiting[i]);
+			waiting.erase(waiting.begin() + static_cast<std::ptrdiff_t>(i));
+			if (completion.done)
+				completion.done(completion.code);
+			// Resources are released here, outside the lock
+		}
+		s_events.wait(seen, std::memory_order_acquire);
+	}
+}
@@ -0,0 +1,181 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#ifdef WINDOWS
+#include <windows.h>
+#else
+#include <sys/types.h>
+#endif
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	/**
+	 * @class Reaper
+	 * @brief Reaps detached children in the background.
+	 *
+	 * On Linux each child is watched through a pidfd on the shared @ref Reactor,
+	 * so no thread waits per child; elsewhere a blocking wait runs on the
+	 * default executor blocking pool. Exit codes are recorded in a fixed
+	 * lock-free table, and completions (which first wait for the child's
+	 * pending forwarding/capture) run on one finisher thread, woken by
+	 * @ref Wake() whenever such work finishes instead of polling it.
+	 */
+	class STORMBYTE_SYSTEM_PRIVATE Reaper {
+		public:
+			#ifdef UNIX
+			using Target = pid_t;		///< Child
+			using Code = int;			///< Exit code
+			#else
+			using Target = HANDLE;		///< Child
+			using Code = DWORD;			///< Exit code
+			#endif
+
+			/**
+			 * @return Shared instance.
+			 */
+			static Reaper& Instance();
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			Reaper(const Reaper&) = delete;
+
+			/**
+			 * Move constructor (deleted).
+			 */
+			Reaper(Reaper&&) = delete;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			Reaper& operator=(const Reaper&) = delete;
+
+			/**
+			 * Move assignment (deleted).
+			 */
+			Reaper& operator=(Reaper&&) = delete;
+
+			/**
+			 * Stops the finisher thread; unfinished completions are dropped.
+			 */
+			~Reaper() noexcept;
+
+			/**
+			 * Takes over a child.
+			 * @param target Unreaped child.
+			 * @param prepare Runs once the child exited, right before it is reaped.
+			 * @param pending Work that must finish before @p done (forwarding, captures).
+			 * @param done Called on the finisher thread with the exit code; must not block.
+			 * @param keep Released once @p done returned.
+			 */
+			void Adopt(Target target, std::function<void()> prepare, std::vector<std::future<void>> pending,
+				std::function<void(Code)> done, std::shared_ptr<void> keep);
+
+			/**
+			 * @param id Process id.
+			 * @return Exit code of the last adopted child with @p id, if it was reaped
+			 * and not yet evicted from the table.
+			 */
+			std::optional<Code> ExitCode(uint32_t id) const noexcept;
+
+			/**
+			 * Tells the finisher that some pending work finished; called by every
+			 * forwarding right after its future turns ready. Never constructs the
+			 * instance, so it costs an atomic increment when nothing is detached.
+			 */
+			static void Wake() noexcept;
+
+		private:
+			static constexpr const size_t EXIT_SLOTS = 4096;	///< Exit table size (power of two)
+			static constexpr const size_t EXIT_PROBES = 16;		///< Linear probe length
+
+			/**
+			 * @struct Completion
+			 * @brief Reaped child waiting for its pending work.
+			 */
+			struct Completion {
+				Code code {};								///< Exit code
+				std::vector<std::future<void>> pending;		///< Pending work
+				std::function<void(Code)> done;				///< Callback
+				std::shared_ptr<void> keep;					///< Released at the end
+			};
+
+			/**
+			 * @struct Adoption
+			 * @brief Child not reaped yet.
+			 */
+			struct Adoption {
+				Target target;								///< Child
+				std::function<void()> prepare;				///< Pre-reap hook
+				Completion completion;						///< Completion (code filled when reaped)
+				#ifdef LINUX
+				int pidfd = -1;								///< pidfd watched on the reactor
+				#endif
+			};
+
+			static std::atomic<uint64_t> s_events;					///< Bumped on every finisher event (waited on)
+
+			std::array<std::atomic<uint64_t>, EXIT_SLOTS> m_exits;	///< id << 32 | code; 0 is empty
+			std::mutex m_mutex;										///< Protects m_queue
+			std::deque<Completion> m_queue;							///< Reaped completions not seen by the finisher yet
+			bool m_stop;											///< Stop flag
+			std::thread m_thread;									///< Finisher thread
+
+			/**
+			 * Starts the finisher thread.
+			 */
+			Reaper();
+
+			/**
+			 * Reaps @p adoption (it already exited), records it and queues its completion.
+			 * @param adoption Child.
+			 */
+			void Reap(Adoption& adoption);
+
+			/**
+			 * Stores an exit code in the table (overwriting the home slot when every probe is taken).
+			 * @param id Process id.
+			 * @param code Exit code.
+			 */
+			void Record(uint32_t id, Code code) noexcept;
+
+			/**
+			 * Finisher loop.
+			 */
+			void Loop();
+	};
+}
@@ -0,0 +1,231 @@
+#include <StormByte/system/timer_wheel.hxx>
+
+#include <algorithm>
+#include <bit>
+
+using namespace StormByte::System;
+
+namespace {
+	constexpr const std::chrono::milliseconds TICK { 1 };
+	constexpr const uint64_t MAX_DELTA = (uint64_t(1) << 32) - 1;	///< Wheel range in ticks
+}
+
+TimerWheel& TimerWheel::Instance() {
+	static TimerWheel instance;
+	return instance;
+}
+
+TimerWheel::TimerWheel():
+	m_epoch(Clock::now()), m_now(0), m_free(NIL), m_armed(0), m_sleeping(UINT64_MAX), m_stop(false) {
+	m_buckets.fill(NIL);
+	for (auto& level: m_occupied)
+		level.fill(0);
+	m_thread = std::thread(&TimerWheel::Loop, this);
+}
+
+TimerWheel::~TimerWheel() noexcept {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wake.notify_one();
+	if (m_thread.joinable())
+		m_thread.join();
+}
+
+TimerWheel::Id TimerWheel::Schedule(Clock::time_point when, std::function<void()> fire) {
+	const auto offset = std::chrono::ceil<std::chrono::milliseconds>(when - m_epoch).count();
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (m_armed == 0) {
+		// Idle wheel: catch up so the new timer does not cascade through the idle period
+		const auto elapsed = std::chrono::floor<std::chrono::milliseconds>(Clock::now() - m_epoch).count();
+		m_now = std::max<uint64_t>(m_now, elapsed > 0 ? static_cast<uint64_t>(elapsed) : 0);
+	}
+	uint32_t index = m_free;
+	if (index == NIL) {
+		index = static_cast<uint32_t>(m_nodes.size());
+		m_nodes.emplace_back();
+		m_nodes[index].generation = 1;
+	} else {
+		m_free = m_nodes[index].next;
+	}
+	Node& node = m_nodes[index];
+	node.fire = std::move(fire);
+	node.expiry = std::max<uint64_t>(m_now + 1, offset > 0 ? static_cast<uint64_t>(offset) : 0);
+	Link(index);
+	m_armed++;
+
+	const Id id = (static_cast<Id>(node.generation) << 32) | index;
+	if (node.expiry < m_sleeping) {
+		m_sleeping = node.expiry;
+		lock.unlock();
+		m_wake.notify_one();
+	}
+	return id;
+}
+
+bool TimerWheel::Cancel(Id id) noexcept {
+	const uint32_t index = static_cast<uint32_t>(id);
+	const uint32_t generation = static_cast<uint32_t>(id >> 32);
+	std::function<void()> fire;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (index >= m_nodes.size() || m_nodes[index].generation != generation || m_nodes[index].bucket == NIL)
+			return false;
+		Unlink(index);
+		// Destroyed outside the lock: captures may own objects that cancel timers themselves
+		fire = std::move(m_nodes[index].fire);
+		Release(index);
+		m_armed--;
+	}
+	return true;
+}
+
+size_t TimerWheel::Armed() const noexcept {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_armed;
+}
+
+void TimerWheel::Loop() {
+	std::vector<std::function<void()>> expired;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_stop) {
+		const auto elapsed = std::chrono::floor<std::chrono::milliseconds>(Clock::now() - m_epoch).count();
+		const uint64_t target = static_cast<uint64_t>(std::max<decltype(elapsed)>(elapsed, 0));
+		while (m_now < target) {
+			const uint64_t next = NextTick();
+			if (next > target) {
+				// Nothing due (and no cascade) before target: skip the idle ticks
+				m_now = target;
+				break;
+			}
+			Step(next, expired);
+		}
+
+		if (!expired.empty()) {
+			lock.unlock();
+			for (auto& fire: expired)
+				fire();
+			expired.clear();
+			lock.lock();
+			continue;
+		}
+
+		m_sleeping = NextTick();
+		if (m_sleeping == UINT64_MAX)
+			m_wake.wait(lock);
+		else
+			m_wake.wait_until(lock, TimeOf(m_sleeping));
+		m_sleeping = UINT64_MAX;
+	}
+}
+
+void TimerWheel::Link(uint32_t index) noexcept {
+	Node& node = m_nodes[index];
+	const uint64_t delta = std::min(node.expiry - m_now, MAX_DELTA);
+	const uint64_t at = m_now + delta;
+	unsigned level = 0;
+	while (level + 1 < LEVELS && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1))))
+		level++;
+	const unsigned slot = static_cast<unsigned>(at >> (SLOT_BITS * level)) & (SLOTS - 1);
+	const uint32_t bucket = level * SLOTS + slot;
+
+	node.bucket = bucket;
+	node.prev = NIL;
+	node.next = m_buckets[bucket];
+	if (node.next != NIL)
+		m_nodes[node.next].prev = index;
+	m_buckets[bucket] = index;
+	m_occupied[level][slot / 64] |= uint64_t(1) << (slot % 64);
+}
+
+void TimerWheel::Unlink(uint32_t index) noexcept {
+	Node& node = m_nodes[index];
+	if (node.prev != NIL)
+		m_nodes[node.prev].next = node.next;
+	else
+		m_buckets[node.bucket] = node.next;
+	if (node.next != NIL)
+		m_nodes[node.next].prev = node.prev;
+	if (m_buckets[node.bucket] == NIL) {
+		const unsigned level = node.bucket / SLOTS, slot = node.bucket % SLOTS;
+		m_occupied[level][slot / 64] &= ~(uint64_t(1) << (slot % 64));
+	}
+	node.bucket = NIL;
+	node.prev = node.next = NIL;
+}
+
+void TimerWheel::Release(uint32_t index) noexcept {
+	Node& node = m_nodes[index];
+	node.fire = nullptr;
+	if (++node.generation == 0)
+		node.generation = 1;
+	node.next = m_free;
+	m_free = index;
+}
+
+void TimerWheel::Step(uint64_t tick, std::vector<std::function<void()>>& expired) {
+	m_now = tick;
+	// Cascade: a level is redistributed each time the one below wraps
+	for (unsigned level = 1; level < LEVELS; level++) {
+		if ((tick >> (SLOT_BITS * (level - 1))) & (SLOTS - 1))
+			break;
+		const unsigned slot = static_cast<unsigned>(tick >> (SLOT_BITS * level)) & (SLOTS - 1);
+		uint32_t index = m_buckets[level * SLOTS + slot];
+		m_buckets[level * SLOTS + slot] = NIL;
+		m_occupied[level][slot / 64] &= ~(uint64_t(1) << (slot % 64));
+		while (index != NIL) {
+			const uint32_t next = m_nodes[index].next;
+			Link(index);
+			index = next;
+		}
+	}
+
+	const unsigned slot = static_cast<unsigned>(tick) & (SLOTS - 1);
+	uint32_t index = m_buckets[slot];
+	m_buckets[slot] = NIL;
+	m_occupied[0][slot / 64] &= ~(uint64_t(1) << (slot % 64));
+	while (index != NIL) {
+		Node& node = m_nodes[index];
+		const uint32_t next = node.next;
+		node.bucket = NIL;
+		expired.push_back(std::move(node.fire));
+		Release(index);
+		m_armed--;
+		index = next;
+	}
+}
+
+uint64_t TimerWheel::NextTick() const noexcept {
+	if (m_armed == 0)
+		return UINT64_MAX;
+	uint64_t next = UINT64_MAX;
+	const unsigned from = static_cast<unsigned>(m_now + 1) & (SLOTS - 1);
+	const unsigned distance = NextOccupied(0, from);
+	if (distance < SLOTS)
+		next = m_now + 1 + distance;
+	// Upper levels only change at a wrap of level 0
+	for (unsigned level = 1; level < LEVELS; level++) {
+		if (NextOccupied(level, 0) < SLOTS) {
+			next = std::min(next, ((m_now >> SLOT_BITS) + 1) << SLOT_BITS);
+			break;
+		}
+	}
+	return next;
+}
+
+unsigned TimerWheel::NextOccupied(unsigned level, unsigned from) const noexcept {
+	const auto& words = m_occupied[level];
+	for (unsigned scanned = 0; scanned < SLOTS;) {
+		const unsigned slot = (from + scanned) & (SLOTS - 1);
+		const uint64_t bits = words[slot / 64] >> (slot % 64);
+		if (bits)
+			return std::min(SLOTS, scanned + static_cast<unsigned>(std::countr_zero(bits)));
+		scanned += 64 - slot % 64;
+	}
+	return SLOTS;
+}
+
+TimerWheel::Clock::time_point TimerWheel::TimeOf(uint64_t tick) const noexcept {
+	return m_epoch + tick * TICK;
+}
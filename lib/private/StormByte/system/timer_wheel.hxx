@@ -0,0 +1,190 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	/**
+	 * @class TimerWheel
+	 * @brief Process-wide hierarchical timer wheel served by one thread.
+	 *
+	 * Four levels of 256 slots with a 1 ms tick (about 49 days of range);
+	 * timers are intrusive list nodes, so arming and cancelling are O(1)
+	 * regardless of how many are pending. The thread sleeps until the next
+	 * occupied slot (or the next cascade) instead of ticking.
+	 *
+	 * Callbacks run on the wheel thread without the wheel lock held; they may
+	 * schedule or cancel timers but must not block.
+	 */
+	class STORMBYTE_SYSTEM_PRIVATE TimerWheel {
+		public:
+			using Clock = std::chrono::steady_clock;	///< Time source
+			using Id = uint64_t;						///< Timer handle (0 is never returned)
+
+			/**
+			 * @return Shared instance (its thread starts on first use).
+			 */
+			static TimerWheel& Instance();
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			TimerWheel(const TimerWheel&) = delete;
+
+			/**
+			 * Move constructor (deleted).
+			 */
+			TimerWheel(TimerWheel&&) = delete;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			TimerWheel& operator=(const TimerWheel&) = delete;
+
+			/**
+			 * Move assignment (deleted).
+			 */
+			TimerWheel& operator=(TimerWheel&&) = delete;
+
+			/**
+			 * Stops the thread; pending timers are dropped.
+			 */
+			~TimerWheel() noexcept;
+
+			/**
+			 * Arms a one-shot timer.
+			 * @param when Expiry (rounded up to the next tick; past times fire on the next tick).
+			 * @param fire Callback.
+			 * @return Handle for @ref Cancel().
+			 */
+			Id Schedule(Clock::time_point when, std::function<void()> fire);
+
+			/**
+			 * Disarms a timer.
+			 * @param id Handle from @ref Schedule().
+			 * @return false if it already fired or was cancelled.
+			 */
+			bool Cancel(Id id) noexcept;
+
+			/**
+			 * @return Number of armed timers.
+			 */
+			size_t Armed() const noexcept;
+
+		private:
+			static constexpr const unsigned LEVELS = 4;			///< Wheel levels
+			static constexpr const unsigned SLOT_BITS = 8;		///< log2 of slots per level
+			static constexpr const unsigned SLOTS = 1u << SLOT_BITS;	///< Slots per level
+			static constexpr const uint32_t NIL = UINT32_MAX;	///< End of list
+
+			/**
+			 * @struct Node
+			 * @brief Armed (or free) timer slot.
+			 */
+			struct Node {
+				std::function<void()> fire;			///< Callback
+				uint64_t expiry = 0;				///< Absolute tick
+				uint32_t prev = NIL;				///< Previous node in the bucket
+				uint32_t next = NIL;				///< Next node in the bucket (or free list)
+				uint32_t bucket = NIL;				///< level * SLOTS + slot, NIL when not armed
+				uint32_t generation = 0;			///< Bumped on release; stale ids fail
+			};
+
+			Clock::time_point m_epoch;							///< Tick 0
+			uint64_t m_now;										///< Last processed tick
+			mutable std::mutex m_mutex;							///< Protects everything below
+			std::condition_variable m_wake;						///< Earlier expiry or stop
+			std::vector<Node> m_nodes;							///< Node pool
+			uint32_t m_free;									///< Free list head
+			size_t m_armed;										///< Armed timers
+			uint64_t m_sleeping;								///< Tick the thread sleeps until (UINT64_MAX: idle)
+			std::array<uint32_t, LEVELS * SLOTS> m_buckets;		///< Bucket heads
+			std::array<std::array<uint64_t, SLOTS / 64>, LEVELS> m_occupied;	///< Non-empty bucket bitmap per level
+			bool m_stop;										///< Stop flag
+			std::thread m_thread;								///< Wheel thread
+
+			/**
+			 * Starts the thread.
+			 */
+			TimerWheel();
+
+			/**
+			 * Thread loop.
+			 */
+			void Loop();
+
+			/**
+			 * Links @p index into the bucket matching its expiry.
+			 * @param index Node.
+			 */
+			void Link(uint32_t index) noexcept;
+
+			/**
+			 * Removes @p index from its bucket.
+			 * @param index Node.
+			 */
+			void Unlink(uint32_t index) noexcept;
+
+			/**
+			 * Returns @p index to the free list.
+			 * @param index Node.
+			 */
+			void Release(uint32_t index) noexcept;
+
+			/**
+			 * Processes tick @p tick: cascades upper levels, then collects expired callbacks.
+			 * @param tick Next tick needing work (see @ref NextTick()).
+			 * @param expired Receives the callbacks to run.
+			 */
+			void Step(uint64_t tick, std::vector<std::function<void()>>& expired);
+
+			/**
+			 * @return Next tick that needs processing, or UINT64_MAX if nothing is armed.
+			 */
+			uint64_t NextTick() const noexcept;
+
+			/**
+			 * @param level Level.
+			 * @param from First slot to check.
+			 * @return Distance from @p from to the next occupied slot of @p level, or SLOTS if none.
+			 */
+			unsigned NextOccupied(unsigned level, unsigned from) const noexcept;
+
+			/**
+			 * @param tick Tick.
+			 * @return Its wall time.
+			 */
+			Clock::time_point TimeOf(uint64_t tick) const noexcept;
+	};
+}
@@ -0,0 +1,130 @@
+#include <StormByte/system/tracer.hxx>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+using namespace StormByte::System;
+
+std::atomic<bool> Tracer::s_on { false };
+
+namespace {
+	constexpr const size_t CHUNK_EVENTS = 1024;
+
+	/**
+	 * Fixed block of events; only its writer appends, and it is never touched
+	 * by the writer again once @ref next is set.
+	 */
+	struct Chunk {
+		std::array<TraceEvent, CHUNK_EVENTS> events;	///< Records
+		std::atomic<size_t> count { 0 };				///< Published records
+		std::atomic<Chunk*> next { nullptr };			///< Following chunk
+	};
+
+	/**
+	 * Single-producer (the owning thread), single-consumer (the flush) chunk chain.
+	 */
+	struct ThreadBuffer {
+		uint32_t thread;			///< Sequential thread number
+		Chunk* head;				///< Oldest chunk (consumer side)
+		Chunk* tail;				///< Current chunk (producer side)
+		size_t read = 0;			///< Consumed records in head
+
+		explicit ThreadBuffer(uint32_t number, Chunk* first) noexcept: thread(number), head(first), tail(first) {}
+
+		~ThreadBuffer() noexcept {
+			while (head) {
+				Chunk* next = head->next.load(std::memory_order_acquire);
+				delete head;
+				head = next;
+			}
+		}
+	};
+
+	const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+	std::mutex registry_mutex;
+	std::vector<std::shared_ptr<ThreadBuffer>> registry;	///< Every buffer ever registered
+	std::atomic<uint32_t> next_thread { 1 };
+
+	ThreadBuffer* Local() noexcept {
+		// Kept in the registry after the thread exits, until flushed
+		thread_local std::shared_ptr<ThreadBuffer> buffer;
+		if (!buffer) {
+			Chunk* first = new (std::nothrow) Chunk();
+			if (!first)
+				return nullptr;
+			try {
+				buffer = std::make_shared<ThreadBuffer>(next_thread.fetch_add(1), first);
+				std::lock_guard<std::mutex> lock(registry_mutex);
+				registry.push_back(buffer);
+			} catch (...) {
+				if (!buffer)
+					delete first;
+				buffer.reset();
+				return nullptr;
+			}
+		}
+		return buffer.get();
+	}
+}
+
+uint64_t Tracer::Now() noexcept {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+void Tracer::Instant(const char* name, int64_t id, uint64_t bytes) noexcept {
+	Record(TraceEvent { name, 'i', Now(), 0, id, bytes });
+}
+
+void Tracer::Complete(const char* name, uint64_t start, int64_t id, uint64_t bytes) noexcept {
+	const uint64_t now = Now();
+	Record(TraceEvent { name, 'X', start, now > start ? now - start : 0, id, bytes });
+}
+
+void Tracer::Record(const TraceEvent& event) noexcept {
+	ThreadBuffer* buffer = Local();
+	if (!buffer)
+		return;
+	Chunk* tail = buffer->tail;
+	size_t count = tail->count.load(std::memory_order_relaxed);
+	if (count == CHUNK_EVENTS) {
+		Chunk* chunk = new (std::nothrow) Chunk();
+		if (!chunk)
+			return;
+		tail->next.store(chunk, std::memory_order_release);
+		buffer->tail = tail = chunk;
+		count = 0;
+	}
+	tail->events[count] = event;
+	tail->count.store(count + 1, std::memory_order_release);
+}
+
+size_t Tracer::Drain(const std::function<void(uint32_t thread, const TraceEvent& event)>& visit) {
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	size_t visited = 0;
+	for (auto it = registry.begin(); it != registry.end();) {
+		ThreadBuffer& buffer = **it;
+		while (true) {
+			Chunk* chunk = buffer.head;
+			const size_t count = chunk->count.load(std::memory_order_acquire);
+			for (; buffer.read < count; buffer.read++, visited++)
+				visit(buffer.thread, chunk->events[buffer.read]);
+			// next is only set on a full chunk, after its last record
+			Chunk* next = chunk->next.load(std::memory_order_acquire);
+			if (!next || buffer.read < CHUNK_EVENTS)
+				break;
+			buffer.head = next;
+			buffer.read = 0;
+			delete chunk;
+		}
+		// Only the registry still holds it: its thread exited and everything was read
+		if (it->use_count() == 1)
+			it = registry.erase(it);
+		else
+			++it;
+	}
+	return visited;
+}
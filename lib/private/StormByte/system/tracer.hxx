@@ -0,0 +1,107 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	/**
+	 * @struct TraceEvent
+	 * @brief Fixed-size trace record.
+	 */
+	struct STORMBYTE_SYSTEM_PRIVATE TraceEvent {
+		const char* name;		///< Event name (static string)
+		char phase;				///< 'X' (complete) or 'i' (instant)
+		uint64_t start;			///< Nanoseconds since the trace epoch
+		uint64_t duration;		///< Nanoseconds ('X' only)
+		int64_t id;				///< Process id the event belongs to
+		uint64_t bytes;			///< Bytes moved (0 if not applicable)
+	};
+
+	/**
+	 * @class Tracer
+	 * @brief Library-side recording for @ref Trace.
+	 *
+	 * Each thread appends to its own chain of fixed chunks, publishing each
+	 * record with a release store; the flushing thread consumes them with
+	 * acquire loads, so recording never takes a lock.
+	 */
+	class STORMBYTE_SYSTEM_PRIVATE Tracer {
+		public:
+			/**
+			 * Constructor (deleted: static interface).
+			 */
+			Tracer() = delete;
+
+			/**
+			 * @return true while recording (the only cost of a disabled probe).
+			 */
+			static bool On() noexcept {
+				return s_on.load(std::memory_order_relaxed);
+			}
+
+			/**
+			 * @return Nanoseconds since the trace epoch.
+			 */
+			static uint64_t Now() noexcept;
+
+			/**
+			 * Records an instant event.
+			 * @param name Static name.
+			 * @param id Process id.
+			 * @param bytes Bytes (optional).
+			 */
+			static void Instant(const char* name, int64_t id, uint64_t bytes = 0) noexcept;
+
+			/**
+			 * Records a complete event from @p start until now.
+			 * @param name Static name.
+			 * @param start Value of @ref Now() when it began.
+			 * @param id Process id.
+			 * @param bytes Bytes (optional).
+			 */
+			static void Complete(const char* name, uint64_t start, int64_t id, uint64_t bytes = 0) noexcept;
+
+		private:
+			friend class Trace;
+
+			static std::atomic<bool> s_on;	///< Recording gate
+
+			/**
+			 * Appends @p event to the calling thread buffer (dropped if out of memory).
+			 * @param event Event.
+			 */
+			static void Record(const TraceEvent& event) noexcept;
+
+			/**
+			 * Hands every published event to @p visit and releases it.
+			 * @param visit Receives the recording thread number and the event.
+			 * @return Number of events visited.
+			 */
+			static size_t Drain(const std::function<void(uint32_t thread, const TraceEvent& event)>& visit);
+	};
+}
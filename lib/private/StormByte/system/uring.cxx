@@ -0,0 +1,222 @@
+#include <StormByte/system/reaper.hxx>
+#include <StormByte/system/uring.hxx>
+
+#ifdef STORMBYTE_SYSTEM_IO_URING
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace StormByte::System;
+
+namespace {
+	constexpr const unsigned RING_ENTRIES = 256;
+	constexpr const unsigned SPLICE_CHUNK = 1024 * 1024;
+	constexpr const __u64 SILENT = 1;			///< user_data of linked heads / wakeups
+
+	int Enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) noexcept {
+		return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+	}
+}
+
+Uring* Uring::Instance() noexcept {
+	static std::unique_ptr<Uring> instance = [] {
+		std::unique_ptr<Uring> ring(new Uring());
+		if (ring->m_fd < 0)
+			ring.reset();
+		return ring;
+	}();
+	return instance.get();
+}
+
+Uring::Uring() noexcept:
+	m_fd(-1), m_entries(0), m_sq_ring(MAP_FAILED), m_cq_ring(MAP_FAILED), m_sq_ring_size(0), m_cq_ring_size(0),
+	m_sqes(static_cast<io_uring_sqe*>(MAP_FAILED)), m_sq_tail(nullptr), m_sq_head(nullptr), m_sq_mask(0), m_sq_array(nullptr),
+	m_cq_head(nullptr), m_cq_tail(nullptr), m_cq_mask(0), m_cqes(nullptr), m_devnull(-1), m_stop(false) {
+	io_uring_params params;
+	std::memset(&params, 0, sizeof(params));
+	const int fd = static_cast<int>(syscall(__NR_io_uring_setup, RING_ENTRIES, &params));
+	if (fd < 0)
+		return;
+
+	// Forwarding needs linked poll and splice
+	const size_t probe_size = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+	std::vector<char> probe_storage(probe_size, 0);
+	io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(probe_storage.data());
+	auto supported = [probe](unsigned op) {
+		return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+	};
+	if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, 256) < 0 ||
+		!supported(IORING_OP_SPLICE) || !supported(IORING_OP_POLL_ADD) || !(params.features & IORING_FEAT_NODROP)) {
+		close(fd);
+		return;
+	}
+
+	m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+	if (single)
+		m_sq_ring_size = m_cq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+
+	m_sq_ring = mmap(nullptr, m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	m_cq_ring = single ? m_sq_ring : mmap(nullptr, m_cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+	m_entries = params.sq_entries;
+	m_sqes = static_cast<io_uring_sqe*>(mmap(nullptr, params.sq_entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+	m_devnull = open("/dev/null", O_WRONLY | O_CLOEXEC);
+	if (m_sq_ring == MAP_FAILED || m_cq_ring == MAP_FAILED || m_sqes == MAP_FAILED || m_devnull < 0) {
+		m_fd = fd;
+		Release();
+		return;
+	}
+
+	char* sq = static_cast<char*>(m_sq_ring);
+	char* cq = static_cast<char*>(m_cq_ring);
+	m_sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+	m_sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+	m_sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+	m_sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+	m_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+	m_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+	m_cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+	m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+	m_fd = fd;
+
+	m_completions = std::thread(&Uring::CompletionLoop, this);
+}
+
+Uring::~Uring() noexcept {
+	if (m_completions.joinable()) {
+		m_stop.store(true);
+		// A NOP wakes the completion thread out of io_uring_enter
+		Submit(1, [](io_uring_sqe& sqe, unsigned) { sqe.opcode = IORING_OP_NOP; }, [](int) {});
+		m_completions.join();
+	}
+	Release();
+}
+
+void Uring::Release() noexcept {
+	if (m_sqes != MAP_FAILED)
+		munmap(m_sqes, m_entries * sizeof(io_uring_sqe));
+	if (m_cq_ring != MAP_FAILED && m_cq_ring != m_sq_ring)
+		munmap(m_cq_ring, m_cq_ring_size);
+	if (m_sq_ring != MAP_FAILED)
+		munmap(m_sq_ring, m_sq_ring_size);
+	if (m_devnull >= 0)
+		close(m_devnull);
+	if (m_fd >= 0)
+		close(m_fd);
+	m_sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+	m_sq_ring = m_cq_ring = MAP_FAILED;
+	m_devnull = m_fd = -1;
+}
+
+std::future<void> Uring::Forward(int in, int out, std::function<void(bool)> finished) {
+	std::shared_ptr<ForwardState> state = std::make_shared<ForwardState>();
+	state->in = in;
+	state->out = out;
+	state->draining = false;
+	state->finished = std::move(finished);
+	std::future<void> done = state->done.get_future();
+	SpliceNext(std::move(state));
+	return done;
+}
+
+void Uring::Submit(unsigned count, const std::function<void(io_uring_sqe&, unsigned)>& prepare, std::function<void(int)> complete) {
+	Operation* op = new Operation { std::move(complete) };
+	{
+		std::lock_guard<std::mutex> lock(m_sq_mutex);
+		unsigned tail = *m_sq_tail;
+		// Make room: the kernel consumes SQEs synchronously on enter
+		while (tail + count - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE) > m_entries)
+			Enter(m_fd, tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE), 0, 0);
+
+		for (unsigned i = 0; i < count; i++) {
+			const unsigned index = (tail + i) & m_sq_mask;
+			io_uring_sqe& sqe = m_sqes[index];
+			std::memset(&sqe, 0, sizeof(sqe));
+			prepare(sqe, i);
+			if (i + 1 < count) {
+				sqe.flags |= IOSQE_IO_LINK;
+				sqe.user_data = SILENT;
+			} else {
+				sqe.user_data = reinterpret_cast<__u64>(op);
+			}
+			m_sq_array[index] = index;
+		}
+		__atomic_store_n(m_sq_tail, tail + count, __ATOMIC_RELEASE);
+	}
+	// Whoever enters first submits everything queued so far
+	int r;
+	do {
+		r = Enter(m_fd, m_entries, 0, 0);
+	} while (r < 0 && errno == EINTR);
+}
+
+void Uring::SpliceNext(std::shared_ptr<ForwardState> state) {
+	const int in = state->in;
+	const int out = state->draining ? m_devnull : state->out;
+	Submit(2, [in, out](io_uring_sqe& sqe, unsigned index) {
+		if (index == 0) {
+			// Wait for readiness without parking an io-wq worker
+			sqe.opcode = IORING_OP_POLL_ADD;
+			sqe.fd = in;
+			sqe.poll32_events = POLLIN | POLLHUP;
+		} else {
+			sqe.opcode = IORING_OP_SPLICE;
+			sqe.fd = out;
+			sqe.off = static_cast<__u64>(-1);
+			sqe.splice_off_in = static_cast<__u64>(-1);
+			sqe.splice_fd_in = in;
+			sqe.len = SPLICE_CHUNK;
+			sqe.splice_flags = SPLICE_F_MOVE;
+		}
+	}, [this, state](int res) {
+		if (res > 0 || res == -EAGAIN || res == -EINTR) {
+			SpliceNext(state);
+			return;
+		}
+		if (res < 0 && !state->draining) {
+			// Destination gone: report and keep draining so the producer can exit
+			state->draining = true;
+			state->finished(false);
+			SpliceNext(state);
+			return;
+		}
+		if (!state->draining)
+			state->finished(true);
+		state->done.set_value();
+		Reaper::Wake();
+	});
+}
+
+void Uring::CompletionLoop() {
+	std::vector<std::pair<Operation*, int>> ready;
+	while (!m_stop.load()) {
+		const int r = Enter(m_fd, 0, 1, IORING_ENTER_GETEVENTS);
+		if (r < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+			break;
+
+		unsigned head = *m_cq_head;
+		const unsigned tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+		for (; head != tail; head++) {
+			const io_uring_cqe& cqe = m_cqes[head & m_cq_mask];
+			if (cqe.user_data != SILENT)
+				ready.emplace_back(reinterpret_cast<Operation*>(cqe.user_data), cqe.res);
+		}
+		__atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+
+		// Dispatch after releasing the slots: completions usually resubmit
+		for (auto& [op, res]: ready) {
+			op->complete(res);
+			delete op;
+		}
+		ready.clear();
+	}
+}
+#endif
@@ -0,0 +1,168 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#if defined(LINUX) && __has_include(<linux/io_uring.h>)
+#define STORMBYTE_SYSTEM_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/types.h>
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	/**
+	 * @class Uring
+	 * @brief Process-wide io_uring instance (raw syscalls, no liburing).
+	 *
+	 * One ring and one completion thread serve every live process: submissions
+	 * from any thread are pushed to the shared SQ and flushed by whichever
+	 * thread enters the kernel next, so concurrent pipelines batch naturally.
+	 * Forwarding uses linked POLL_ADD → SPLICE pairs (pipe to pipe, no user
+	 * buffer). The ring serves forwarding only: waits and Pipe reads and
+	 * writes do not go through it.
+	 */
+	class STORMBYTE_SYSTEM_PRIVATE Uring {
+		public:
+			/**
+			 * @return Shared instance, or nullptr if io_uring (or SPLICE) is unavailable.
+			 */
+			static Uring* Instance() noexcept;
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			Uring(const Uring&) = delete;
+
+			/**
+			 * Move constructor (deleted).
+			 */
+			Uring(Uring&&) = delete;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			Uring& operator=(const Uring&) = delete;
+
+			/**
+			 * Move assignment (deleted).
+			 */
+			Uring& operator=(Uring&&) = delete;
+
+			/**
+			 * Stops the completion thread and releases the ring.
+			 */
+			~Uring() noexcept;
+
+			/**
+			 * Splices @p in into @p out until EOF.
+			 *
+			 * If @p out stops accepting data, @p finished(false) is invoked and the
+			 * remaining input is drained to /dev/null so the producer can finish.
+			 * @param in Pipe read end.
+			 * @param out Pipe write end.
+			 * @param finished Called once from the completion thread with the outcome.
+			 * @return Future ready when @p in reached EOF.
+			 */
+			std::future<void> Forward(int in, int out, std::function<void(bool)> finished);
+
+		private:
+			/**
+			 * @struct Operation
+			 * @brief Pending submission; its address is the SQE user_data.
+			 */
+			struct Operation {
+				std::function<void(int)> complete;		///< Invoked with cqe->res
+			};
+
+			/**
+			 * @struct ForwardState
+			 * @brief Splice loop state shared by its completions.
+			 */
+			struct ForwardState {
+				int in;									///< Source
+				int out;								///< Destination
+				bool draining;							///< Destination failed, discarding
+				std::function<void(bool)> finished;		///< Outcome callback
+				std::promise<void> done;				///< EOF reached
+			};
+
+			int m_fd;									///< Ring descriptor
+			unsigned m_entries;							///< SQ entries
+			void* m_sq_ring;							///< SQ ring mapping
+			void* m_cq_ring;							///< CQ ring mapping
+			size_t m_sq_ring_size;						///< SQ mapping size
+			size_t m_cq_ring_size;						///< CQ mapping size
+			io_uring_sqe* m_sqes;						///< SQE array
+			unsigned* m_sq_tail;						///< SQ tail (user owned)
+			unsigned* m_sq_head;						///< SQ head (kernel owned)
+			unsigned m_sq_mask;							///< SQ mask
+			unsigned* m_sq_array;						///< SQ index array
+			unsigned* m_cq_head;						///< CQ head (user owned)
+			unsigned* m_cq_tail;						///< CQ tail (kernel owned)
+			unsigned m_cq_mask;							///< CQ mask
+			io_uring_cqe* m_cqes;						///< CQE array
+			int m_devnull;								///< Drain target
+			std::mutex m_sq_mutex;						///< Serializes SQ producers
+			std::atomic<bool> m_stop;					///< Completion thread stop flag
+			std::thread m_completions;					///< Completion thread
+
+			/**
+			 * Maps the ring; check @ref m_fd afterwards.
+			 */
+			Uring() noexcept;
+
+			/**
+			 * Queues SQEs and flushes pending submissions to the kernel.
+			 * @param count SQEs to fill (linked in order when more than one).
+			 * @param prepare Fills SQE @p index.
+			 * @param complete Completion for the last SQE (earlier ones complete silently).
+			 */
+			void Submit(unsigned count, const std::function<void(io_uring_sqe&, unsigned)>& prepare, std::function<void(int)> complete);
+
+			/**
+			 * Submits the next POLL_ADD → SPLICE iteration.
+			 * @param state Loop state.
+			 */
+			void SpliceNext(std::shared_ptr<ForwardState> state);
+
+			/**
+			 * Reaps CQEs and dispatches completions until stopped.
+			 */
+			void CompletionLoop();
+
+			/**
+			 * Unmaps the ring and closes descriptors.
+			 */
+			void Release() noexcept;
+	};
+}
+#endif
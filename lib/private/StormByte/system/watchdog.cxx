@@ -0,0 +1,94 @@
+#include <StormByte/system/watchdog.hxx>
+
+#ifdef UNIX
+#include <signal.h>
+#endif
+
+using namespace StormByte::System;
+
+std::shared_ptr<Watchdog> Watchdog::Arm(std::vector<Target> targets, const Process::Deadline& deadline) {
+	std::shared_ptr<Watchdog> watchdog(new Watchdog(std::move(targets), deadline));
+	std::lock_guard<std::mutex> lock(watchdog->m_mutex);
+	watchdog->m_timer = TimerWheel::Instance().Schedule(TimerWheel::Clock::now() + deadline.timeout,
+		[watchdog] { watchdog->Expire(); });
+	return watchdog;
+}
+
+Watchdog::Watchdog(std::vector<Target> targets, const Process::Deadline& deadline):
+	m_live(targets.size()), m_deadline(deadline), m_timer(0), m_fired(false) {
+	m_members.reserve(targets.size());
+	for (const Target target: targets)
+		m_members.push_back(Member { target, true, false });
+}
+
+bool Watchdog::Fired() const noexcept {
+	return m_fired.load();
+}
+
+bool Watchdog::Release(Target target) noexcept {
+	TimerWheel::Id timer = 0;
+	bool signalled = false;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (Member& member: m_members) {
+			if (member.live && member.target == target) {
+				member.live = false;
+				signalled = member.signalled;
+				if (--m_live == 0) {
+					timer = m_timer;
+					m_timer = 0;
+				}
+				break;
+			}
+		}
+	}
+	// Outside the lock: the cancelled callback holds the last reference to this watchdog
+	if (timer)
+		TimerWheel::Instance().Cancel(timer);
+	return signalled;
+}
+
+void Watchdog::Expire() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_timer = 0;
+		if (m_live == 0)
+			return;
+		m_fired.store(true);
+	}
+	// Before signalling, so it runs before any member can be reaped
+	if (m_deadline.on_timeout)
+		m_deadline.on_timeout();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_live == 0)
+		return;
+	for (Member& member: m_members) {
+		if (!member.live)
+			continue;
+		member.signalled = true;
+#ifdef UNIX
+		::kill(member.target, SIGTERM);
+		// A stopped process only acts on SIGTERM once continued
+		::kill(member.target, SIGCONT);
+#else
+		TerminateProcess(member.target, static_cast<UINT>(-1));
+#endif
+	}
+#ifdef UNIX
+	std::shared_ptr<Watchdog> self = shared_from_this();
+	m_timer = TimerWheel::Instance().Schedule(TimerWheel::Clock::now() + m_deadline.grace,
+		[self] { self->Kill(); });
+#endif
+}
+
+void Watchdog::Kill() noexcept {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_timer = 0;
+#ifdef UNIX
+	for (const Member& member: m_members) {
+		if (member.live)
+			::kill(member.target, SIGKILL);
+	}
+#endif
+}
@@ -0,0 +1,132 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/process.hxx>
+#include <StormByte/system/timer_wheel.hxx>
+#include <StormByte/system/visibility.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	/**
+	 * @class Watchdog
+	 * @brief Deadline shared by one or more processes, driven by the @ref TimerWheel.
+	 *
+	 * Signals are only sent to members still registered, and members are
+	 * released (under the same lock) before their owner reaps them, so a
+	 * recycled PID is never signalled.
+	 */
+	class STORMBYTE_SYSTEM_PRIVATE Watchdog: public std::enable_shared_from_this<Watchdog> {
+		public:
+			#ifdef UNIX
+			using Target = pid_t;		///< Watched process
+			#else
+			using Target = HANDLE;		///< Watched process
+			#endif
+
+			/**
+			 * Arms a deadline starting now.
+			 * @param targets Processes (all still unreaped).
+			 * @param deadline Limits and callback.
+			 * @return Watchdog, kept alive by its members and the pending timer.
+			 */
+			static std::shared_ptr<Watchdog> Arm(std::vector<Target> targets, const Process::Deadline& deadline);
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			Watchdog(const Watchdog&) = delete;
+
+			/**
+			 * Move constructor (deleted).
+			 */
+			Watchdog(Watchdog&&) = delete;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			Watchdog& operator=(const Watchdog&) = delete;
+
+			/**
+			 * Move assignment (deleted).
+			 */
+			Watchdog& operator=(Watchdog&&) = delete;
+
+			/**
+			 * Destructor.
+			 */
+			~Watchdog() noexcept = default;
+
+			/**
+			 * @return true once the soft deadline fired.
+			 */
+			bool Fired() const noexcept;
+
+			/**
+			 * Stops watching @p target; call before reaping it. The timer is
+			 * cancelled once every member is released.
+			 * @param target Member.
+			 * @return true if @p target was signalled by the deadline.
+			 */
+			bool Release(Target target) noexcept;
+
+		private:
+			/**
+			 * @struct Member
+			 * @brief Watched process.
+			 */
+			struct Member {
+				Target target;					///< Process
+				bool live;						///< Not released yet
+				bool signalled;					///< Terminated by the deadline
+			};
+
+			mutable std::mutex m_mutex;			///< Protects members and timer
+			std::vector<Member> m_members;		///< Watched processes
+			size_t m_live;						///< Members not released
+			Process::Deadline m_deadline;		///< Limits and callback
+			TimerWheel::Id m_timer;				///< Pending timer (0 if none)
+			std::atomic<bool> m_fired;			///< Soft deadline fired
+
+			/**
+			 * @param targets Processes.
+			 * @param deadline Limits and callback.
+			 */
+			Watchdog(std::vector<Target> targets, const Process::Deadline& deadline);
+
+			/**
+			 * Soft deadline: terminates every live member, then arms the kill timer.
+			 */
+			void Expire();
+
+			/**
+			 * Grace period over: kills every member still live.
+			 */
+			void Kill() noexcept;
+	};
+}
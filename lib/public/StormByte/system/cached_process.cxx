@@ -0,0 +1,166 @@
+#include <StormByte/system/cached_process.hxx>
+#include <StormByte/system/command.hxx>
+#include <StormByte/system/murmur_hash.hxx>
+
+#include <cstdlib>
+
+#ifdef UNIX
+#include <sys/stat.h>
+#endif
+
+using namespace StormByte::System;
+
+namespace {
+	// Bumped whenever the key layout changes
+	constexpr const std::string_view KEY_VERSION = "CachedProcess/1";
+
+	void HashProgram(MurmurHash& hash, const std::filesystem::path& program) {
+		hash.Field(program.string());
+	#ifdef UNIX
+		struct stat st;
+		if (stat(program.c_str(), &st) == 0) {
+			const std::string identity = std::to_string(st.st_dev) + ":" + std::to_string(st.st_ino) + ":" +
+				std::to_string(st.st_size) + ":" + std::to_string(st.st_mtim.tv_sec) + "." + std::to_string(st.st_mtim.tv_nsec);
+			hash.Field(identity);
+			return;
+		}
+	#endif
+		std::error_code ec;
+		const auto size = std::filesystem::file_size(program, ec);
+		const auto time = std::filesystem::last_write_time(program, ec);
+		hash.Field(std::to_string(size) + ":" + std::to_string(time.time_since_epoch().count()));
+	}
+}
+
+CachedProcess::CachedProcess(std::shared_ptr<ResultCache> cache, const std::filesystem::path& prog,
+	const std::vector<std::string>& args, const std::vector<std::string>& keyed_env):
+	CachedProcess(std::move(cache), prog, args, keyed_env, Process::Options()) {}
+
+CachedProcess::CachedProcess(std::shared_ptr<ResultCache> cache, const std::filesystem::path& prog,
+	const std::vector<std::string>& args, const std::vector<std::string>& keyed_env, const Process::Options& opts):
+	m_cache(std::move(cache)), m_program(opts.environment ? Command(prog).Resolve(*opts.environment) : Command(prog).Resolve()), m_arguments(args), m_options(opts),
+	m_hash(std::make_unique<MurmurHash>()), m_resolved(false), m_hit(false), m_code(-1),
+	m_out_read(false), m_err_read(false) {
+	m_hash->Field(KEY_VERSION);
+	HashProgram(*m_hash, m_program);
+	m_hash->Field(std::to_string(m_arguments.size()));
+	for (const std::string& arg: m_arguments)
+		m_hash->Field(arg);
+	for (const std::string& name: keyed_env) {
+		std::optional<std::string_view> value;
+		if (m_options.environment) {
+			value = m_options.environment->Get(name);
+		} else if (const char* current = std::getenv(name.c_str())) {
+			value = current;
+		}
+		// Unset and empty differ
+		m_hash->Field(name);
+		m_hash->Field(value ? "=" + std::string(*value) : std::string());
+	}
+	m_hash->Field(m_options.merge_stderr ? "2>&1" : "");
+}
+
+CachedProcess::CachedProcess(CachedProcess&&) noexcept = default;
+
+CachedProcess& CachedProcess::operator=(CachedProcess&&) noexcept = default;
+
+CachedProcess::~CachedProcess() noexcept = default;
+
+CachedProcess& CachedProcess::operator<<(const std::string& str) {
+	if (!m_resolved) {
+		m_hash->Update(str);
+		m_stdin += str;
+	}
+	return *this;
+}
+
+void CachedProcess::operator<<(const System::_EoF&) {
+	Resolve();
+}
+
+std::string& CachedProcess::operator>>(std::string& str) {
+	Resolve();
+	if (!m_out_read) {
+		str.append(Out());
+		m_out_read = true;
+	}
+	return str;
+}
+
+std::string& CachedProcess::Stderr(std::string& str) {
+	Resolve();
+	if (!m_err_read) {
+		str.append(Err());
+		m_err_read = true;
+	}
+	return str;
+}
+
+#ifdef UNIX
+int CachedProcess::Wait() {
+	Resolve();
+	return m_code;
+}
+#else
+DWORD CachedProcess::Wait() {
+	Resolve();
+	return static_cast<DWORD>(m_code);
+}
+#endif
+
+bool CachedProcess::Hit() const noexcept {
+	return m_hit;
+}
+
+CacheKey CachedProcess::Key() {
+	Resolve();
+	return m_key;
+}
+
+std::ostream& StormByte::System::operator<<(std::ostream& os, CachedProcess& proc) {
+	std::string data;
+	proc >> data;
+	return os << data;
+}
+
+void CachedProcess::Resolve() {
+	if (m_resolved)
+		return;
+	m_resolved = true;
+
+	// stdin is the last field: its length closes it
+	m_hash->Field(std::to_string(m_stdin.size()));
+	const MurmurHash::Digest digest = m_hash->Finish();
+	m_key = CacheKey { digest[0], digest[1] };
+
+	m_stored = m_cache->Lookup(m_key);
+	if (m_stored) {
+		m_hit = true;
+		m_code = m_stored->ExitCode();
+		m_stdin.clear();
+		return;
+	}
+
+	// Both streams are drained while stdin is written, so a chatty child can not block it
+	Process proc(m_program, m_arguments, m_options);
+	proc.Capture(Process::Stream::STDOUT, CapturePolicy::Full());
+	proc.Capture(Process::Stream::STDERR, CapturePolicy::Full());
+	proc << m_stdin;
+	proc << System::EoF;
+	m_stdin.clear();
+	m_out = proc.Captured(Process::Stream::STDOUT).data;
+	m_err = proc.Captured(Process::Stream::STDERR).data;
+	// -1 (also (DWORD)-1) means it did not exit normally
+	m_code = static_cast<int>(proc.Wait());
+
+	if (proc.State() == Process::Status::TERMINATED && m_code != -1)
+		m_cache->Insert(m_key, m_code, m_out, m_err);
+}
+
+std::string_view CachedProcess::Out() const noexcept {
+	return m_stored ? m_stored->Stdout() : std::string_view(m_out);
+}
+
+std::string_view CachedProcess::Err() const noexcept {
+	return m_stored ? m_stored->Stderr() : std::string_view(m_err);
+}
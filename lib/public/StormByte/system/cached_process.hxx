@@ -0,0 +1,197 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/process.hxx>
+#include <StormByte/system/result_cache.hxx>
+#include <StormByte/system/visibility.h>
+
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	class MurmurHash;	///< Forward declaration
+
+	/**
+	 * @class CachedProcess
+	 * @brief Deterministic command whose result is served from a @ref ResultCache.
+	 *
+	 * Same stream API as @ref Process (`<<` stdin, `<< EoF`, `>>` stdout,
+	 * `Stderr()`, `Wait()`), but nothing is spawned until stdin is closed (or
+	 * output is requested): the key hashes the resolved program (path, inode,
+	 * size and modification time), argv, the selected environment variables
+	 * and all of stdin with MurmurHash3 x64_128. A hit serves stdout, stderr
+	 * and the exit code from the store without spawning; a miss runs the
+	 * program, captures both streams and stores them. Runs killed by a signal
+	 * or a deadline are not stored. Chaining (`>>` to a Process) is not
+	 * supported.
+	 */
+	class STORMBYTE_SYSTEM_PUBLIC CachedProcess {
+		public:
+			/**
+			 * @param cache Store.
+			 * @param prog Executable path or name (looked up in PATH).
+			 * @param args Argument list (not including argv[0]).
+			 * @param keyed_env Environment variables whose values are part of the key.
+			 * @throw ExecutableNotFound if @p prog can not be resolved.
+			 */
+			CachedProcess(std::shared_ptr<ResultCache> cache, const std::filesystem::path& prog,
+				const std::vector<std::string>& args = std::vector<std::string>(),
+				const std::vector<std::string>& keyed_env = std::vector<std::string>());
+
+			/**
+			 * @param cache Store.
+			 * @param prog Executable path or name (looked up in PATH).
+			 * @param args Argument list (not including argv[0]).
+			 * @param keyed_env Environment variables whose values (read from
+			 * Process::Options::environment when set) are part of the key.
+			 * @param opts Spawn options used on a miss.
+			 * @throw ExecutableNotFound if @p prog can not be resolved.
+			 */
+			CachedProcess(std::shared_ptr<ResultCache> cache, const std::filesystem::path& prog,
+				const std::vector<std::string>& args, const std::vector<std::string>& keyed_env, const Process::Options& opts);
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			CachedProcess(const CachedProcess&) = delete;
+
+			/**
+			 * Move constructor.
+			 */
+			CachedProcess(CachedProcess&&) noexcept;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			CachedProcess& operator=(const CachedProcess&) = delete;
+
+			/**
+			 * Move assignment.
+			 */
+			CachedProcess& operator=(CachedProcess&&) noexcept;
+
+			/**
+			 * Destructor.
+			 */
+			~CachedProcess() noexcept;
+
+			/**
+			 * Appends to stdin (ignored once stdin is closed).
+			 * @param str Data.
+			 * @return Reference to this.
+			 */
+			CachedProcess& operator<<(const std::string& str);
+
+			/**
+			 * Closes stdin and resolves the result (lookup, or run and store).
+			 * @param eof EoF sentinel.
+			 */
+			void operator<<(const System::_EoF& eof);
+
+			/**
+			 * Reads remaining stdout (closing stdin first if still open).
+			 * @param str Destination, appended to.
+			 * @return Reference to @p str.
+			 */
+			std::string& operator>>(std::string& str);
+
+			/**
+			 * Reads remaining stderr (closing stdin first if still open).
+			 * @param str Destination, appended to.
+			 * @return Reference to @p str.
+			 */
+			std::string& Stderr(std::string& str);
+
+			#ifdef UNIX
+			/**
+			 * Closes stdin if still open and returns the exit code.
+			 * @return Exit code, or -1 if the run failed.
+			 */
+			int Wait();
+			#else
+			/**
+			 * Closes stdin if still open and returns the exit code.
+			 * @return Exit code, or (DWORD)-1 if the run failed.
+			 */
+			DWORD Wait();
+			#endif
+
+			/**
+			 * @return true if the result came from the store (false until resolved).
+			 */
+			bool Hit() const noexcept;
+
+			/**
+			 * @return Key (closes stdin if still open).
+			 */
+			CacheKey Key();
+
+			/**
+			 * Streams remaining stdout to an ostream.
+			 */
+			friend STORMBYTE_SYSTEM_PUBLIC std::ostream& operator<<(std::ostream& ostream, CachedProcess& proc);
+
+		private:
+			std::shared_ptr<ResultCache> m_cache;		///< Store
+			std::filesystem::path m_program;			///< Resolved program
+			std::vector<std::string> m_arguments;		///< Arguments
+			Process::Options m_options;					///< Spawn options
+			std::unique_ptr<MurmurHash> m_hash;			///< Key state
+			std::string m_stdin;						///< Buffered stdin (replayed on a miss)
+			bool m_resolved;							///< Result known
+			bool m_hit;									///< Served from the store
+			CacheKey m_key;								///< Key (once resolved)
+			int m_code;									///< Exit code
+			std::optional<CachedResult> m_stored;		///< Hit result
+			std::string m_out;							///< Miss stdout
+			std::string m_err;							///< Miss stderr
+			bool m_out_read;							///< stdout already handed out
+			bool m_err_read;							///< stderr already handed out
+
+			/**
+			 * Closes stdin and resolves the result, once.
+			 */
+			void Resolve();
+
+			/**
+			 * @return Standard output of the result.
+			 */
+			std::string_view Out() const noexcept;
+
+			/**
+			 * @return Standard error of the result.
+			 */
+			std::string_view Err() const noexcept;
+	};
+
+	/**
+	 * Streams remaining stdout of a cached process to an ostream.
+	 */
+	STORMBYTE_SYSTEM_PUBLIC std::ostream& operator<<(std::ostream& ostream, CachedProcess& proc);
+}
@@ -0,0 +1,37 @@
+#include <StormByte/system/capture.hxx>
+#include <StormByte/system/mapped_file.hxx>
+
+using namespace StormByte::System;
+
+CapturePolicy CapturePolicy::Full() noexcept {
+	return CapturePolicy { Mode::FULL, 0, 0 };
+}
+
+CapturePolicy CapturePolicy::Head(size_t bytes) noexcept {
+	return CapturePolicy { Mode::HEAD, bytes, 0 };
+}
+
+CapturePolicy CapturePolicy::Tail(size_t bytes) noexcept {
+	return CapturePolicy { Mode::TAIL, 0, bytes };
+}
+
+CapturePolicy CapturePolicy::HeadTail(size_t head, size_t tail) noexcept {
+	return CapturePolicy { Mode::HEAD_TAIL, head, tail };
+}
+
+CapturePolicy CapturePolicy::Discard() noexcept {
+	return CapturePolicy { Mode::DISCARD, 0, 0 };
+}
+
+std::string_view MappedOutput::View() const noexcept {
+	return m_file ? m_file->View() : std::string_view();
+}
+
+std::span<const char> MappedOutput::Span() const noexcept {
+	const std::string_view view = View();
+	return std::span<const char>(view.data(), view.size());
+}
+
+size_t MappedOutput::Size() const noexcept {
+	return View().size();
+}
@@ -0,0 +1,130 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	class MappedFile;	///< Forward declaration
+
+	/**
+	 * @struct CapturePolicy
+	 * @brief What to keep of a captured stream (see Process::Capture()).
+	 *
+	 * Memory is bounded by the policy however much the child writes; only
+	 * FULL grows with the output.
+	 */
+	struct STORMBYTE_SYSTEM_PUBLIC CapturePolicy {
+		/**
+		 * @enum Mode
+		 * @brief Capture mode.
+		 */
+		enum class Mode: unsigned short {
+			FULL,		///< Everything
+			HEAD,		///< First @ref head bytes
+			TAIL,		///< Last @ref tail bytes (fixed ring buffer)
+			HEAD_TAIL,	///< First @ref head and last @ref tail bytes, joined by a truncation marker
+			DISCARD		///< Nothing, only the byte count
+		};
+
+		Mode mode = Mode::FULL;		///< Mode
+		size_t head = 0;			///< Bytes kept from the start
+		size_t tail = 0;			///< Bytes kept from the end
+
+		/**
+		 * @return Policy keeping everything.
+		 */
+		static CapturePolicy Full() noexcept;
+
+		/**
+		 * @param bytes Bytes kept.
+		 * @return Policy keeping the first @p bytes.
+		 */
+		static CapturePolicy Head(size_t bytes) noexcept;
+
+		/**
+		 * @param bytes Bytes kept.
+		 * @return Policy keeping the last @p bytes.
+		 */
+		static CapturePolicy Tail(size_t bytes) noexcept;
+
+		/**
+		 * @param head Bytes kept from the start.
+		 * @param tail Bytes kept from the end.
+		 * @return Policy keeping both ends.
+		 */
+		static CapturePolicy HeadTail(size_t head, size_t tail) noexcept;
+
+		/**
+		 * @return Policy only counting bytes.
+		 */
+		static CapturePolicy Discard() noexcept;
+	};
+
+	/**
+	 * @struct CaptureResult
+	 * @brief Outcome of a capture.
+	 */
+	struct STORMBYTE_SYSTEM_PUBLIC CaptureResult {
+		std::string data;			///< Kept bytes (with the marker for HEAD_TAIL)
+		uint64_t total = 0;			///< Bytes written by the child
+		bool truncated = false;		///< Some bytes were not kept
+	};
+
+	/**
+	 * @class MappedOutput
+	 * @brief Output a child wrote to memory, mapped read-only (see Process::Mapped()).
+	 *
+	 * Copies share the mapping, which stays valid after the process object is gone.
+	 */
+	class STORMBYTE_SYSTEM_PUBLIC MappedOutput {
+		public:
+			/**
+			 * @return Output (valid while a copy of this object lives).
+			 */
+			std::string_view View() const noexcept;
+
+			/**
+			 * @return Output as bytes (valid while a copy of this object lives).
+			 */
+			std::span<const char> Span() const noexcept;
+
+			/**
+			 * @return Output size.
+			 */
+			size_t Size() const noexcept;
+
+		private:
+			friend class Process;
+
+			std::shared_ptr<const MappedFile> m_file;	///< Backing mapping (empty if nothing was mapped)
+	};
+}
@@ -0,0 +1,309 @@
+#include <StormByte/system/command.hxx>
+#include <StormByte/system/exception.hxx>
+#include <StormByte/system/latency_histogram.hxx>
+
+#include <string_view>
+
+#ifdef UNIX
+#include <cstdlib>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace StormByte::System;
+
+namespace {
+	constexpr const std::string_view MARKER = Command::PLACEHOLDER;
+	#ifdef UNIX
+	// Same default execvp uses when PATH is unset
+	constexpr const char* DEFAULT_SEARCH_PATH = "/bin:/usr/bin";
+
+	bool IsExecutable(const std::string& candidate, struct stat& st) noexcept {
+		return stat(candidate.c_str(), &st) == 0 && S_ISREG(st.st_mode) && access(candidate.c_str(), X_OK) == 0;
+	}
+	#endif
+
+	size_t CountPlaceholders(const std::string& arg) noexcept {
+		size_t count = 0;
+		for (size_t pos = arg.find(MARKER); pos != std::string::npos; pos = arg.find(MARKER, pos + MARKER.size()))
+			count++;
+		return count;
+	}
+}
+
+Command::Block::Block(): pointers { nullptr } {}
+
+Command::Block::Block(const Block& block): data(block.data), pointers(block.pointers) {
+	Rebase(block.data.data());
+}
+
+Command::Block::Block(Block&& block) noexcept {
+	const char* base = block.data.data();
+	data = std::move(block.data);
+	pointers = std::move(block.pointers);
+	Rebase(base);
+	block.pointers = { nullptr };
+}
+
+Command::Block& Command::Block::operator=(const Block& block) {
+	if (this != &block) {
+		data = block.data;
+		pointers = block.pointers;
+		Rebase(block.data.data());
+	}
+	return *this;
+}
+
+Command::Block& Command::Block::operator=(Block&& block) noexcept {
+	if (this != &block) {
+		const char* base = block.data.data();
+		data = std::move(block.data);
+		pointers = std::move(block.pointers);
+		Rebase(base);
+		block.pointers = { nullptr };
+	}
+	return *this;
+}
+
+void Command::Block::Pack(const std::vector<std::string>& items) {
+	size_t size = 0;
+	for (const std::string& item: items)
+		size += item.size() + 1;
+	data.clear();
+	data.reserve(size);
+	for (const std::string& item: items)
+		data.append(item.c_str(), item.size() + 1);
+
+	pointers.clear();
+	pointers.reserve(items.size() + 1);
+	size_t offset = 0;
+	for (const std::string& item: items) {
+		pointers.push_back(data.data() + offset);
+		offset += item.size() + 1;
+	}
+	pointers.push_back(nullptr);
+}
+
+void Command::Block::Rebase(const char* base) noexcept {
+	for (char*& pointer: pointers) {
+		if (pointer)
+			pointer = data.data() + (pointer - base);
+	}
+}
+
+Command::Command(const std::filesystem::path& prog, const std::vector<std::string>& args):
+	m_program(prog), m_arguments(args), m_placeholders(0), m_latency(std::make_shared<LatencyProfile>())
+	#ifdef UNIX
+	, m_device(0), m_inode(0)
+	#endif
+	{
+	Prepare();
+}
+
+Command::Command(const std::filesystem::path& prog, const std::vector<std::string>& args, const std::vector<std::string>& env):
+	Command(prog, args, Environment(env)) {}
+
+Command::Command(const std::filesystem::path& prog, const std::vector<std::string>& args, const Environment& env):
+	m_program(prog), m_arguments(args), m_placeholders(0), m_environment(env), m_latency(std::make_shared<LatencyProfile>())
+	#ifdef UNIX
+	, m_device(0), m_inode(0)
+	#endif
+	{
+	Prepare();
+}
+
+Command::Command(const Command& cmd):
+	m_program(cmd.m_program), m_arguments(cmd.m_arguments), m_placeholders(cmd.m_placeholders),
+	m_argv(cmd.m_argv), m_environment(cmd.m_environment), m_latency(cmd.m_latency) {
+	std::lock_guard<std::mutex> lock(cmd.m_mutex);
+	m_resolved = cmd.m_resolved;
+	#ifdef UNIX
+	m_search_path = cmd.m_search_path;
+	m_device = cmd.m_device;
+	m_inode = cmd.m_inode;
+	#endif
+}
+
+Command::Command(Command&& cmd) noexcept:
+	m_program(std::move(cmd.m_program)), m_arguments(std::move(cmd.m_arguments)), m_placeholders(cmd.m_placeholders),
+	m_argv(std::move(cmd.m_argv)), m_environment(std::move(cmd.m_environment)), m_latency(cmd.m_latency) {
+	std::lock_guard<std::mutex> lock(cmd.m_mutex);
+	m_resolved = std::move(cmd.m_resolved);
+	#ifdef UNIX
+	m_search_path = std::move(cmd.m_search_path);
+	m_device = cmd.m_device;
+	m_inode = cmd.m_inode;
+	#endif
+}
+
+Command& Command::operator=(const Command& cmd) {
+	if (this != &cmd) {
+		std::scoped_lock lock(m_mutex, cmd.m_mutex);
+		m_program = cmd.m_program;
+		m_arguments = cmd.m_arguments;
+		m_placeholders = cmd.m_placeholders;
+		m_argv = cmd.m_argv;
+		m_environment = cmd.m_environment;
+		m_latency = cmd.m_latency;
+		m_resolved = cmd.m_resolved;
+		#ifdef UNIX
+		m_search_path = cmd.m_search_path;
+		m_device = cmd.m_device;
+		m_inode = cmd.m_inode;
+		#endif
+	}
+	return *this;
+}
+
+Command& Command::operator=(Command&& cmd) noexcept {
+	if (this != &cmd) {
+		std::scoped_lock lock(m_mutex, cmd.m_mutex);
+		m_program = std::move(cmd.m_program);
+		m_arguments = std::move(cmd.m_arguments);
+		m_placeholders = cmd.m_placeholders;
+		m_argv = std::move(cmd.m_argv);
+		m_environment = std::move(cmd.m_environment);
+		m_latency = cmd.m_latency;
+		m_resolved = std::move(cmd.m_resolved);
+		#ifdef UNIX
+		m_search_path = std::move(cmd.m_search_path);
+		m_device = cmd.m_device;
+		m_inode = cmd.m_inode;
+		#endif
+	}
+	return *this;
+}
+
+const std::filesystem::path& Command::Program() const noexcept {
+	return m_program;
+}
+
+const std::vector<std::string>& Command::Arguments() const noexcept {
+	return m_arguments;
+}
+
+size_t Command::Placeholders() const noexcept {
+	return m_placeholders;
+}
+
+Command Command::Append(const std::string& arg) const {
+	Command cmd(*this);
+	cmd.m_arguments.push_back(arg);
+	cmd.m_placeholders = 0;
+	// A different invocation: its latencies are its own
+	cmd.m_latency = std::make_shared<LatencyProfile>();
+	cmd.Prepare();
+	return cmd;
+}
+
+std::filesystem::path Command::Resolve() const {
+#ifdef UNIX
+	// The child gets the command environment, so its PATH decides
+	if (m_environment)
+		return Resolve(*m_environment);
+	const char* env_path = std::getenv("PATH");
+	return Search(env_path ? env_path : DEFAULT_SEARCH_PATH);
+#else
+	// CreateProcess performs its own search
+	return m_program;
+#endif
+}
+
+std::filesystem::path Command::Resolve(const Environment& env) const {
+#ifdef UNIX
+	return Search(env.Get("PATH").value_or(DEFAULT_SEARCH_PATH));
+#else
+	(void)env;
+	return m_program;
+#endif
+}
+
+#ifdef UNIX
+std::filesystem::path Command::Search(std::string_view search_path) const {
+	struct stat st;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (!m_resolved.empty() && search_path == m_search_path &&
+		stat(m_resolved.c_str(), &st) == 0 && st.st_dev == m_device && st.st_ino == m_inode)
+		return m_resolved;
+
+	m_resolved.clear();
+	const std::string& program = m_program.native();
+	if (program.find('/') != std::string::npos) {
+		if (IsExecutable(program, st))
+			m_resolved = m_program;
+	} else {
+		// Empty PATH entries mean the current directory, as with execvp
+		size_t start = 0;
+		for (;;) {
+			const size_t end = search_path.find(':', start);
+			std::string candidate(search_path.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start));
+			candidate = (candidate.empty() ? "." : candidate) + "/" + program;
+			if (IsExecutable(candidate, st)) {
+				m_resolved = std::move(candidate);
+				break;
+			}
+			if (end == std::string_view::npos)
+				break;
+			start = end + 1;
+		}
+	}
+	if (m_resolved.empty())
+		throw ExecutableNotFound(m_program);
+
+	m_search_path = search_path;
+	m_device = st.st_dev;
+	m_inode = st.st_ino;
+	return m_resolved;
+}
+#endif
+
+std::vector<std::string> Command::Arguments(const std::vector<std::string>& subst) const {
+	if (subst.size() != m_placeholders)
+		throw Exception("Command " + m_program.string() + " expects " + std::to_string(m_placeholders) +
+			" substitutions, got " + std::to_string(subst.size()));
+
+	std::vector<std::string> args;
+	args.reserve(m_arguments.size());
+	size_t next = 0;
+	for (const std::string& arg: m_arguments) {
+		std::string& out = args.emplace_back();
+		size_t start = 0, pos;
+		while ((pos = arg.find(MARKER, start)) != std::string::npos) {
+			out.append(arg, start, pos - start);
+			out.append(subst[next++]);
+			start = pos + MARKER.size();
+		}
+		out.append(arg, start, std::string::npos);
+	}
+	return args;
+}
+
+void Command::Prepare() {
+	std::vector<std::string> argv;
+	argv.reserve(m_arguments.size() + 1);
+	argv.push_back(m_program.string());
+	for (const std::string& arg: m_arguments) {
+		m_placeholders += CountPlaceholders(arg);
+		argv.push_back(arg);
+	}
+	m_argv.Pack(argv);
+}
+
+char* const* Command::Argv(const std::vector<std::string>& subst, Block& storage) const {
+	if (m_placeholders == 0 && subst.empty())
+		return m_argv.pointers.data();
+
+	std::vector<std::string> argv = Arguments(subst);
+	argv.insert(argv.begin(), m_program.string());
+	storage.Pack(argv);
+	return storage.pointers.data();
+}
+
+char* const* Command::Envp() const {
+	#ifdef UNIX
+	return m_environment ? m_environment->Envp() : nullptr;
+	#else
+	return nullptr;
+	#endif
+}
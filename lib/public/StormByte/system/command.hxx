@@ -0,0 +1,256 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/environment.hxx>
+#include <StormByte/system/visibility.h>
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#ifdef UNIX
+#include <sys/types.h>
+#endif
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	struct LatencyProfile;	///< Forward declaration
+
+	/**
+	 * @class Command
+	 * @brief Prepared program invocation for repeated spawns.
+	 *
+	 * The executable is looked up in `PATH` (of the child environment, as a
+	 * shell would) once and cached; the cache is revalidated on each spawn
+	 * with a single `stat()` and dropped when that `PATH` changes or the
+	 * resolved file is replaced (different inode). The argv
+	 * block is packed once at construction (an optional @ref Environment
+	 * keeps its own prebuilt envp), so spawning
+	 * `Process(command)` allocates nothing in the child and execs the resolved
+	 * path directly with `execv`/`execve`.
+	 *
+	 * Arguments may contain @ref PLACEHOLDER; each occurrence is replaced, in
+	 * order, by the substitutions passed to `Process(command, substitutions)`.
+	 *
+	 * Copies share the latency distribution recorded by @ref HedgedProcess runs.
+	 */
+	class STORMBYTE_SYSTEM_PUBLIC Command {
+		public:
+			/**
+			 * Placeholder replaced by per-spawn substitutions.
+			 */
+			static constexpr const char* PLACEHOLDER = "{}";
+
+			/**
+			 * @param prog Executable path or name (looked up in PATH if it has no '/').
+			 * @param args Argument list (not including argv[0]).
+			 */
+			explicit Command(const std::filesystem::path& prog, const std::vector<std::string>& args = std::vector<std::string>());
+
+			/**
+			 * @param prog Executable path or name (looked up in PATH if it has no '/').
+			 * @param args Argument list (not including argv[0]).
+			 * @param env Complete child environment as `NAME=value` entries.
+			 */
+			Command(const std::filesystem::path& prog, const std::vector<std::string>& args, const std::vector<std::string>& env);
+
+			/**
+			 * @param prog Executable path or name (looked up in PATH if it has no '/').
+			 * @param args Argument list (not including argv[0]).
+			 * @param env Complete child environment (shared, its envp is reused by every spawn).
+			 */
+			Command(const std::filesystem::path& prog, const std::vector<std::string>& args, const Environment& env);
+
+			/**
+			 * Copy constructor.
+			 */
+			Command(const Command& cmd);
+
+			/**
+			 * Move constructor.
+			 */
+			Command(Command&& cmd) noexcept;
+
+			/**
+			 * Copy assignment.
+			 */
+			Command& operator=(const Command& cmd);
+
+			/**
+			 * Move assignment.
+			 */
+			Command& operator=(Command&& cmd) noexcept;
+
+			/**
+			 * Destructor.
+			 */
+			~Command() noexcept = default;
+
+			/**
+			 * @return Program as given.
+			 */
+			const std::filesystem::path& Program() const noexcept;
+
+			/**
+			 * @return Argument templates.
+			 */
+			const std::vector<std::string>& Arguments() const noexcept;
+
+			/**
+			 * @return Number of placeholders to substitute per spawn.
+			 */
+			size_t Placeholders() const noexcept;
+
+			/**
+			 * @param arg Argument (may contain placeholders).
+			 * @return Copy of this command with @p arg appended.
+			 */
+			Command Append(const std::string& arg) const;
+
+			/**
+			 * Resolves the executable, reusing the cached result while valid.
+			 * `PATH` is taken from the command environment if it has one, from
+			 * the parent otherwise.
+			 * @return Path that will be executed.
+			 * @throw ExecutableNotFound if no executable matches.
+			 */
+			std::filesystem::path Resolve() const;
+
+			/**
+			 * Resolves the executable against the `PATH` of @p env (the child
+			 * environment when `Process::Options::environment` replaces the command one).
+			 * @param env Environment.
+			 * @return Path that will be executed.
+			 * @throw ExecutableNotFound if no executable matches.
+			 */
+			std::filesystem::path Resolve(const Environment& env) const;
+
+			/**
+			 * @param subst Substitutions, one per placeholder.
+			 * @return Arguments with placeholders replaced.
+			 * @throw Exception if the substitution count does not match.
+			 */
+			std::vector<std::string> Arguments(const std::vector<std::string>& subst) const;
+
+		private:
+			friend class HedgedProcess;
+			friend class Process;
+
+			/**
+			 * @struct Block
+			 * @brief Contiguous NUL-separated strings plus a null-terminated pointer array.
+			 */
+			struct Block {
+				std::string data;					///< Packed strings
+				std::vector<char*> pointers;		///< Pointers into data, null-terminated
+
+				/**
+				 * Default constructor (empty, pointers hold only the terminator).
+				 */
+				Block();
+
+				/**
+				 * Copy constructor (pointers rebased onto the copy).
+				 */
+				Block(const Block& block);
+
+				/**
+				 * Move constructor (pointers rebased onto the moved data).
+				 */
+				Block(Block&& block) noexcept;
+
+				/**
+				 * Copy assignment (pointers rebased onto the copy).
+				 */
+				Block& operator=(const Block& block);
+
+				/**
+				 * Move assignment (pointers rebased onto the moved data).
+				 */
+				Block& operator=(Block&& block) noexcept;
+
+				/**
+				 * Destructor.
+				 */
+				~Block() noexcept = default;
+
+				/**
+				 * Packs @p items.
+				 * @param items Strings.
+				 */
+				void Pack(const std::vector<std::string>& items);
+
+				/**
+				 * Repoints @ref pointers from @p base to @ref data.
+				 * @param base Address previously holding the packed strings.
+				 */
+				void Rebase(const char* base) noexcept;
+			};
+
+			std::filesystem::path m_program;		///< Program as given
+			std::vector<std::string> m_arguments;	///< Argument templates
+			size_t m_placeholders;					///< Placeholder count
+			Block m_argv;							///< Prebuilt argv (no substitutions)
+			std::optional<Environment> m_environment;	///< Custom environment
+			std::shared_ptr<LatencyProfile> m_latency;	///< Run latencies (shared by copies)
+			mutable std::mutex m_mutex;				///< Protects the resolution cache
+			mutable std::filesystem::path m_resolved;	///< Cached resolution
+			#ifdef UNIX
+			mutable std::string m_search_path;		///< PATH used for m_resolved
+			mutable dev_t m_device;					///< Resolved file device
+			mutable ino_t m_inode;					///< Resolved file inode
+			#endif
+
+			/**
+			 * Counts placeholders and packs argv.
+			 */
+			void Prepare();
+
+			#ifdef UNIX
+			/**
+			 * Resolves the executable in @p search_path, reusing the cached result
+			 * while it was found in the same search path and is still the same file.
+			 * @param search_path Colon separated directories.
+			 * @return Path that will be executed.
+			 * @throw ExecutableNotFound if no executable matches.
+			 */
+			std::filesystem::path Search(std::string_view search_path) const;
+			#endif
+
+			/**
+			 * Builds argv for a spawn.
+			 * @param subst Substitutions.
+			 * @param storage Used when substitutions are needed.
+			 * @return Null-terminated argv (prebuilt one when there are no placeholders).
+			 */
+			char* const* Argv(const std::vector<std::string>& subst, Block& storage) const;
+
+			/**
+			 * @return Null-terminated envp, or nullptr to inherit the parent environment (always on Windows).
+			 */
+			char* const* Envp() const;
+	};
+}
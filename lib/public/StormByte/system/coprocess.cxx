@@ -0,0 +1,218 @@
+#include <StormByte/system/coprocess.hxx>
+#include <StormByte/system/exception.hxx>
+#include <StormByte/system/pipe.hxx>
+#include <StormByte/system/process.hxx>
+
+#ifdef UNIX
+#include <cerrno>
+#include <signal.h>
+#endif
+
+using namespace StormByte::System;
+
+namespace {
+	constexpr const size_t READ_CHUNK = 64 * 1024;
+
+	// Blocking read of up to buffer.size() bytes: > 0 data, 0 EOF, < 0 retry
+	long ReadSome(const Pipe& pipe, std::vector<char>& buffer) {
+		#ifdef UNIX
+		const ssize_t bytes = pipe.Read(buffer, static_cast<ssize_t>(buffer.size()));
+		if (bytes < 0)
+			return errno == EINTR ? -1 : 0;
+		return static_cast<long>(bytes);
+		#else
+		return static_cast<long>(pipe.Read(buffer, static_cast<DWORD>(buffer.size())));
+		#endif
+	}
+}
+
+Coprocess::Coprocess(const std::filesystem::path& prog, const std::vector<std::string>& args):
+	Coprocess(prog, args, Options()) {}
+
+Coprocess::Coprocess(const std::filesystem::path& prog, const std::vector<std::string>& args, const Options& opts):
+	m_program(prog), m_arguments(args), m_options(opts),
+	m_restarts(0), m_closing(false), m_failed(false), m_done(false) {
+	if (m_options.max_batch == 0)
+		m_options.max_batch = 1;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Spawn();
+	}
+	m_writer = std::thread(&Coprocess::WriteLoop, this);
+	m_reader = std::thread(&Coprocess::ReadLoop, this);
+}
+
+Coprocess::~Coprocess() noexcept {
+	Close();
+}
+
+std::future<std::string> Coprocess::Submit(std::string request) {
+	Request req { std::move(request), std::promise<std::string>() };
+	std::future<std::string> future = req.response.get_future();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_failed || m_closing) {
+		req.response.set_exception(std::make_exception_ptr(Exception("Coprocess " + m_program.string() + " is not accepting requests")));
+		return future;
+	}
+	m_queue.push_back(std::move(req));
+	m_cv.notify_all();
+	return future;
+}
+
+void Coprocess::Close() noexcept {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_closing = true;
+		m_cv.notify_all();
+	}
+	if (m_writer.joinable())
+		m_writer.join();
+	if (m_reader.joinable())
+		m_reader.join();
+}
+
+unsigned int Coprocess::Restarts() const noexcept {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_restarts;
+}
+
+void Coprocess::Spawn() {
+	m_process = std::make_shared<Process>(m_program, m_arguments);
+	m_stderr = std::thread([proc = m_process, handler = m_options.on_stderr] {
+		std::vector<char> buffer(READ_CHUNK);
+		long bytes;
+		while ((bytes = ReadSome(*proc->m_pstderr, buffer)) != 0) {
+			if (bytes > 0 && handler)
+				handler(std::string_view(buffer.data(), static_cast<size_t>(bytes)));
+		}
+	});
+}
+
+void Coprocess::WriteLoop() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	std::shared_ptr<Process> stdin_closed;	// Child whose stdin was already closed
+	for (;;) {
+		m_cv.wait(lock, [this, &stdin_closed] {
+			return m_done || m_failed ||
+				(m_process && (!m_queue.empty() || (m_closing && m_process != stdin_closed)));
+		});
+		if (m_done || m_failed)
+			return;
+
+		std::shared_ptr<Process> proc = m_process;
+		if (m_queue.empty()) {
+			// Closing and everything was written: let the child finish
+			stdin_closed = proc;
+			lock.unlock();
+			*proc << System::EoF;
+			lock.lock();
+			continue;
+		}
+
+		// Requests become in-flight before writing so the reader can match them
+		std::string batch;
+		for (size_t i = 0; i < m_options.max_batch && !m_queue.empty(); i++) {
+			batch.append(m_queue.front().payload);
+			batch.push_back(m_options.delimiter);
+			m_inflight.push_back(std::move(m_queue.front()));
+			m_queue.pop_front();
+		}
+		lock.unlock();
+		// A failed write means the child died: the reader sees EOF and recovers
+		(void)proc->m_pstdin->WriteAtomic(std::move(batch));
+		lock.lock();
+	}
+}
+
+void Coprocess::ReadLoop() {
+	std::vector<char> buffer(READ_CHUNK);
+	std::string pending;
+	for (;;) {
+		std::shared_ptr<Process> proc;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			proc = m_process;
+		}
+		const long bytes = ReadSome(*proc->m_pstdout, buffer);
+		if (bytes < 0)
+			continue;
+		if (bytes == 0) {
+			pending.clear();
+			proc.reset();
+			if (!Recover())
+				return;
+			continue;
+		}
+
+		pending.append(buffer.data(), static_cast<size_t>(bytes));
+		size_t start = 0, pos;
+		std::lock_guard<std::mutex> lock(m_mutex);
+		while ((pos = pending.find(m_options.delimiter, start)) != std::string::npos) {
+			// Unsolicited output (nothing in flight) is dropped
+			if (!m_inflight.empty()) {
+				m_inflight.front().response.set_value(pending.substr(start, pos - start));
+				m_inflight.pop_front();
+			}
+			start = pos + 1;
+		}
+		pending.erase(0, start);
+	}
+}
+
+bool Coprocess::Recover() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	std::shared_ptr<Process> old = std::move(m_process);
+	std::thread old_stderr = std::move(m_stderr);
+	lock.unlock();
+
+	// The child closed stdout; make sure it is gone so a blocked writer gets EPIPE
+	#ifdef UNIX
+	if (old->m_pid > 0)
+		::kill(old->m_pid, SIGKILL);
+	#else
+	if (old->m_piProcInfo.hProcess != nullptr)
+		TerminateProcess(old->m_piProcInfo.hProcess, 1);
+	#endif
+	old->Wait();
+	if (old_stderr.joinable())
+		old_stderr.join();
+	old.reset();
+
+	lock.lock();
+	if (m_closing && m_queue.empty() && m_inflight.empty()) {
+		m_done = true;
+		m_cv.notify_all();
+		return false;
+	}
+	if (m_restarts >= m_options.max_restarts) {
+		FailAll("Coprocess " + m_program.string() + " exceeded " + std::to_string(m_options.max_restarts) + " restarts");
+		return false;
+	}
+
+	m_restarts++;
+	// Unanswered requests go out again, ahead of newer ones and in original order
+	while (!m_inflight.empty()) {
+		m_queue.push_front(std::move(m_inflight.back()));
+		m_inflight.pop_back();
+	}
+	try {
+		Spawn();
+	} catch (const std::exception& e) {
+		FailAll(e.what());
+		return false;
+	}
+	m_cv.notify_all();
+	return true;
+}
+
+void Coprocess::FailAll(const std::string& reason) {
+	m_failed = true;
+	m_done = true;
+	for (std::deque<Request>* requests: { &m_inflight, &m_queue }) {
+		for (Request& req: *requests)
+			req.response.set_exception(std::make_exception_ptr(Exception(reason)));
+		requests->clear();
+	}
+	m_cv.notify_all();
+}
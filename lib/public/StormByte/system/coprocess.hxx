@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+ *
+ * This file is part of StormByte.
+ *
+ * StormByte is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * StormByte is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	class Process;	///< Forward declaration
+
+	/**
+	 * @class Coprocess
+	 * @brief Long-lived child serving delimited requests over stdin/stdout.
+	 *
+	 * Requests are queued and written in pipelined batches; responses are split on
+	 * the delimiter and matched to requests in FIFO order. If the child dies, it is
+	 * restarted (up to @ref Options::max_restarts times) and unanswered requests are
+	 * sent again, so the served program must be idempotent per request.
+	 * The served program must flush each response (unbuffered or line-buffered output).
+	 * Not copyable nor movable.
+	 * @note Requests must not contain the delimiter.
+	 */
+	class STORMBYTE_SYSTEM_PUBLIC Coprocess {
+		public:
+			/**
+			 * @struct Options
+			 * @brief Framing and recovery settings.
+			 */
+			struct Options {
+				char delimiter = '\n';									///< Request/response terminator
+				unsigned int max_restarts = 3;							///< Restarts allowed before failing
+				size_t max_batch = 64;									///< Requests coalesced per write
+				std::function<void(std::string_view)> on_stderr;		///< Receives child stderr (discarded if empty)
+			};
+
+			/**
+			 * @param prog Executable path or name.
+			 * @param args Argument list (not including argv[0]).
+			 * @throw ExecutableNotFound if the child can not be started.
+			 */
+			Coprocess(const std::filesystem::path& prog, const std::vector<std::string>& args = std::vector<std::string>());
+
+			/**
+			 * @param prog Executable path or name.
+			 * @param args Argument list (not including argv[0]).
+			 * @param opts Options.
+			 * @throw ExecutableNotFound if the child can not be started.
+			 */
+			Coprocess(const std::filesystem::path& prog, const std::vector<std::string>& args, const Options& opts);
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			Coprocess(const Coprocess&) = delete;
+
+			/**
+			 * Move constructor (deleted).
+			 */
+			Coprocess(Coprocess&&) = delete;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			Coprocess& operator=(const Coprocess&) = delete;
+
+			/**
+			 * Move assignment (deleted).
+			 */
+			Coprocess& operator=(Coprocess&&) = delete;
+
+			/**
+			 * Closes the session (see @ref Close()).
+			 */
+			~Coprocess() noexcept;
+
+			/**
+			 * Queues a request.
+			 * @param request Request without delimiter.
+			 * @return Future resolved with the response (without delimiter), or an
+			 * @ref Exception once the child can no longer be restarted.
+			 */
+			std::future<std::string> Submit(std::string request);
+
+			/**
+			 * Stops accepting requests, lets pending ones finish, closes the child
+			 * stdin and waits for it. Idempotent.
+			 */
+			void Close() noexcept;
+
+			/**
+			 * @return Times the child was restarted.
+			 */
+			unsigned int Restarts() const noexcept;
+
+		private:
+			/**
+			 * @struct Request
+			 * @brief Payload and its pending response.
+			 */
+			struct Request {
+				std::string payload;					///< Request data
+				std::promise<std::string> response;		///< Response promise
+			};
+
+			std::filesystem::path m_program;			///< Program path
+			std::vector<std::string> m_arguments;		///< Arguments
+			Options m_options;							///< Options
+			mutable std::mutex m_mutex;					///< Protects members below
+			std::condition_variable m_cv;				///< Signals queue / state changes
+			std::deque<Request> m_queue;				///< Not yet written
+			std::deque<Request> m_inflight;				///< Written, awaiting response
+			std::shared_ptr<Process> m_process;			///< Current child
+			std::thread m_stderr;						///< Current child stderr drain
+			unsigned int m_restarts;					///< Restart count
+			bool m_closing;								///< No more requests accepted
+			bool m_failed;								///< Restarts exhausted
+			bool m_done;								///< Reader finished
+			std::thread m_writer;						///< Batching writer
+			std::thread m_reader;						///< Response reader
+
+			/**
+			 * Spawns a child and its stderr drain (lock held).
+			 */
+			void Spawn();
+
+			/**
+			 * Writer loop.
+			 */
+			void WriteLoop();
+
+			/**
+			 * Reader loop.
+			 */
+			void ReadLoop();
+
+			/**
+			 * Handles child termination (restart or fail).
+			 * @return true if reading should continue with a new child.
+			 */
+			bool Recover();
+
+			/**
+			 * Fails every queued and in-flight request (lock held).
+			 * @param reason Error message.
+			 */
+			void FailAll(const std::string& reason);
+	};
+}
@@ -0,0 +1,249 @@
+#include <StormByte/system/environment.hxx>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef WINDOWS
+#include <StormByte/string.hxx>
+#include <windows.h>
+#else
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+using namespace StormByte::System;
+
+/**
+ * A full snapshot owns its packed entries; an overlay points at a full
+ * snapshot (never at another overlay) and lists its overrides.
+ */
+struct Environment::Snapshot {
+	std::shared_ptr<const Snapshot> base;							///< Base snapshot (overlays only)
+	std::string data;												///< Packed `NAME=value\0` entries (full only)
+	std::unordered_map<std::string_view, const char*> index;		///< Name to entry (full only)
+	std::vector<std::string> overrides;								///< `NAME=value`, or `NAME` when removed (overlays only)
+	size_t size = 0;												///< Variables
+	mutable std::once_flag built;									///< Guards the lazy blocks
+	mutable std::vector<char*> envp;								///< Null-terminated entry pointers
+	#ifdef WINDOWS
+	mutable std::wstring block;										///< CreateProcessW block
+	#endif
+};
+
+namespace {
+	std::string_view NameOf(std::string_view entry) noexcept {
+		return entry.substr(0, entry.find('='));
+	}
+
+	#ifdef WINDOWS
+	const wchar_t* EmptyBlock() noexcept {
+		static const wchar_t empty[] = { L'\0', L'\0' };
+		return empty;
+	}
+	#else
+	char* const* EmptyEnvp() noexcept {
+		static char* empty[] = { nullptr };
+		return empty;
+	}
+	#endif
+}
+
+Environment::Environment(): Environment(std::vector<std::string>()) {}
+
+Environment::Environment(const std::vector<std::string>& entries) {
+	// Last duplicate wins, but the first occurrence keeps its position
+	std::vector<std::string_view> kept;
+	std::unordered_map<std::string_view, size_t> position;
+	kept.reserve(entries.size());
+	for (const std::string& entry: entries) {
+		if (entry.find('=') == std::string::npos)
+			continue;
+		const auto [it, inserted] = position.emplace(NameOf(entry), kept.size());
+		if (inserted)
+			kept.push_back(entry);
+		else
+			kept[it->second] = entry;
+	}
+
+	std::shared_ptr<Snapshot> snapshot = std::make_shared<Snapshot>();
+	size_t bytes = 0;
+	for (const std::string_view entry: kept)
+		bytes += entry.size() + 1;
+	snapshot->data.reserve(bytes);
+	for (const std::string_view entry: kept) {
+		snapshot->data.append(entry);
+		snapshot->data.push_back('\0');
+	}
+
+	snapshot->envp.reserve(kept.size() + 1);
+	snapshot->index.reserve(kept.size());
+	char* cursor = snapshot->data.data();
+	for (const std::string_view entry: kept) {
+		snapshot->envp.push_back(cursor);
+		snapshot->index.emplace(NameOf(std::string_view(cursor, entry.size())), cursor);
+		cursor += entry.size() + 1;
+	}
+	snapshot->envp.push_back(nullptr);
+	snapshot->size = kept.size();
+	m_snapshot = std::move(snapshot);
+}
+
+Environment::Environment(std::shared_ptr<const Snapshot> snapshot) noexcept:
+	m_snapshot(std::move(snapshot)) {}
+
+Environment Environment::Current() {
+	std::vector<std::string> entries;
+#ifdef WINDOWS
+	wchar_t* strings = GetEnvironmentStringsW();
+	if (strings) {
+		for (const wchar_t* entry = strings; *entry; entry += wcslen(entry) + 1) {
+			// Hidden per-drive directories ("=C:=C:\...") are not variables
+			if (*entry != L'=')
+				entries.push_back(String::UTF8Encode(std::wstring(entry)));
+		}
+		FreeEnvironmentStringsW(strings);
+	}
+#else
+	for (char** entry = environ; entry && *entry; entry++)
+		entries.emplace_back(*entry);
+#endif
+	return Environment(entries);
+}
+
+std::optional<std::string_view> Environment::Get(std::string_view name) const noexcept {
+	if (!m_snapshot)
+		return std::nullopt;
+
+	const Snapshot* full = m_snapshot.get();
+	if (full->base) {
+		for (const std::string& entry: full->overrides) {
+			if (NameOf(entry) == name) {
+				if (entry.size() == name.size())
+					return std::nullopt;
+				return std::string_view(entry).substr(name.size() + 1);
+			}
+		}
+		full = full->base.get();
+	}
+	const auto it = full->index.find(name);
+	if (it == full->index.end())
+		return std::nullopt;
+	return std::string_view(it->second + name.size() + 1);
+}
+
+Environment Environment::Set(std::string_view name, std::string_view value) const {
+	std::string entry;
+	entry.reserve(name.size() + value.size() + 1);
+	entry.append(name).append(1, '=').append(value);
+	return Overlay(name, std::move(entry));
+}
+
+Environment Environment::Unset(std::string_view name) const {
+	return Overlay(name, std::string(name));
+}
+
+Environment Environment::Overlay(std::string_view name, std::string entry) const {
+	if (!m_snapshot)
+		return Environment().Overlay(name, std::move(entry));
+
+	std::shared_ptr<Snapshot> overlay = std::make_shared<Snapshot>();
+	overlay->base = m_snapshot->base ? m_snapshot->base : m_snapshot;
+	overlay->overrides.reserve(m_snapshot->overrides.size() + 1);
+	for (const std::string& existing: m_snapshot->overrides) {
+		if (NameOf(existing) != name)
+			overlay->overrides.push_back(existing);
+	}
+	overlay->overrides.push_back(std::move(entry));
+
+	// Size is derived from the base plus the effect of each override
+	overlay->size = overlay->base->size;
+	for (const std::string& current: overlay->overrides) {
+		const std::string_view current_name = NameOf(current);
+		const bool in_base = overlay->base->index.contains(current_name);
+		const bool present = current.size() != current_name.size();
+		if (present && !in_base)
+			overlay->size++;
+		else if (!present && in_base)
+			overlay->size--;
+	}
+	return Environment(std::shared_ptr<const Snapshot>(std::move(overlay)));
+}
+
+size_t Environment::Size() const noexcept {
+	return m_snapshot ? m_snapshot->size : 0;
+}
+
+std::vector<std::string> Environment::Entries() const {
+	std::vector<std::string> entries;
+	if (!m_snapshot)
+		return entries;
+
+	const Snapshot* full = m_snapshot->base ? m_snapshot->base.get() : m_snapshot.get();
+	entries.reserve(m_snapshot->size);
+	for (size_t i = 0; i < full->size; i++) {
+		const std::string_view entry = full->envp[i];
+		const std::string_view name = NameOf(entry);
+		const bool overridden = std::any_of(m_snapshot->overrides.begin(), m_snapshot->overrides.end(),
+			[name](const std::string& current) { return NameOf(current) == name; });
+		if (!overridden)
+			entries.emplace_back(entry);
+	}
+	for (const std::string& current: m_snapshot->overrides) {
+		if (current.size() != NameOf(current).size())
+			entries.push_back(current);
+	}
+	return entries;
+}
+
+#ifdef WINDOWS
+const wchar_t* Environment::Block() const {
+	if (!m_snapshot)
+		return EmptyBlock();
+
+	std::call_once(m_snapshot->built, [this] {
+		// CreateProcessW wants the entries sorted by name, case-insensitively
+		std::vector<std::wstring> entries;
+		for (const std::string& entry: Entries())
+			entries.push_back(String::UTF8Decode(entry));
+		std::sort(entries.begin(), entries.end(), [](const std::wstring& a, const std::wstring& b) {
+			return _wcsicmp(a.substr(0, a.find(L'=')).c_str(), b.substr(0, b.find(L'=')).c_str()) < 0;
+		});
+		for (const std::wstring& entry: entries)
+			m_snapshot->block.append(entry).push_back(L'\0');
+		// An empty block still needs both terminators
+		if (entries.empty())
+			m_snapshot->block.push_back(L'\0');
+		m_snapshot->block.push_back(L'\0');
+	});
+	return m_snapshot->block.c_str();
+}
+#else
+char* const* Environment::Envp() const {
+	if (!m_snapshot)
+		return EmptyEnvp();
+	if (!m_snapshot->base)
+		return m_snapshot->envp.data();
+
+	std::call_once(m_snapshot->built, [this] {
+		// Unchanged entries point into the base block; overrides into this overlay
+		const Snapshot& base = *m_snapshot->base;
+		std::vector<char*>& envp = m_snapshot->envp;
+		envp.reserve(m_snapshot->size + 1);
+		for (size_t i = 0; i < base.size; i++) {
+			const std::string_view name = NameOf(base.envp[i]);
+			const bool overridden = std::any_of(m_snapshot->overrides.begin(), m_snapshot->overrides.end(),
+				[name](const std::string& current) { return NameOf(current) == name; });
+			if (!overridden)
+				envp.push_back(base.envp[i]);
+		}
+		for (const std::string& current: m_snapshot->overrides) {
+			if (current.size() != NameOf(current).size())
+				envp.push_back(const_cast<char*>(current.c_str()));
+		}
+		envp.push_back(nullptr);
+	});
+	return m_snapshot->envp.data();
+}
+#endif
@@ -0,0 +1,151 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	/**
+	 * @class Environment
+	 * @brief Immutable, shared environment snapshot for spawned processes.
+	 *
+	 * Copies share one reference-counted snapshot. A full snapshot packs its
+	 * `NAME=value` entries into one contiguous block with a prebuilt envp.
+	 * @ref Set() and @ref Unset() return overlays that share the base
+	 * snapshot and only copy the overrides, so deriving from a large base is
+	 * O(overrides); an overlay builds its envp once, on the first spawn, and
+	 * reuses it afterwards. Spawns never build the environment per call.
+	 *
+	 * Names are compared exactly (also on Windows).
+	 */
+	class STORMBYTE_SYSTEM_PUBLIC Environment {
+		public:
+			/**
+			 * Empty environment.
+			 */
+			Environment();
+
+			/**
+			 * @param entries `NAME=value` entries; later duplicates win, entries without '=' are ignored.
+			 */
+			explicit Environment(const std::vector<std::string>& entries);
+
+			/**
+			 * Copy constructor (shares the snapshot).
+			 */
+			Environment(const Environment&) = default;
+
+			/**
+			 * Move constructor.
+			 */
+			Environment(Environment&&) noexcept = default;
+
+			/**
+			 * Copy assignment (shares the snapshot).
+			 */
+			Environment& operator=(const Environment&) = default;
+
+			/**
+			 * Move assignment.
+			 */
+			Environment& operator=(Environment&&) noexcept = default;
+
+			/**
+			 * Destructor.
+			 */
+			~Environment() noexcept = default;
+
+			/**
+			 * @return Snapshot of the calling process environment.
+			 */
+			static Environment Current();
+
+			/**
+			 * @param name Variable name.
+			 * @return Value of @p name (valid while this snapshot lives), if set.
+			 */
+			std::optional<std::string_view> Get(std::string_view name) const noexcept;
+
+			/**
+			 * @param name Variable name.
+			 * @param value Value.
+			 * @return Overlay with @p name set to @p value.
+			 */
+			Environment Set(std::string_view name, std::string_view value) const;
+
+			/**
+			 * @param name Variable name.
+			 * @return Overlay without @p name.
+			 */
+			Environment Unset(std::string_view name) const;
+
+			/**
+			 * @return Number of variables.
+			 */
+			size_t Size() const noexcept;
+
+			/**
+			 * @return Every variable as `NAME=value`.
+			 */
+			std::vector<std::string> Entries() const;
+
+		private:
+			friend class Command;
+			friend class Process;
+
+			struct Snapshot;							///< Shared state (defined in the implementation)
+
+			std::shared_ptr<const Snapshot> m_snapshot;	///< Snapshot
+
+			/**
+			 * @param snapshot Snapshot.
+			 */
+			explicit Environment(std::shared_ptr<const Snapshot> snapshot) noexcept;
+
+			/**
+			 * @param name Name.
+			 * @param entry Override: `NAME=value`, or just `NAME` to remove it.
+			 * @return Overlay of this snapshot with @p entry.
+			 */
+			Environment Overlay(std::string_view name, std::string entry) const;
+
+			#ifdef WINDOWS
+			/**
+			 * @return Sorted, double-NUL terminated block for CreateProcessW (built once).
+			 */
+			const wchar_t* Block() const;
+			#else
+			/**
+			 * @return Null-terminated envp (built once).
+			 */
+			char* const* Envp() const;
+			#endif
+	};
+}
@@ -0,0 +1,201 @@
+#include <StormByte/system/executor.hxx>
+
+#include <algorithm>
+#include <cstdint>
+
+#ifdef LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace StormByte::System;
+
+namespace {
+	// Worker identity, so tasks posted from a worker stay on its queue
+	thread_local const ThreadPool* current_pool = nullptr;
+	thread_local size_t current_index = 0;
+
+	std::mutex default_mutex;
+	std::shared_ptr<Executor> default_executor;
+}
+
+std::shared_ptr<Executor> Executor::Default() {
+	std::lock_guard<std::mutex> lock(default_mutex);
+	if (!default_executor)
+		default_executor = std::make_shared<ThreadPool>();
+	return default_executor;
+}
+
+void Executor::SetDefault(std::shared_ptr<Executor> executor) {
+	std::lock_guard<std::mutex> lock(default_mutex);
+	default_executor = std::move(executor);
+}
+
+void Executor::PostLongRunning(std::function<void()> task) {
+	PostBlocking(std::move(task));
+}
+
+ThreadPool::ThreadPool(): ThreadPool(Options()) {}
+
+ThreadPool::ThreadPool(const Options& opts):
+	m_options(opts), m_next(0), m_pending(0), m_executed(0), m_stop(false), m_blocking_idle(0) {
+	if (m_options.threads == 0)
+		m_options.threads = std::max(1u, std::thread::hardware_concurrency());
+	if (m_options.max_blocking == 0)
+		m_options.max_blocking = 1;
+
+	for (size_t i = 0; i < m_options.threads; i++)
+		m_workers.push_back(std::make_unique<Worker>());
+	for (size_t i = 0; i < m_workers.size(); i++) {
+		m_workers[i]->thread = std::thread(&ThreadPool::WorkerLoop, this, i);
+		#ifdef LINUX
+		if (!m_options.affinity.empty()) {
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			CPU_SET(m_options.affinity[i % m_options.affinity.size()], &set);
+			pthread_setaffinity_np(m_workers[i]->thread.native_handle(), sizeof(set), &set);
+		}
+		#endif
+	}
+}
+
+ThreadPool::~ThreadPool() noexcept {
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		m_stop.store(true);
+	}
+	m_sleep_cv.notify_all();
+	{
+		std::lock_guard<std::mutex> lock(m_blocking_mutex);
+	}
+	m_blocking_cv.notify_all();
+
+	for (auto& worker: m_workers)
+		worker->thread.join();
+	// Blocking threads are only added under the lock, and never after stop
+	std::vector<std::thread> blocking;
+	{
+		std::lock_guard<std::mutex> lock(m_blocking_mutex);
+		blocking.swap(m_blocking_threads);
+	}
+	for (std::thread& thread: blocking)
+		thread.join();
+}
+
+void ThreadPool::Post(std::function<void()> task) {
+	const size_t index = current_pool == this ? current_index : m_next.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+	// Counted before it is visible so the counter never underflows
+	m_pending.fetch_add(1);
+	{
+		std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+		m_workers[index]->tasks.push_back(std::move(task));
+	}
+	{
+		// Pairs with the predicate check in WorkerLoop
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+	}
+	m_sleep_cv.notify_one();
+}
+
+void ThreadPool::PostBlocking(std::function<void()> task) {
+	std::lock_guard<std::mutex> lock(m_blocking_mutex);
+	QueueBlocking(std::move(task), m_options.max_blocking);
+}
+
+void ThreadPool::PostLongRunning(std::function<void()> task) {
+	std::lock_guard<std::mutex> lock(m_blocking_mutex);
+	// Past the bound: a capped pool would hang the link queued behind the others
+	QueueBlocking(std::move(task), SIZE_MAX);
+}
+
+void ThreadPool::QueueBlocking(std::function<void()> task, size_t limit) {
+	m_blocking.push_back(std::move(task));
+	// Every queued task needs its own idle thread: blocking tasks may wait on each other
+	if (m_blocking.size() > m_blocking_idle && m_blocking_threads.size() < limit && !m_stop.load())
+		m_blocking_threads.emplace_back(&ThreadPool::BlockingLoop, this);
+	else
+		m_blocking_cv.notify_one();
+}
+
+Executor::Metrics ThreadPool::Stats() const {
+	Metrics metrics;
+	metrics.workers = m_workers.size();
+	metrics.queue_depths.reserve(m_workers.size());
+	for (const auto& worker: m_workers) {
+		std::lock_guard<std::mutex> lock(worker->mutex);
+		metrics.queue_depths.push_back(worker->tasks.size());
+		metrics.queued += worker->tasks.size();
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_blocking_mutex);
+		metrics.blocking_threads = m_blocking_threads.size();
+		metrics.blocking_idle = m_blocking_idle;
+		metrics.blocking_queued = m_blocking.size();
+	}
+	metrics.executed = m_executed.load();
+	return metrics;
+}
+
+bool ThreadPool::Take(size_t index, std::function<void()>& task) {
+	{
+		Worker& own = *m_workers[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.tasks.empty()) {
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			m_pending.fetch_sub(1);
+			return true;
+		}
+	}
+	for (size_t i = 1; i < m_workers.size(); i++) {
+		Worker& victim = *m_workers[(index + i) % m_workers.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty()) {
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			m_pending.fetch_sub(1);
+			return true;
+		}
+	}
+	return false;
+}
+
+void ThreadPool::WorkerLoop(size_t index) {
+	current_pool = this;
+	current_index = index;
+	std::function<void()> task;
+	for (;;) {
+		if (Take(index, task)) {
+			task();
+			task = nullptr;
+			m_executed.fetch_add(1, std::memory_order_relaxed);
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(m_sleep_mutex);
+		m_sleep_cv.wait(lock, [this] { return m_pending.load() > 0 || m_stop.load(); });
+		// Leave only once every queue is drained
+		if (m_pending.load() == 0 && m_stop.load())
+			return;
+	}
+}
+
+void ThreadPool::BlockingLoop() {
+	std::unique_lock<std::mutex> lock(m_blocking_mutex);
+	for (;;) {
+		if (!m_blocking.empty()) {
+			std::function<void()> task = std::move(m_blocking.front());
+			m_blocking.pop_front();
+			lock.unlock();
+			task();
+			task = nullptr;
+			m_executed.fetch_add(1, std::memory_order_relaxed);
+			lock.lock();
+			continue;
+		}
+		if (m_stop.load())
+			return;
+		m_blocking_idle++;
+		m_blocking_cv.wait(lock, [this] { return !m_blocking.empty() || m_stop.load(); });
+		m_blocking_idle--;
+	}
+}
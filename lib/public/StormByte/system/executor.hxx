@@ -0,0 +1,261 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	/**
+	 * @class Executor
+	 * @brief Runs the library background work (pipeline forwarding, stream drains).
+	 *
+	 * The library uses @ref Default() unless a process is given its own executor
+	 * through `Process::Options::executor`. Derive from this class to route the
+	 * work to an application pool.
+	 */
+	class STORMBYTE_SYSTEM_PUBLIC Executor {
+		public:
+			/**
+			 * @struct Metrics
+			 * @brief Snapshot of executor load.
+			 */
+			struct Metrics {
+				size_t workers = 0;						///< Worker threads
+				size_t queued = 0;						///< Tasks waiting in worker queues
+				std::vector<size_t> queue_depths;		///< Per-worker queue depth
+				size_t blocking_threads = 0;			///< Threads in the blocking pool
+				size_t blocking_idle = 0;				///< Idle blocking threads
+				size_t blocking_queued = 0;				///< Blocking tasks waiting for a thread
+				uint64_t executed = 0;					///< Tasks completed (both pools)
+			};
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			Executor(const Executor&) = delete;
+
+			/**
+			 * Move constructor (deleted).
+			 */
+			Executor(Executor&&) = delete;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			Executor& operator=(const Executor&) = delete;
+
+			/**
+			 * Move assignment (deleted).
+			 */
+			Executor& operator=(Executor&&) = delete;
+
+			/**
+			 * Destructor.
+			 */
+			virtual ~Executor() noexcept = default;
+
+			/**
+			 * Queues a short, non-blocking task.
+			 * @param task Task.
+			 */
+			virtual void Post(std::function<void()> task) = 0;
+
+			/**
+			 * Queues a task that may block on I/O, so it does not stall @ref Post() work.
+			 * @param task Task.
+			 */
+			virtual void PostBlocking(std::function<void()> task) = 0;
+
+			/**
+			 * Queues a blocking task that may only finish once work queued after it
+			 * ran (a forwarding link, a wait for a child): it must get a thread of
+			 * its own instead of waiting for one. Defaults to @ref PostBlocking();
+			 * override it if that pool is bounded.
+			 * @param task Task.
+			 */
+			virtual void PostLongRunning(std::function<void()> task);
+
+			/**
+			 * @return Current load.
+			 */
+			virtual Metrics Stats() const = 0;
+
+			/**
+			 * @return Executor used by the library (a @ref ThreadPool with default options unless replaced).
+			 */
+			static std::shared_ptr<Executor> Default();
+
+			/**
+			 * Replaces the default executor for work started afterwards.
+			 * @param executor Executor, or nullptr to restore the built-in pool.
+			 */
+			static void SetDefault(std::shared_ptr<Executor> executor);
+
+		protected:
+			/**
+			 * Default constructor.
+			 */
+			Executor() noexcept = default;
+	};
+
+	/**
+	 * @class ThreadPool
+	 * @brief Bounded work-stealing executor with an elastic blocking pool.
+	 *
+	 * Each worker owns a queue: tasks posted from a worker go to its own queue
+	 * (LIFO for cache locality), others are distributed round-robin, and idle
+	 * workers steal from the front of busy queues. Blocking tasks run on a
+	 * separate pool that grows on demand up to @ref Options::max_blocking threads
+	 * and reuses idle ones; long-running tasks (one per library forwarding link
+	 * or detached child) grow it past that bound, so they never wait on each other.
+	 */
+	class STORMBYTE_SYSTEM_PUBLIC ThreadPool final: public Executor {
+		public:
+			/**
+			 * @struct Options
+			 * @brief Pool settings.
+			 */
+			struct Options {
+				unsigned int threads = 0;				///< Workers (0: hardware concurrency)
+				std::vector<unsigned int> affinity;		///< CPUs assigned round-robin to workers (Linux; empty: no pinning)
+				unsigned int max_blocking = 512;		///< Blocking pool upper bound (PostLongRunning() may exceed it)
+			};
+
+			/**
+			 * Starts a pool with default options.
+			 */
+			ThreadPool();
+
+			/**
+			 * @param opts Options.
+			 */
+			explicit ThreadPool(const Options& opts);
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			ThreadPool(const ThreadPool&) = delete;
+
+			/**
+			 * Move constructor (deleted).
+			 */
+			ThreadPool(ThreadPool&&) = delete;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			ThreadPool& operator=(const ThreadPool&) = delete;
+
+			/**
+			 * Move assignment (deleted).
+			 */
+			ThreadPool& operator=(ThreadPool&&) = delete;
+
+			/**
+			 * Runs the remaining tasks and joins every thread.
+			 */
+			~ThreadPool() noexcept override;
+
+			/**
+			 * @copydoc Executor::Post
+			 */
+			void Post(std::function<void()> task) override;
+
+			/**
+			 * @copydoc Executor::PostBlocking
+			 */
+			void PostBlocking(std::function<void()> task) override;
+
+			/**
+			 * @copydoc Executor::PostLongRunning
+			 */
+			void PostLongRunning(std::function<void()> task) override;
+
+			/**
+			 * @copydoc Executor::Stats
+			 */
+			Metrics Stats() const override;
+
+		private:
+			/**
+			 * @struct Worker
+			 * @brief Worker thread and its queue.
+			 */
+			struct Worker {
+				mutable std::mutex mutex;						///< Protects tasks
+				std::deque<std::function<void()>> tasks;		///< Owner pops back, thieves pop front
+				std::thread thread;								///< Thread
+			};
+
+			Options m_options;									///< Options
+			std::vector<std::unique_ptr<Worker>> m_workers;		///< Workers
+			std::atomic<size_t> m_next;							///< Round-robin cursor
+			std::atomic<size_t> m_pending;						///< Tasks in worker queues
+			std::atomic<uint64_t> m_executed;					///< Completed tasks
+			std::atomic<bool> m_stop;							///< Shutdown flag
+			std::mutex m_sleep_mutex;							///< Idle workers wait here
+			std::condition_variable m_sleep_cv;					///< Signals new work
+			mutable std::mutex m_blocking_mutex;				///< Protects the blocking pool
+			std::condition_variable m_blocking_cv;				///< Signals blocking work
+			std::deque<std::function<void()>> m_blocking;		///< Blocking tasks
+			std::vector<std::thread> m_blocking_threads;		///< Blocking pool
+			size_t m_blocking_idle;								///< Idle blocking threads
+
+			/**
+			 * Worker loop.
+			 * @param index Worker index.
+			 */
+			void WorkerLoop(size_t index);
+
+			/**
+			 * Blocking pool thread loop.
+			 */
+			void BlockingLoop();
+
+			/**
+			 * Queues a blocking task; caller holds @ref m_blocking_mutex.
+			 * @param task Task.
+			 * @param limit Blocking threads allowed.
+			 */
+			void QueueBlocking(std::function<void()> task, size_t limit);
+
+			/**
+			 * Takes a task from @p index's own queue, or steals one.
+			 * @param index Worker index.
+			 * @param task Filled with the task.
+			 * @return true if a task was taken.
+			 */
+			bool Take(size_t index, std::function<void()>& task);
+	};
+}
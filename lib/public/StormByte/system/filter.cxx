@@ -0,0 +1,95 @@
+#include <StormByte/system/filter.hxx>
+#include <StormByte/system/pipe.hxx>
+#include <StormByte/system/process.hxx>
+
+#include <memory>
+
+using namespace StormByte::System;
+
+Sink::Sink(Pipe* pipe) noexcept:
+	m_filter(nullptr), m_next(nullptr), m_pipe(pipe), m_buffer(nullptr), m_closed(false) {}
+
+Sink::Sink(std::string* buffer) noexcept:
+	m_filter(nullptr), m_next(nullptr), m_pipe(nullptr), m_buffer(buffer), m_closed(false) {}
+
+Sink::Sink(Filter* filter, Sink* next) noexcept:
+	m_filter(filter), m_next(next), m_pipe(nullptr), m_buffer(nullptr), m_closed(false) {}
+
+void Sink::Write(std::string_view data) {
+	if (m_closed || data.empty())
+		return;
+	if (m_filter) {
+		m_filter->m_transform(data, *m_next);
+		m_closed = m_next->Closed();
+	} else if (m_pipe) {
+		m_closed = !m_pipe->WriteAtomic(data);
+	} else {
+		m_buffer->append(data);
+	}
+}
+
+Sink& Sink::operator<<(std::string_view data) {
+	Write(data);
+	return *this;
+}
+
+bool Sink::Closed() const noexcept {
+	return m_closed;
+}
+
+Filter::Filter(Transform transform, Finish finish):
+	m_transform(std::move(transform)), m_finish(std::move(finish)) {}
+
+Filter Filter::Lines(LineTransform transform) {
+	return Stateful([transform] {
+		// Holds a line spanning chunk boundaries, one per pipeline
+		std::shared_ptr<std::string> partial = std::make_shared<std::string>();
+		return Filter(
+			[transform, partial](std::string_view chunk, Sink& out) {
+				size_t start = 0, pos;
+				while ((pos = chunk.find('\n', start)) != std::string_view::npos) {
+					const std::string_view line = chunk.substr(start, pos + 1 - start);
+					if (partial->empty()) {
+						transform(line, out);
+					} else {
+						partial->append(line);
+						transform(*partial, out);
+						partial->clear();
+					}
+					start = pos + 1;
+				}
+				partial->append(chunk.substr(start));
+			},
+			[transform, partial](Sink& out) {
+				if (!partial->empty()) {
+					transform(*partial, out);
+					partial->clear();
+				}
+			}
+		);
+	});
+}
+
+Filter Filter::Stateful(std::function<Filter()> make) {
+	Filter filter { Transform() };
+	filter.m_factory = std::move(make);
+	return filter;
+}
+
+Filter Filter::Instantiate() const {
+	return m_factory ? m_factory().Instantiate() : *this;
+}
+
+FilterStage::FilterStage(Process& source, Filter filter): m_source(&source) {
+	m_filters.push_back(std::move(filter));
+}
+
+FilterStage FilterStage::operator>>(Filter filter) {
+	m_filters.push_back(std::move(filter));
+	return std::move(*this);
+}
+
+Process& FilterStage::operator>>(Process& proc) {
+	m_source->ConsumeAndForward(proc, std::move(m_filters));
+	return proc;
+}
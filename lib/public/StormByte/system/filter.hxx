@@ -0,0 +1,267 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	class Filter;		///< Forward declaration
+	class Forwarder;	///< Forward declaration
+	class Pipe;			///< Forward declaration
+	class Process;		///< Forward declaration
+
+	/**
+	 * @class Sink
+	 * @brief Output of a @ref Filter stage: feeds the next stage or the target process stdin.
+	 *
+	 * Only created by the library while forwarding.
+	 */
+	class STORMBYTE_SYSTEM_PUBLIC Sink {
+		public:
+			/**
+			 * Copy constructor (deleted).
+			 */
+			Sink(const Sink&) = delete;
+
+			/**
+			 * Move constructor.
+			 */
+			Sink(Sink&&) noexcept = default;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			Sink& operator=(const Sink&) = delete;
+
+			/**
+			 * Move assignment.
+			 */
+			Sink& operator=(Sink&&) noexcept = default;
+
+			/**
+			 * Destructor.
+			 */
+			~Sink() noexcept = default;
+
+			/**
+			 * Passes @p data downstream (ignored once @ref Closed()).
+			 * @param data Data; only needs to stay valid for the duration of the call.
+			 */
+			void Write(std::string_view data);
+
+			/**
+			 * Passes @p data downstream (see @ref Write()).
+			 * @param data Data.
+			 * @return *this.
+			 */
+			Sink& operator<<(std::string_view data);
+
+			/**
+			 * @return true if the downstream consumer stopped accepting data.
+			 */
+			bool Closed() const noexcept;
+
+		private:
+			friend class Forwarder;
+
+			Filter* m_filter;		///< Next stage (nullptr for a final sink)
+			Sink* m_next;			///< Next stage output
+			Pipe* m_pipe;			///< Target stdin (blocking final sink)
+			std::string* m_buffer;	///< Output buffer (nonblocking final sink)
+			bool m_closed;			///< Downstream gone
+
+			/**
+			 * Final sink writing into @p pipe.
+			 * @param pipe Target process stdin.
+			 */
+			Sink(Pipe* pipe) noexcept;
+
+			/**
+			 * Final sink appending to @p buffer (flushed by the forwarder).
+			 * @param buffer Output buffer.
+			 */
+			Sink(std::string* buffer) noexcept;
+
+			/**
+			 * Intermediate sink feeding @p filter.
+			 * @param filter Next stage.
+			 * @param next Output of @p filter.
+			 */
+			Sink(Filter* filter, Sink* next) noexcept;
+	};
+
+	/**
+	 * @class Filter
+	 * @brief In-process pipeline stage: `p1 >> Filter(...) >> p2`.
+	 *
+	 * Runs on the executor forwarding the upstream process and receives each
+	 * chunk as a view of the read buffer (no copy); whatever it writes to its
+	 * @ref Sink goes to the next stage. Saves spawning `sed`/`awk` for trivial
+	 * transforms.
+	 */
+	class STORMBYTE_SYSTEM_PUBLIC Filter {
+		public:
+			/**
+			 * Called for every chunk read from upstream.
+			 */
+			using Transform = std::function<void(std::string_view chunk, Sink& out)>;
+
+			/**
+			 * Called once upstream reaches EOF (to flush buffered state).
+			 */
+			using Finish = std::function<void(Sink& out)>;
+
+			/**
+			 * Called for every complete line (including its '\\n', absent only on a
+			 * final unterminated line).
+			 */
+			using LineTransform = std::function<void(std::string_view line, Sink& out)>;
+
+			/**
+			 * @param transform Chunk transform.
+			 * @param finish Optional EOF hook.
+			 */
+			Filter(Transform transform, Finish finish = Finish());
+
+			/**
+			 * Copy constructor.
+			 */
+			Filter(const Filter&) = default;
+
+			/**
+			 * Move constructor.
+			 */
+			Filter(Filter&&) noexcept = default;
+
+			/**
+			 * Copy assignment.
+			 */
+			Filter& operator=(const Filter&) = default;
+
+			/**
+			 * Move assignment.
+			 */
+			Filter& operator=(Filter&&) noexcept = default;
+
+			/**
+			 * Destructor.
+			 */
+			~Filter() noexcept = default;
+
+			/**
+			 * Line-oriented filter: chunks are split on '\\n'; only lines spanning
+			 * two chunks are copied. Each pipeline gets its own partial-line buffer,
+			 * so the returned filter may be reused.
+			 * @param transform Line transform.
+			 * @return Filter.
+			 */
+			static Filter Lines(LineTransform transform);
+
+			/**
+			 * Filter with per-pipeline state: @p make runs each time the filter is
+			 * placed in a pipeline and builds the stage actually used there.
+			 * @param make Stage factory.
+			 * @return Filter.
+			 */
+			static Filter Stateful(std::function<Filter()> make);
+
+		private:
+			friend class Forwarder;
+			friend class Sink;
+
+			Transform m_transform;				///< Chunk transform
+			Finish m_finish;					///< EOF hook
+			std::function<Filter()> m_factory;	///< Per-pipeline stage factory (empty: stateless)
+
+			/**
+			 * @return Stage to run in a new pipeline.
+			 */
+			Filter Instantiate() const;
+	};
+
+	/**
+	 * @class FilterStage
+	 * @brief Pending `process >> filter [>> filter...]` chain, started by `>> process`.
+	 *
+	 * Nothing is forwarded until the chain is terminated by a process.
+	 */
+	class STORMBYTE_SYSTEM_PUBLIC FilterStage {
+		public:
+			/**
+			 * Copy constructor (deleted).
+			 */
+			FilterStage(const FilterStage&) = delete;
+
+			/**
+			 * Move constructor.
+			 */
+			FilterStage(FilterStage&&) noexcept = default;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			FilterStage& operator=(const FilterStage&) = delete;
+
+			/**
+			 * Move assignment.
+			 */
+			FilterStage& operator=(FilterStage&&) noexcept = default;
+
+			/**
+			 * Destructor.
+			 */
+			~FilterStage() noexcept = default;
+
+			/**
+			 * Appends another stage.
+			 * @param filter Stage.
+			 * @return The extended chain.
+			 */
+			FilterStage operator>>(Filter filter);
+
+			/**
+			 * Starts forwarding the source stdout through the stages into @p proc stdin.
+			 * @param proc Target process.
+			 * @return Reference to @p proc.
+			 */
+			Process& operator>>(Process& proc);
+
+		private:
+			friend class Process;
+
+			Process* m_source;				///< Upstream process
+			std::vector<Filter> m_filters;	///< Stages in order
+
+			/**
+			 * @param source Upstream process.
+			 * @param filter First stage.
+			 */
+			FilterStage(Process& source, Filter filter);
+	};
+}
@@ -0,0 +1,329 @@
+#include <StormByte/system/executor.hxx>
+#include <StormByte/system/forwarder.hxx>
+#include <StormByte/system/hedged_process.hxx>
+#include <StormByte/system/latency_histogram.hxx>
+#include <StormByte/system/pipe.hxx>
+#include <StormByte/system/timer_wheel.hxx>
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+using namespace StormByte::System;
+using namespace std::chrono_literals;
+
+/**
+ * Run shared by the owner, the drains, the feeders and the hedge timer.
+ */
+struct HedgedProcess::State {
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * One copy of the command.
+	 */
+	struct Attempt {
+		std::unique_ptr<Process> process;				///< Child
+		Clock::time_point start;						///< Spawn time
+		std::optional<Clock::time_point> first_byte;	///< First output read
+		std::optional<Clock::time_point> end;			///< Every stream reached EOF
+		std::string out;								///< Captured stdout
+		std::string err;								///< Captured stderr
+		size_t open = 0;								///< Streams not at EOF yet
+		size_t fed = 0;									///< Stdin bytes already written
+		bool cancelled = false;							///< Lost the race
+		std::thread feeder;								///< Replays stdin
+	};
+
+	Command command;									///< Command (shares the latency profile)
+	std::vector<std::string> subst;						///< Substitutions
+	Options options;									///< Policy
+	std::mutex mutex;									///< Protects everything below
+	std::condition_variable cv;							///< Input, winner and spawn changes
+	std::string input;									///< Stdin so far (replayed to each copy)
+	bool input_closed = false;							///< EoF received
+	bool spawning = false;								///< Backup being started
+	std::array<std::shared_ptr<Attempt>, 2> attempts;	///< Primary and backup
+	std::optional<size_t> winner;						///< First copy to finish
+	TimerWheel::Id timer = 0;							///< Hedge timer (0 if none)
+	std::shared_ptr<Attempt> result;					///< Winner, once resolved (owner thread only)
+	int code = -1;										///< Winner exit code
+	bool out_read = false;								///< stdout already handed out
+	bool err_read = false;								///< stderr already handed out
+
+	State(const Command& cmd, const std::vector<std::string>& subst, const Options& opts):
+		command(cmd), subst(subst), options(opts) {}
+
+	/**
+	 * Spawns copy @p index with its drains and stdin feeder.
+	 */
+	static void Launch(const std::shared_ptr<State>& state, size_t index) {
+		std::shared_ptr<Attempt> attempt = std::make_shared<Attempt>();
+		attempt->start = Clock::now();
+		attempt->process = std::make_unique<Process>(state->command, state->subst, state->options.process);
+		Process& proc = *attempt->process;
+		const std::array<Pipe*, 2> pipes { proc.m_pstdout.get(), proc.m_pstderr.get() };
+		for (const Pipe* pipe: pipes)
+			attempt->open += pipe ? 1 : 0;
+
+		// Kept in the process drains, so its own Wait() completes them
+		for (size_t stream = 0; stream < pipes.size(); stream++) {
+			if (!pipes[stream])
+				continue;
+			proc.m_drains[stream] = Forwarder::Drain(*pipes[stream], Filter([state, attempt, stream](std::string_view chunk, Sink&) {
+				std::lock_guard<std::mutex> lock(state->mutex);
+				if (!attempt->first_byte)
+					attempt->first_byte = Clock::now();
+				if (!attempt->cancelled)
+					(stream == 0 ? attempt->out : attempt->err).append(chunk);
+			}, [state, attempt, index](Sink&) {
+				Finished(state, attempt, index);
+			}), *state->options.process.executor, proc.TraceId());
+		}
+		attempt->feeder = std::thread(&State::Feed, state, attempt);
+
+		std::lock_guard<std::mutex> lock(state->mutex);
+		state->attempts[index] = std::move(attempt);
+		state->cv.notify_all();
+	}
+
+	/**
+	 * Writes stdin to @p attempt as it arrives, then closes it.
+	 */
+	static void Feed(std::shared_ptr<State> state, std::shared_ptr<Attempt> attempt) {
+		std::unique_lock<std::mutex> lock(state->mutex);
+		while (true) {
+			state->cv.wait(lock, [&] {
+				return attempt->cancelled || state->input_closed || attempt->fed < state->input.size();
+			});
+			if (attempt->cancelled)
+				return;
+			if (attempt->fed == state->input.size())
+				break;
+			// Written unlocked: a child that is slow to read must not stall the other
+			const std::string chunk = state->input.substr(attempt->fed);
+			attempt->fed = state->input.size();
+			lock.unlock();
+			*attempt->process << chunk;
+			lock.lock();
+		}
+		lock.unlock();
+		*attempt->process << EoF;
+	}
+
+	/**
+	 * Stream EOF of @p attempt; the first copy with every stream done wins.
+	 */
+	static void Finished(const std::shared_ptr<State>& state, const std::shared_ptr<Attempt>& attempt, size_t index) {
+		std::shared_ptr<Attempt> loser;
+		TimerWheel::Id timer = 0;
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			if (--attempt->open > 0)
+				return;
+			attempt->end = Clock::now();
+			if (state->winner || attempt->cancelled)
+				return;
+			state->winner = index;
+			std::swap(timer, state->timer);
+			// A backup still being spawned is abandoned by Hedge()
+			const std::shared_ptr<Attempt>& other = state->attempts[1 - index];
+			if (other && !other->cancelled) {
+				other->cancelled = true;
+				loser = other;
+			}
+			state->cv.notify_all();
+		}
+		if (timer)
+			TimerWheel::Instance().Cancel(timer);
+		if (loser)
+			Abandon(*state, loser);
+	}
+
+	/**
+	 * Terminates a losing copy and reaps it in the background.
+	 */
+	static void Abandon(State& state, std::shared_ptr<Attempt> attempt) {
+		// Reuses the deadline machinery: SIGTERM now, SIGKILL after the grace period
+		attempt->process->SetDeadline(Process::Deadline { 1ms, state.options.grace, nullptr });
+		state.options.process.executor->PostLongRunning([attempt] {
+			attempt->feeder.join();
+			attempt->process->Wait();
+		});
+	}
+
+	/**
+	 * Hedge timer: starts the backup unless the primary already did enough.
+	 */
+	static void Hedge(const std::shared_ptr<State>& state) {
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			if (state->winner || state->attempts[1])
+				return;
+			if (state->options.trigger == Options::Trigger::FIRST_BYTE && state->attempts[0]->first_byte)
+				return;
+			state->spawning = true;
+		}
+		try {
+			Launch(state, 1);
+		} catch (...) {
+			// No backup: the primary result stands
+		}
+		std::shared_ptr<Attempt> loser;
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			state->spawning = false;
+			const std::shared_ptr<Attempt>& backup = state->attempts[1];
+			if (backup && state->winner && *state->winner == 0 && !backup->cancelled) {
+				backup->cancelled = true;
+				loser = backup;
+			}
+			state->cv.notify_all();
+		}
+		if (loser)
+			Abandon(*state, loser);
+	}
+};
+
+HedgedProcess::HedgedProcess(const Command& cmd, const std::vector<std::string>& subst):
+	HedgedProcess(cmd, subst, Options()) {}
+
+HedgedProcess::HedgedProcess(const Command& cmd, const std::vector<std::string>& subst, const Options& opts):
+	m_state(std::make_shared<State>(cmd, subst, opts)) {
+	Process::Options& process = m_state->options.process;
+	if (!process.executor)
+		process.executor = Executor::Default();
+	#ifdef UNIX
+	// The race is decided on pipe EOF
+	process.memory_stdout = false;
+	process.memory_stderr = false;
+	#endif
+
+	const std::chrono::nanoseconds delay = Delay(cmd, opts);
+	State::Launch(m_state, 0);
+
+	std::weak_ptr<State> weak = m_state;
+	const TimerWheel::Id timer = TimerWheel::Instance().Schedule(m_state->attempts[0]->start + delay, [weak] {
+		// Spawning forks: kept off the timer thread
+		if (std::shared_ptr<State> state = weak.lock())
+			state->options.process.executor->PostBlocking([state] { State::Hedge(state); });
+	});
+	std::lock_guard<std::mutex> lock(m_state->mutex);
+	if (m_state->winner)
+		TimerWheel::Instance().Cancel(timer);
+	else
+		m_state->timer = timer;
+}
+
+HedgedProcess::HedgedProcess(HedgedProcess&&) noexcept = default;
+
+HedgedProcess& HedgedProcess::operator=(HedgedProcess&& proc) noexcept {
+	if (this != &proc) {
+		Resolve();
+		m_state = std::move(proc.m_state);
+	}
+	return *this;
+}
+
+HedgedProcess::~HedgedProcess() noexcept {
+	Resolve();
+}
+
+HedgedProcess& HedgedProcess::operator<<(const std::string& str) {
+	if (m_state) {
+		std::lock_guard<std::mutex> lock(m_state->mutex);
+		if (!m_state->input_closed) {
+			m_state->input += str;
+			m_state->cv.notify_all();
+		}
+	}
+	return *this;
+}
+
+void HedgedProcess::operator<<(const System::_EoF&) {
+	if (m_state) {
+		std::lock_guard<std::mutex> lock(m_state->mutex);
+		m_state->input_closed = true;
+		m_state->cv.notify_all();
+	}
+}
+
+std::string& HedgedProcess::operator>>(std::string& str) {
+	Resolve();
+	if (m_state && !m_state->out_read) {
+		str += m_state->result->out;
+		m_state->out_read = true;
+	}
+	return str;
+}
+
+std::string& HedgedProcess::Stderr(std::string& str) {
+	Resolve();
+	if (m_state && !m_state->err_read) {
+		str += m_state->result->err;
+		m_state->err_read = true;
+	}
+	return str;
+}
+
+#ifdef UNIX
+int HedgedProcess::Wait() {
+	Resolve();
+	return m_state ? m_state->code : -1;
+}
+#else
+DWORD HedgedProcess::Wait() {
+	Resolve();
+	return static_cast<DWORD>(m_state ? m_state->code : -1);
+}
+#endif
+
+bool HedgedProcess::Hedged() const noexcept {
+	if (!m_state)
+		return false;
+	std::lock_guard<std::mutex> lock(m_state->mutex);
+	return m_state->attempts[1] != nullptr;
+}
+
+size_t HedgedProcess::Winner() {
+	Resolve();
+	return m_state ? *m_state->winner : 0;
+}
+
+std::chrono::nanoseconds HedgedProcess::Delay(const Command& cmd, const Options& opts) {
+	const LatencyHistogram& histogram = opts.trigger == Options::Trigger::FIRST_BYTE ? cmd.m_latency->first_byte : cmd.m_latency->exit;
+	if (histogram.Count() < opts.min_samples)
+		return opts.initial_delay;
+	return histogram.Percentile(opts.percentile).value_or(opts.initial_delay);
+}
+
+std::ostream& StormByte::System::operator<<(std::ostream& os, HedgedProcess& proc) {
+	std::string data;
+	proc >> data;
+	return os << data;
+}
+
+void HedgedProcess::Resolve() {
+	if (!m_state || m_state->result)
+		return;
+	State& state = *m_state;
+	std::shared_ptr<State::Attempt> winner;
+	{
+		std::unique_lock<std::mutex> lock(state.mutex);
+		state.input_closed = true;
+		state.cv.notify_all();
+		state.cv.wait(lock, [&state] { return state.winner && !state.spawning && state.attempts[*state.winner]; });
+		winner = state.attempts[*state.winner];
+	}
+
+	winner->feeder.join();
+	state.code = static_cast<int>(winner->process->Wait());
+
+	// Only the winner is recorded: a loser was cut short
+	LatencyProfile& latency = *state.command.m_latency;
+	if (winner->first_byte)
+		latency.first_byte.Record(*winner->first_byte - winner->start);
+	latency.exit.Record(*winner->end - winner->start);
+	state.result = std::move(winner);
+}
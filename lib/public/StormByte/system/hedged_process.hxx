@@ -0,0 +1,200 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <StormByte/system/command.hxx>
+#include <StormByte/system/process.hxx>
+#include <StormByte/system/visibility.h>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	/**
+	 * @class HedgedProcess
+	 * @brief Runs a @ref Command and races a backup copy against a slow primary.
+	 *
+	 * Same stream API as @ref Process (`<<` stdin, `<< EoF`, `>>` stdout,
+	 * `Stderr()`, `Wait()`). If the primary has not produced its first byte (or
+	 * finished its output) after a delay taken from a percentile of the
+	 * command's past runs, a second copy is started with the same arguments;
+	 * stdin is buffered and replayed to both. The first copy whose stdout and
+	 * stderr reach EOF wins: its output and exit code are the result, and the
+	 * other one gets SIGTERM (SIGKILL after @ref Options::grace) and is reaped
+	 * in the background.
+	 *
+	 * Latencies are recorded into the command itself (shared by its copies), so
+	 * the delay adapts as the same command keeps running. The command must be
+	 * safe to run twice.
+	 */
+	class STORMBYTE_SYSTEM_PUBLIC HedgedProcess {
+		public:
+			/**
+			 * @struct Options
+			 * @brief Hedging policy.
+			 */
+			struct Options {
+				/**
+				 * @enum Trigger
+				 * @brief What the primary must have done before the delay to avoid a backup.
+				 */
+				enum class Trigger: unsigned short {
+					FIRST_BYTE,	///< Produced any output
+					EXIT		///< Finished its output
+				};
+
+				Trigger trigger = Trigger::EXIT;							///< Hedge condition
+				double percentile = 0.95;									///< Delay is this percentile of the trigger latency
+				size_t min_samples = 20;									///< Runs needed before the percentile is trusted
+				std::chrono::milliseconds initial_delay { 1000 };			///< Delay until then
+				std::chrono::milliseconds grace { 100 };					///< Loser SIGTERM to SIGKILL delay
+				Process::Options process;									///< Spawn options of both copies (memory output is ignored)
+			};
+
+			/**
+			 * Starts the primary with default options.
+			 * @param cmd Command.
+			 * @param subst Placeholder substitutions.
+			 * @throw ExecutableNotFound if the command can not be resolved.
+			 */
+			HedgedProcess(const Command& cmd, const std::vector<std::string>& subst = std::vector<std::string>());
+
+			/**
+			 * Starts the primary.
+			 * @param cmd Command.
+			 * @param subst Placeholder substitutions.
+			 * @param opts Hedging policy.
+			 * @throw ExecutableNotFound if the command can not be resolved.
+			 */
+			HedgedProcess(const Command& cmd, const std::vector<std::string>& subst, const Options& opts);
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			HedgedProcess(const HedgedProcess&) = delete;
+
+			/**
+			 * Move constructor.
+			 */
+			HedgedProcess(HedgedProcess&&) noexcept;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			HedgedProcess& operator=(const HedgedProcess&) = delete;
+
+			/**
+			 * Move assignment (resolves the current run first).
+			 */
+			HedgedProcess& operator=(HedgedProcess&&) noexcept;
+
+			/**
+			 * Destructor (resolves the run if still pending).
+			 */
+			~HedgedProcess() noexcept;
+
+			/**
+			 * Appends to stdin, as seen by both copies (ignored once stdin is closed).
+			 * @param str Data.
+			 * @return Reference to this.
+			 */
+			HedgedProcess& operator<<(const std::string& str);
+
+			/**
+			 * Closes stdin of both copies.
+			 * @param eof EoF sentinel.
+			 */
+			void operator<<(const System::_EoF& eof);
+
+			/**
+			 * Reads the winner stdout (closing stdin first if still open).
+			 * @param str Destination, appended to.
+			 * @return Reference to @p str.
+			 */
+			std::string& operator>>(std::string& str);
+
+			/**
+			 * Reads the winner stderr (closing stdin first if still open).
+			 * @param str Destination, appended to.
+			 * @return Reference to @p str.
+			 */
+			std::string& Stderr(std::string& str);
+
+			#ifdef UNIX
+			/**
+			 * Closes stdin if still open and waits for the winner.
+			 * @return Its exit code, or -1 on failure.
+			 */
+			int Wait();
+			#else
+			/**
+			 * Closes stdin if still open and waits for the winner.
+			 * @return Its exit code, or (DWORD)-1 on failure.
+			 */
+			DWORD Wait();
+			#endif
+
+			/**
+			 * @return true once a backup copy was started.
+			 */
+			bool Hedged() const noexcept;
+
+			/**
+			 * Closes stdin if still open and waits for the winner.
+			 * @return 0 if the primary won, 1 if the backup did.
+			 */
+			size_t Winner();
+
+			/**
+			 * @param cmd Command.
+			 * @param opts Hedging policy.
+			 * @return Delay a new run of @p cmd would wait before hedging.
+			 */
+			static std::chrono::nanoseconds Delay(const Command& cmd, const Options& opts);
+
+			/**
+			 * Streams the winner stdout to an ostream.
+			 */
+			friend STORMBYTE_SYSTEM_PUBLIC std::ostream& operator<<(std::ostream& ostream, HedgedProcess& proc);
+
+		private:
+			struct State;						///< Run shared with the drains and the hedge timer
+
+			std::shared_ptr<State> m_state;		///< Run (nullptr if moved-from)
+
+			/**
+			 * Closes stdin, waits for a winner and hands the loser off, once.
+			 */
+			void Resolve();
+	};
+
+	/**
+	 * Streams the winner stdout of a hedged process to an ostream.
+	 */
+	STORMBYTE_SYSTEM_PUBLIC std::ostream& operator<<(std::ostream& ostream, HedgedProcess& proc);
+}
@@ -0,0 +1,207 @@
+#include <StormByte/system/parallel_run.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <map>
+#include <memory>
+#include <thread>
+
+#ifdef UNIX
+#include <cstdlib>
+#include <unistd.h>
+#endif
+#ifdef LINUX
+#include <poll.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace StormByte::System;
+using namespace std::chrono_literals;
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	#ifndef LINUX
+	constexpr const std::chrono::milliseconds POLL_INTERVAL { 2 };
+	#endif
+
+	/**
+	 * Child in flight.
+	 */
+	struct Slot {
+		size_t index;						///< Input position
+		std::unique_ptr<Process> process;	///< Child
+		Clock::time_point start;			///< Spawn time
+		bool cancelled = false;				///< Terminated by FAIL_FAST
+		#ifdef LINUX
+		int pidfd = -1;						///< Readable once the child exited (-1: polled)
+		#endif
+	};
+
+	size_t DefaultJobs() noexcept {
+		const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+	#ifdef UNIX
+		// Cores already kept busy by the rest of the machine are left alone
+		double load = 0;
+		if (getloadavg(&load, 1) == 1 && load >= 1) {
+			const size_t busy = static_cast<size_t>(load);
+			return busy >= cores ? 1 : cores - busy;
+		}
+	#endif
+		return cores;
+	}
+
+	std::chrono::nanoseconds Percentile(const std::vector<std::chrono::nanoseconds>& sorted, double fraction) noexcept {
+		if (sorted.empty())
+			return 0ns;
+		// Nearest rank
+		const size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+		return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+	}
+
+	/**
+	 * Blocks until some child in @p running may have exited.
+	 */
+	void WaitAny(const std::vector<Slot>& running) {
+	#ifdef LINUX
+		std::vector<pollfd> fds;
+		fds.reserve(running.size());
+		bool polled = false;
+		for (const Slot& slot: running) {
+			if (slot.pidfd >= 0)
+				fds.push_back(pollfd { slot.pidfd, POLLIN, 0 });
+			else
+				polled = true;
+		}
+		// Children without a pidfd are checked every few milliseconds
+		::poll(fds.data(), fds.size(), polled ? 2 : -1);
+	#else
+		(void)running;
+		std::this_thread::sleep_for(POLL_INTERVAL);
+	#endif
+	}
+}
+
+ParallelStats StormByte::System::ParallelRun(const Command& command, const std::vector<std::string>& inputs,
+	const ParallelCallback& on_result, const ParallelOptions& options) {
+	// Without placeholders the input goes last, as with xargs
+	const Command prepared = command.Placeholders() == 0 ? command.Append(Command::PLACEHOLDER) : command;
+	const size_t placeholders = prepared.Placeholders();
+
+	ParallelStats stats;
+	stats.jobs = options.jobs ? options.jobs : DefaultJobs();
+	std::vector<std::chrono::nanoseconds> latencies;
+	latencies.reserve(inputs.size());
+	std::vector<Slot> running;
+	running.reserve(stats.jobs);
+	std::map<size_t, ParallelResult> held;
+	size_t next = 0, next_delivery = 0;
+	bool stopping = false;
+	const Clock::time_point begin = Clock::now();
+
+	const auto deliver = [&](ParallelResult&& result) {
+		latencies.push_back(result.latency);
+		if (result.exit_code == 0)
+			stats.succeeded++;
+		else
+			stats.failed++;
+		if (!options.ordered) {
+			if (on_result)
+				on_result(result);
+			return;
+		}
+		held.emplace(result.index, std::move(result));
+		for (auto it = held.begin(); it != held.end() && it->first == next_delivery; it = held.erase(it), next_delivery++) {
+			if (on_result)
+				on_result(it->second);
+		}
+	};
+
+	const auto fail = [&] {
+		if (stopping || options.failure != ParallelOptions::Failure::FAIL_FAST)
+			return;
+		stopping = true;
+		// Reuses the deadline machinery: SIGTERM now, SIGKILL after the grace period
+		std::vector<Process*> members;
+		for (Slot& slot: running) {
+			slot.cancelled = true;
+			members.push_back(slot.process.get());
+		}
+		Process::SetDeadline(members, Process::Deadline { 1ms, options.grace, nullptr });
+	};
+
+	while ((next < inputs.size() && !stopping) || !running.empty()) {
+		while (running.size() < stats.jobs && next < inputs.size() && !stopping) {
+			Slot slot { next, nullptr, Clock::now() };
+			stats.launched++;
+			try {
+				slot.process = std::make_unique<Process>(prepared, std::vector<std::string>(placeholders, inputs[next]), options.process);
+				// Nothing is fed, as with xargs: a child reading stdin sees EOF at once
+				*slot.process << System::EoF;
+				slot.process->Capture(Process::Stream::STDOUT, CapturePolicy::Full());
+				slot.process->Capture(Process::Stream::STDERR, CapturePolicy::Full());
+			} catch (const std::exception& e) {
+				ParallelResult result;
+				result.index = next;
+				result.input = inputs[next];
+				result.err = e.what();
+				result.latency = Clock::now() - slot.start;
+				next++;
+				deliver(std::move(result));
+				fail();
+				continue;
+			}
+	#ifdef LINUX
+			slot.pidfd = static_cast<int>(::syscall(SYS_pidfd_open, slot.process->Pid(), 0));
+	#endif
+			next++;
+			running.push_back(std::move(slot));
+		}
+		if (running.empty())
+			continue;
+
+		WaitAny(running);
+		for (size_t i = 0; i < running.size();) {
+			Slot& slot = running[i];
+			const auto code = slot.process->TryWait();
+			if (!code) {
+				i++;
+				continue;
+			}
+	#ifdef LINUX
+			if (slot.pidfd >= 0)
+				::close(slot.pidfd);
+	#endif
+			ParallelResult result;
+			result.index = slot.index;
+			result.input = inputs[slot.index];
+			result.exit_code = static_cast<int>(*code);
+			result.cancelled = slot.cancelled;
+			result.out = std::move(slot.process->Captured(Process::Stream::STDOUT).data);
+			result.err = std::move(slot.process->Captured(Process::Stream::STDERR).data);
+			result.latency = Clock::now() - slot.start;
+			running.erase(running.begin() + static_cast<std::ptrdiff_t>(i));
+			const bool failed = result.exit_code != 0 && !result.cancelled;
+			deliver(std::move(result));
+			if (failed)
+				fail();
+		}
+	}
+
+	for (auto& [index, result]: held) {
+		if (on_result)
+			on_result(result);
+	}
+
+	stats.skipped = inputs.size() - stats.launched;
+	stats.elapsed = Clock::now() - begin;
+	const double seconds = std::chrono::duration<double>(stats.elapsed).count();
+	stats.throughput = seconds > 0 ? static_cast<double>(latencies.size()) / seconds : 0;
+	std::sort(latencies.begin(), latencies.end());
+	stats.p50 = Percentile(latencies, 0.50);
+	stats.p90 = Percentile(latencies, 0.90);
+	stats.p99 = Percentile(latencies, 0.99);
+	stats.max = latencies.empty() ? 0ns : latencies.back();
+	return stats;
+}
@@ -0,0 +1,113 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/command.hxx>
+#include <StormByte/system/process.hxx>
+#include <StormByte/system/visibility.h>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	/**
+	 * @struct ParallelOptions
+	 * @brief Settings for @ref ParallelRun().
+	 */
+	struct STORMBYTE_SYSTEM_PUBLIC ParallelOptions {
+		/**
+		 * @enum Failure
+		 * @brief What a failed input (non-zero exit, signal or spawn error) does to the run.
+		 */
+		enum class Failure: unsigned short {
+			CONTINUE,		///< Keep going
+			FAIL_FAST		///< Launch nothing more and terminate the children in flight (not their own children)
+		};
+
+		size_t jobs = 0;						///< Children in flight; 0 derives it from the cores minus the load average
+		bool ordered = false;					///< Results delivered in input order (completed ones are held back)
+		Failure failure = Failure::CONTINUE;	///< Failure policy
+		std::chrono::milliseconds grace { 1000 };	///< FAIL_FAST: delay between SIGTERM and SIGKILL
+		Process::Options process;				///< Spawn options of every child
+	};
+
+	/**
+	 * @struct ParallelResult
+	 * @brief Outcome of one input.
+	 */
+	struct STORMBYTE_SYSTEM_PUBLIC ParallelResult {
+		size_t index = 0;							///< Input position
+		std::string input;							///< Input
+		int exit_code = -1;							///< Exit code (-1 if it did not exit normally or could not start)
+		bool cancelled = false;						///< Terminated by FAIL_FAST
+		std::string out;							///< Standard output
+		std::string err;							///< Standard error (or the spawn error message)
+		std::chrono::nanoseconds latency { 0 };		///< Spawn to reap
+	};
+
+	/**
+	 * @struct ParallelStats
+	 * @brief Aggregated figures of a @ref ParallelRun().
+	 */
+	struct STORMBYTE_SYSTEM_PUBLIC ParallelStats {
+		size_t jobs = 0;							///< Children in flight used
+		size_t launched = 0;						///< Inputs started (or failed to start)
+		size_t succeeded = 0;						///< Exit code 0
+		size_t failed = 0;							///< Everything else launched
+		size_t skipped = 0;							///< Never launched (FAIL_FAST)
+		std::chrono::nanoseconds elapsed { 0 };		///< Wall time
+		double throughput = 0;						///< Completed inputs per second
+		std::chrono::nanoseconds p50 { 0 };			///< Latency median
+		std::chrono::nanoseconds p90 { 0 };			///< Latency 90th percentile
+		std::chrono::nanoseconds p99 { 0 };			///< Latency 99th percentile
+		std::chrono::nanoseconds max { 0 };			///< Slowest input
+	};
+
+	/**
+	 * Callback receiving each result, on the calling thread.
+	 */
+	using ParallelCallback = std::function<void(ParallelResult&)>;
+
+	/**
+	 * Runs @p command once per input, `xargs -P` style, blocking until done.
+	 *
+	 * Each input replaces every placeholder of @p command or, if it has none,
+	 * is appended as the last argument. At most ParallelOptions::jobs
+	 * children run at once; stdin is closed at spawn and both streams are
+	 * captured in the background and handed to @p on_result when the child
+	 * is reaped. Exits are detected
+	 * without blocking on a single child (pidfd readiness on Linux, TryWait()
+	 * polling elsewhere).
+	 * @param command Prepared command.
+	 * @param inputs Inputs.
+	 * @param on_result Result callback (may be empty).
+	 * @param options Settings.
+	 * @return Aggregated statistics.
+	 */
+	STORMBYTE_SYSTEM_PUBLIC ParallelStats ParallelRun(const Command& command, const std::vector<std::string>& inputs,
+		const ParallelCallback& on_result, const ParallelOptions& options = ParallelOptions());
+}
@@ -1,29 +1,103 @@
+#include <StormByte/system/capture_buffer.hxx>
+#include <StormByte/system/command.hxx>
 #include <StormByte/system/exception.hxx>
+#include <StormByte/system/executor.hxx>
+#include <StormByte/system/forwarder.hxx>
+#include <StormByte/system/mapped_file.hxx>
+#include <StormByte/system/memory_file.hxx>
 #include <StormByte/system/pipe.hxx>
 #include <StormByte/system/process.hxx>
+#include <StormByte/system/reaper.hxx>
+#include <StormByte/system/tracer.hxx>
+#include <StormByte/system/uring.hxx>
+#include <StormByte/system/watchdog.hxx>
+#ifdef LINUX
+#include <StormByte/system/shared_channel.hxx>
+#endif
 
 #ifdef UNIX
 #include <sys/wait.h>
 #include <signal.h>
+#include <cerrno>
 #include <cstdlib>
+
+extern char** environ;
 #else
 #include <tlhelp32.h>
 #include <sstream>
 #include <iterator>
 #endif
 
+#include <atomic>
+
 using namespace StormByte::System;
 
+namespace {
+	std::atomic<Process::Engine> g_engine { Process::Engine::POLL };
+
+	/**
+	 * What a detached process leaves behind until the reaper is done with it.
+	 */
+	struct Orphan {
+		std::unique_ptr<Pipe> out, in, err;					///< Pipes (still used by forwarding/capture)
+		std::shared_ptr<CaptureBuffer> captures[2];			///< Captures
+		std::shared_ptr<ChunkLog> chunks;					///< Interleaved capture
+		std::shared_ptr<Executor> executor;					///< Executor running the work above
+		#ifdef WINDOWS
+		PROCESS_INFORMATION info {};						///< Handles closed when released
+
+		~Orphan() noexcept {
+			if (info.hProcess)
+				CloseHandle(info.hProcess);
+			if (info.hThread)
+				CloseHandle(info.hThread);
+		}
+		#endif
+	};
+
+	#ifdef STORMBYTE_SYSTEM_IO_URING
+	Uring* ActiveUring() noexcept {
+		return g_engine.load() == Process::Engine::IO_URING ? Uring::Instance() : nullptr;
+	}
+	#endif
+}
+
+bool Process::SetEngine(Engine engine) noexcept {
+	#ifdef STORMBYTE_SYSTEM_IO_URING
+	const bool uring = Uring::Instance() != nullptr;
+	#else
+	const bool uring = false;
+	#endif
+	if (engine == Engine::AUTO)
+		engine = uring ? Engine::IO_URING : Engine::POLL;
+	else if (engine == Engine::IO_URING && !uring)
+		return false;
+	g_engine.store(engine);
+	return true;
+}
+
+Process::Engine Process::ActiveEngine() noexcept {
+	return g_engine.load();
+}
+
 Process::Process(const std::filesystem::path& prog, const std::vector<std::string>& args):
+	Process(prog, args, Options()) {}
+
+Process::Process(std::filesystem::path&& prog, std::vector<std::string>&& args):
+	Process(std::move(prog), std::move(args), Options()) {}
+
+Process::Process(const std::filesystem::path& prog, const std::vector<std::string>& args, const Options& opts):
 	m_status(Status::RUNNING),
 #ifdef UNIX
 	m_pid(-1),
 #endif
 	m_pstdout(std::make_unique<Pipe>()),
 	m_pstdin(std::make_unique<Pipe>()),
+	m_stdin_forwarded(false),
 	m_pstderr(std::make_unique<Pipe>()),
 	m_program(prog),
-	m_arguments(args) {
+	m_arguments(args),
+	m_options(opts) {
 #ifdef WINDOWS
 	ZeroMemory(&m_siStartInfo, sizeof(STARTUPINFOW));
 	ZeroMemory(&m_piProcInfo, sizeof(PROCESS_INFORMATION));
@@ -31,16 +105,18 @@ Process::Process(const std::filesystem::path& prog, const std::vector<std::strin
 	Run();
 }
 
-Process::Process(std::filesystem::path&& prog, std::vector<std::string>&& args):
+Process::Process(std::filesystem::path&& prog, std::vector<std::string>&& args, Options&& opts):
 	m_status(Status::RUNNING),
 #ifdef UNIX
 	m_pid(-1),
 #endif
 	m_pstdout(std::make_unique<Pipe>()),
 	m_pstdin(std::make_unique<Pipe>()),
+	m_stdin_forwarded(false),
 	m_pstderr(std::make_unique<Pipe>()),
 	m_program(std::move(prog)),
-	m_arguments(std::move(args)) {
+	m_arguments(std::move(args)),
+	m_options(std::move(opts)) {
 #ifdef WINDOWS
 	ZeroMemory(&m_siStartInfo, sizeof(STARTUPINFOW));
 	ZeroMemory(&m_piProcInfo, sizeof(PROCESS_INFORMATION));
@@ -48,6 +124,34 @@ Process::Process(std::filesystem::path&& prog, std::vector<std::string>&& args):
 	Run();
 }
 
+Process::Process(const Command& cmd, const std::vector<std::string>& subst):
+	Process(cmd, subst, Options()) {}
+
+Process::Process(const Command& cmd, const std::vector<std::string>& subst, const Options& opts):
+	m_status(Status::RUNNING),
+#ifdef UNIX
+	m_pid(-1),
+#endif
+	m_pstdout(std::make_unique<Pipe>()),
+	m_pstdin(std::make_unique<Pipe>()),
+	m_stdin_forwarded(false),
+	m_pstderr(std::make_unique<Pipe>()),
+	m_program(cmd.Program()),
+	m_options(opts) {
+#ifdef UNIX
+	const std::filesystem::path file = m_options.environment ? cmd.Resolve(*m_options.environment) : cmd.Resolve();
+	Command::Block storage;
+	Spawn(file.c_str(), cmd.Argv(subst, storage), m_options.environment ? m_options.environment->Envp() : cmd.Envp(), false);
+#else
+	ZeroMemory(&m_siStartInfo, sizeof(STARTUPINFOW));
+	ZeroMemory(&m_piProcInfo, sizeof(PROCESS_INFORMATION));
+	m_arguments = cmd.Arguments(subst);
+	if (!m_options.environment)
+		m_options.environment = cmd.m_environment;
+	Run();
+#endif
+}
+
 void Process::ReleaseOwnership() noexcept {
 #ifdef UNIX
 	m_pid = -1;
@@ -59,7 +163,22 @@ void Process::ReleaseOwnership() noexcept {
 	m_pstdout.reset();
 	m_pstdin.reset();
 	m_pstderr.reset();
-	m_forwarder.reset();
+	m_forwarder = std::future<void>();
+	m_watchdog.reset();
+	m_captures = {};
+	m_drains = {};
+	m_chunks.reset();
+#ifdef UNIX
+	m_memory = {};
+#endif
+}
+
+int64_t Process::TraceId() const noexcept {
+#ifdef UNIX
+	return m_pid;
+#else
+	return m_piProcInfo.dwProcessId;
+#endif
 }
 
 Process::Process(Process&& proc) noexcept:
@@ -72,10 +191,20 @@ Process::Process(Process&& proc) noexcept:
 #endif
 	m_pstdout(std::move(proc.m_pstdout)),
 	m_pstdin(std::move(proc.m_pstdin)),
+	m_stdin_forwarded(proc.m_stdin_forwarded),
 	m_pstderr(std::move(proc.m_pstderr)),
 	m_program(std::move(proc.m_program)),
 	m_arguments(std::move(proc.m_arguments)),
-	m_forwarder(std::move(proc.m_forwarder)) {
+	m_forwarder(std::move(proc.m_forwarder)),
+	m_options(std::move(proc.m_options)),
+	m_watchdog(std::move(proc.m_watchdog)),
+	m_captures(std::move(proc.m_captures)),
+	m_drains(std::move(proc.m_drains)),
+	m_chunks(std::move(proc.m_chunks))
+#ifdef UNIX
+	, m_memory(std::move(proc.m_memory))
+#endif
+	{
 	proc.ReleaseOwnership();
 }
 
@@ -91,10 +220,19 @@ Process& Process::operator=(Process&& proc) noexcept {
 #endif
 		m_pstdout = std::move(proc.m_pstdout);
 		m_pstdin = std::move(proc.m_pstdin);
+		m_stdin_forwarded = proc.m_stdin_forwarded;
 		m_pstderr = std::move(proc.m_pstderr);
 		m_program = std::move(proc.m_program);
 		m_arguments = std::move(proc.m_arguments);
 		m_forwarder = std::move(proc.m_forwarder);
+		m_options = std::move(proc.m_options);
+		m_watchdog = std::move(proc.m_watchdog);
+		m_captures = std::move(proc.m_captures);
+		m_drains = std::move(proc.m_drains);
+		m_chunks = std::move(proc.m_chunks);
+#ifdef UNIX
+		m_memory = std::move(proc.m_memory);
+#endif
 		proc.ReleaseOwnership();
 	}
 	return *this;
@@ -116,6 +254,10 @@ Process& Process::operator>>(Process& exe) {
 	return exe;
 }
 
+FilterStage Process::operator>>(Filter filter) {
+	return FilterStage(*this, std::move(filter));
+}
+
 std::string& Process::operator>>(std::string& data) const {
 	if (m_pstdout)
 		*m_pstdout >> data;
@@ -141,48 +283,90 @@ Process& Process::operator<<(const std::string& data) {
 	return *this;
 }
 
-void Process::operator<<(const System::_EoF&) {
-	if (m_pstdin)
-		m_pstdin->CloseWrite();
+bool Process::Capture(Stream stream, const CapturePolicy& policy) {
+	const size_t index = static_cast<size_t>(stream);
+	Pipe* pipe = stream == Stream::STDOUT ? m_pstdout.get() : m_pstderr.get();
+	if (!pipe || m_captures[index] || m_chunks)
+		return false;
+
+	std::shared_ptr<CaptureBuffer> buffer = std::make_shared<CaptureBuffer>(policy);
+	if (!m_options.executor)
+		m_options.executor = Executor::Default();
+	m_drains[index] = Forwarder::Drain(*pipe, Filter([buffer](std::string_view chunk, Sink&) {
+		buffer->Append(chunk);
+	}), *m_options.executor, TraceId());
+	m_captures[index] = std::move(buffer);
+	return true;
 }
 
-void Process::Run() {
-#ifdef UNIX
-	m_pid = fork();
+CaptureResult Process::Captured(Stream stream) {
+	const size_t index = static_cast<size_t>(stream);
+	if (m_drains[index].valid())
+		m_drains[index].get();
+	return m_captures[index] ? m_captures[index]->Result() : CaptureResult();
+}
 
-	if (m_pid == 0) {
-		m_pstdin->CloseWrite();
-		m_pstdin->BindRead(STDIN_FILENO);
+bool Process::CaptureInterleaved() {
+	if (!m_pstdout || !m_pstderr || m_captures[0] || m_captures[1] || m_chunks)
+		return false;
+
+	std::shared_ptr<ChunkLog> log = std::make_shared<ChunkLog>();
+	if (!m_options.executor)
+		m_options.executor = Executor::Default();
+	for (const Stream stream: { Stream::STDOUT, Stream::STDERR }) {
+		Pipe& pipe = stream == Stream::STDOUT ? *m_pstdout : *m_pstderr;
+		m_drains[static_cast<size_t>(stream)] = Forwarder::Drain(pipe, Filter([log, stream](std::string_view chunk, Sink&) {
+			log->Append(stream, chunk);
+		}), *m_options.executor, TraceId());
+	}
+	m_chunks = std::move(log);
+	return true;
+}
 
-		m_pstdout->CloseRead();
-		m_pstdout->BindWrite(STDOUT_FILENO);
+#ifdef UNIX
+MappedOutput Process::Mapped(Stream stream) {
+	MappedOutput output;
+	const std::unique_ptr<MemoryFile>& file = m_memory[static_cast<size_t>(stream)];
+	if (!file)
+		return output;
+	// Complete once the child is gone (a no-op if already waited)
+	Wait();
+	output.m_file = file->Map();
+	return output;
+}
+#endif
 
-		m_pstderr->CloseRead();
-		m_pstderr->BindWrite(STDERR_FILENO);
+std::vector<Process::Chunk> Process::Interleaved() {
+	if (!m_chunks)
+		return std::vector<Chunk>();
+	for (auto& drain: m_drains) {
+		if (drain.valid())
+			drain.get();
+	}
+	return m_chunks->Take();
+}
 
-		std::vector<char*> argv;
-		argv.reserve(m_arguments.size() + 2);
-		argv.push_back(const_cast<char*>(m_program.c_str()));
-		for (size_t i = 0; i < m_arguments.size(); i++)
-			argv.push_back(m_arguments[i].data());
-		argv.push_back(nullptr);
+void Process::operator<<(const System::_EoF&) {
+	if (m_pstdin)
+		m_pstdin->CloseWrite();
+}
 
-		execvp(m_program.c_str(), argv.data());
-		// Child must not throw across fork boundary
-		_exit(127);
-	} else if (m_pid > 0) {
-		m_pstdin->CloseRead();
-		m_pstdout->CloseWrite();
-		m_pstderr->CloseWrite();
-	} else {
-		m_status = Status::TERMINATED;
-		throw ExecutableNotFound(m_program);
-	}
+void Process::Run() {
+#ifdef UNIX
+	// argv is built before fork: the child only execs
+	std::vector<char*> argv;
+	argv.reserve(m_arguments.size() + 2);
+	argv.push_back(const_cast<char*>(m_program.c_str()));
+	for (size_t i = 0; i < m_arguments.size(); i++)
+		argv.push_back(m_arguments[i].data());
+	argv.push_back(nullptr);
+
+	Spawn(m_program.c_str(), argv.data(), m_options.environment ? m_options.environment->Envp() : nullptr, true);
 #else
 	ZeroMemory(&m_piProcInfo, sizeof(PROCESS_INFORMATION));
 	ZeroMemory(&m_siStartInfo, sizeof(STARTUPINFOW));
 	m_siStartInfo.cb = sizeof(STARTUPINFOW);
-	m_siStartInfo.hStdError = m_pstderr->WriteHandle();
+	m_siStartInfo.hStdError = m_options.merge_stderr ? m_pstdout->WriteHandle() : m_pstderr->WriteHandle();
 	m_siStartInfo.hStdOutput = m_pstdout->WriteHandle();
 	m_siStartInfo.hStdInput = m_pstdin->ReadHandle();
 	m_siStartInfo.dwFlags |= STARTF_USESTDHANDLES;
@@ -196,16 +380,20 @@ void Process::Run() {
 	cmdline.push_back(L'\0');
 	LPWSTR szCmdline = cmdline.data();
 
+	// CreateProcessW covers both halves of fork + exec
+	const uint64_t start = Tracer::On() ? Tracer::Now() : 0;
 	if (CreateProcessW(NULL,
 			szCmdline,
 			NULL,
 			NULL,
 			TRUE,
-			CREATE_NO_WINDOW,
-			NULL,
+			CREATE_NO_WINDOW | CREATE_UNICODE_ENVIRONMENT,
+			m_options.environment ? const_cast<wchar_t*>(m_options.environment->Block()) : NULL,
 			NULL,
 			&m_siStartInfo,
 			&m_piProcInfo)) {
+		if (start)
+			Tracer::Complete("spawn", start, m_piProcInfo.dwProcessId);
 		m_pstdout->WriteHandleInformation(HANDLE_FLAG_INHERIT, 0);
 		m_pstderr->WriteHandleInformation(HANDLE_FLAG_INHERIT, 0);
 		m_pstdin->ReadHandleInformation(HANDLE_FLAG_INHERIT, 0);
@@ -213,6 +401,8 @@ void Process::Run() {
 		m_pstdout->CloseWrite();
 		m_pstderr->CloseWrite();
 		m_pstdin->CloseRead();
+		if (m_options.deadline.timeout.count() > 0)
+			SetDeadline(m_options.deadline);
 	} else {
 		m_status = Status::TERMINATED;
 		throw ExecutableNotFound(m_program);
@@ -220,6 +410,83 @@ void Process::Run() {
 #endif
 }
 
+#ifdef UNIX
+void Process::Spawn(const char* file, char* const* argv, char* const* envp, bool search) {
+	// Traced spawns learn when exec happened: this close-on-exec pipe reads EOF then
+	std::unique_ptr<Pipe> exec_probe = Tracer::On() ? std::make_unique<Pipe>() : nullptr;
+	if (m_options.memory_stdout)
+		m_memory[0] = std::make_unique<MemoryFile>();
+	if (m_options.memory_stderr && !m_options.merge_stderr)
+		m_memory[1] = std::make_unique<MemoryFile>();
+	const uint64_t start = exec_probe ? Tracer::Now() : 0;
+	m_pid = fork();
+
+	if (m_pid == 0) {
+		if (exec_probe)
+			exec_probe->CloseRead();
+
+		m_pstdin->CloseWrite();
+		m_pstdin->BindRead(STDIN_FILENO);
+
+		// Pipes are close-on-exec: one left unbound simply reads EOF in the parent
+		if (m_memory[0]) {
+			m_memory[0]->Bind(STDOUT_FILENO);
+		} else {
+			m_pstdout->CloseRead();
+			m_pstdout->BindWrite(STDOUT_FILENO);
+		}
+
+		if (m_options.merge_stderr) {
+			dup2(STDOUT_FILENO, STDERR_FILENO);
+		} else if (m_memory[1]) {
+			m_memory[1]->Bind(STDERR_FILENO);
+		} else {
+			m_pstderr->CloseRead();
+			m_pstderr->BindWrite(STDERR_FILENO);
+		}
+
+#ifdef LINUX
+		if (m_options.channel)
+			m_options.channel->BindChild();
+#endif
+
+		if (search) {
+			// PATH is then looked up in the child environment, as a shell would
+			if (envp)
+				environ = const_cast<char**>(envp);
+			execvp(file, argv);
+		}
+		else if (envp)
+			execve(file, argv, envp);
+		else
+			execv(file, argv);
+		// Child must not throw across fork boundary
+		_exit(127);
+	} else if (m_pid > 0) {
+		m_pstdin->CloseRead();
+		m_pstdout->CloseWrite();
+		m_pstderr->CloseWrite();
+#ifdef LINUX
+		if (m_options.channel)
+			m_options.channel->Spawned();
+#endif
+		if (exec_probe) {
+			Tracer::Complete("fork", start, m_pid);
+			const uint64_t exec_start = Tracer::Now();
+			exec_probe->CloseWrite();
+			std::vector<char> byte(1);
+			while (exec_probe->Read(byte, 1) > 0);
+			Tracer::Complete("exec", exec_start, m_pid);
+		}
+		if (m_options.deadline.timeout.count() > 0)
+			SetDeadline(m_options.deadline);
+	} else {
+		m_status = Status::TERMINATED;
+		throw ExecutableNotFound(m_program);
+	}
+}
+#endif
+
 void Process::Send(const std::string& str) {
 	if (m_pstdin)
 		*m_pstdin << str;
@@ -227,22 +494,38 @@ void Process::Send(const std::string& str) {
 
 #ifdef UNIX
 int Process::Wait() noexcept {
-	if (m_status == Status::TERMINATED || m_pid <= 0)
+	if (m_status == Status::TERMINATED || m_status == Status::TIMED_OUT || m_pid <= 0)
 		return -1;
+	const uint64_t start = Tracer::On() ? Tracer::Now() : 0;
 
-	if (m_forwarder) {
-		m_forwarder->join();
-		m_forwarder.reset();
+	if (m_forwarder.valid())
+		m_forwarder.get();
+	for (auto& drain: m_drains) {
+		if (drain.valid())
+			drain.get();
 	}
 
+	// Released while the child is still a zombie: its PID can not have been reused yet
+	bool timed_out = false;
+	if (m_watchdog) {
+		siginfo_t exited;
+		while (waitid(P_PID, static_cast<id_t>(m_pid), &exited, WEXITED | WNOWAIT) == -1 && errno == EINTR);
+		timed_out = m_watchdog->Release(m_pid);
+		m_watchdog.reset();
+	}
+	const Status reaped = timed_out ? Status::TIMED_OUT : Status::TERMINATED;
+
 	int status = 0;
-	if (waitpid(m_pid, &status, 0) == -1) {
-		m_status = Status::TERMINATED;
+	const bool failed = waitpid(m_pid, &status, 0) == -1;
+	if (start)
+		Tracer::Complete("wait", start, m_pid);
+	if (failed) {
+		m_status = reaped;
 		m_pid = -1;
 		return -1;
 	}
 
-	m_status = Status::TERMINATED;
+	m_status = reaped;
 	m_pid = -1;
 
 	if (WIFEXITED(status))
@@ -250,27 +533,55 @@ int Process::Wait() noexcept {
 	return -1;
 }
 
+std::optional<int> Process::TryWait() noexcept {
+	if (m_status == Status::TERMINATED || m_status == Status::TIMED_OUT || m_pid <= 0)
+		return -1;
+	siginfo_t info;
+	info.si_pid = 0;
+	// WNOWAIT: the child is only reaped by Wait(), which also handles the watchdog
+	if (waitid(P_PID, static_cast<id_t>(m_pid), &info, WEXITED | WNOHANG | WNOWAIT) == 0 && info.si_pid == 0)
+		return std::nullopt;
+	return Wait();
+}
+
 pid_t Process::Pid() noexcept {
 	return m_pid;
 }
+
+std::optional<int> Process::DetachedExit(pid_t pid) noexcept {
+	return pid > 0 ? Reaper::Instance().ExitCode(static_cast<uint32_t>(pid)) : std::nullopt;
+}
 #else
 DWORD Process::Wait() noexcept {
-	if (m_status == Status::TERMINATED || m_piProcInfo.hProcess == nullptr)
+	if (m_status == Status::TERMINATED || m_status == Status::TIMED_OUT || m_piProcInfo.hProcess == nullptr)
 		return static_cast<DWORD>(-1);
+	const uint64_t start = Tracer::On() ? Tracer::Now() : 0;
 
-	if (m_forwarder) {
-		m_forwarder->join();
-		m_forwarder.reset();
+	if (m_forwarder.valid())
+		m_forwarder.get();
+	for (auto& drain: m_drains) {
+		if (drain.valid())
+			drain.get();
 	}
 
 	DWORD exitCode = 0;
-	if (WaitForSingleObject(m_piProcInfo.hProcess, INFINITE) == WAIT_FAILED) {
-		m_status = Status::TERMINATED;
+	const DWORD waited = WaitForSingleObject(m_piProcInfo.hProcess, INFINITE);
+	if (start)
+		Tracer::Complete("wait", start, m_piProcInfo.dwProcessId);
+	// Released before the handle is closed
+	bool timed_out = false;
+	if (m_watchdog) {
+		timed_out = m_watchdog->Release(m_piProcInfo.hProcess);
+		m_watchdog.reset();
+	}
+	const Status reaped = timed_out ? Status::TIMED_OUT : Status::TERMINATED;
+	if (waited == WAIT_FAILED) {
+		m_status = reaped;
 		return static_cast<DWORD>(-1);
 	}
 
 	if (!GetExitCodeProcess(m_piProcInfo.hProcess, &exitCode)) {
-		m_status = Status::TERMINATED;
+		m_status = reaped;
 		return static_cast<DWORD>(-1);
 	}
 
@@ -278,14 +589,117 @@ DWORD Process::Wait() noexcept {
 	CloseHandle(m_piProcInfo.hThread);
 	ZeroMemory(&m_piProcInfo, sizeof(PROCESS_INFORMATION));
 
-	m_status = Status::TERMINATED;
+	m_status = reaped;
 	return exitCode;
 }
 
+std::optional<DWORD> Process::TryWait() noexcept {
+	if (m_status == Status::TERMINATED || m_status == Status::TIMED_OUT || m_piProcInfo.hProcess == nullptr)
+		return static_cast<DWORD>(-1);
+	if (WaitForSingleObject(m_piProcInfo.hProcess, 0) == WAIT_TIMEOUT)
+		return std::nullopt;
+	return Wait();
+}
+
 PROCESS_INFORMATION Process::Pid() {
 	return m_piProcInfo;
 }
+
+std::optional<DWORD> Process::DetachedExit(DWORD id) noexcept {
+	return Reaper::Instance().ExitCode(id);
+}
+#endif
+
+void Process::Detach(ExitCallback on_exit) {
+#ifdef UNIX
+	if (m_status == Status::TERMINATED || m_status == Status::TIMED_OUT || m_pid <= 0)
+		return;
+#else
+	if (m_status == Status::TERMINATED || m_status == Status::TIMED_OUT || m_piProcInfo.hProcess == nullptr)
+		return;
 #endif
+	// Nobody will read what is left: drain it so the child never blocks on a full pipe
+	if (!m_chunks) {
+		if (!m_forwarder.valid() && !m_captures[0])
+			Capture(Stream::STDOUT, CapturePolicy::Discard());
+		if (!m_captures[1])
+			Capture(Stream::STDERR, CapturePolicy::Discard());
+	}
+
+	// A child reading stdin would never exit otherwise; a forwarded one is closed upstream
+	if (m_pstdin && !m_stdin_forwarded)
+		m_pstdin->CloseWrite();
+
+	std::shared_ptr<Orphan> orphan = std::make_shared<Orphan>();
+	orphan->out = std::move(m_pstdout);
+	orphan->in = std::move(m_pstdin);
+	orphan->err = std::move(m_pstderr);
+	orphan->captures[0] = std::move(m_captures[0]);
+	orphan->captures[1] = std::move(m_captures[1]);
+	orphan->chunks = std::move(m_chunks);
+	orphan->executor = std::move(m_options.executor);
+
+	std::vector<std::future<void>> pending;
+	if (m_forwarder.valid())
+		pending.push_back(std::move(m_forwarder));
+	for (auto& drain: m_drains) {
+		if (drain.valid())
+			pending.push_back(std::move(drain));
+	}
+
+	std::shared_ptr<Watchdog> watchdog = std::move(m_watchdog);
+#ifdef UNIX
+	const Reaper::Target target = m_pid;
+#else
+	const Reaper::Target target = m_piProcInfo.hProcess;
+	orphan->info = m_piProcInfo;
+#endif
+	Reaper::Instance().Adopt(target, [watchdog, target] {
+		// Before the reap, so the watchdog never signals a recycled PID
+		if (watchdog)
+			watchdog->Release(target);
+	}, std::move(pending), std::move(on_exit), std::move(orphan));
+	ReleaseOwnership();
+}
+
+Process::Status Process::State() const noexcept {
+	return m_status;
+}
+
+void Process::SetDeadline(const Deadline& deadline) {
+	SetDeadline(std::vector<Process*> { this }, deadline);
+}
+
+void Process::SetDeadline(const std::vector<Process*>& pipeline, const Deadline& deadline) {
+	std::vector<Process*> members;
+	std::vector<Watchdog::Target> targets;
+	for (Process* proc: pipeline) {
+#ifdef UNIX
+		const Watchdog::Target target = proc ? proc->m_pid : -1;
+		if (target <= 0)
+			continue;
+#else
+		const Watchdog::Target target = proc ? proc->m_piProcInfo.hProcess : nullptr;
+		if (target == nullptr)
+			continue;
+#endif
+		if (proc->m_watchdog) {
+			// Already terminated: keep it so Wait() still reports TIMED_OUT
+			if (proc->m_watchdog->Fired())
+				continue;
+			proc->m_watchdog->Release(target);
+			proc->m_watchdog.reset();
+		}
+		members.push_back(proc);
+		targets.push_back(target);
+	}
+	if (deadline.timeout.count() <= 0 || targets.empty())
+		return;
+
+	std::shared_ptr<Watchdog> watchdog = Watchdog::Arm(std::move(targets), deadline);
+	for (Process* proc: members)
+		proc->m_watchdog = watchdog;
+}
 
 void Process::Suspend() {
 #ifdef UNIX
@@ -347,46 +761,41 @@ void Process::Resume() {
 	m_status = Status::RUNNING;
 }
 
-void Process::ConsumeAndForward(Process& exec) {
-	m_forwarder = std::make_unique<std::thread>(
-		[this, &exec] {
+void Process::ConsumeAndForward(Process& exec, std::vector<Filter> filters) {
+	exec.m_stdin_forwarded = true;
+	// Only the producer identity is captured: the Process object may be moved meanwhile
 #ifdef UNIX
-			std::vector<char> buffer(Pipe::MAX_READ_BYTES);
-			ssize_t bytes_read;
-			bool chunks_written = true;
-			do {
-				bytes_read = m_pstdout->Read(buffer, Pipe::MAX_READ_BYTES);
-				if (bytes_read > 0)
-					chunks_written = exec.m_pstdin->WriteAtomic(std::string(buffer.data(), static_cast<size_t>(bytes_read)));
-			} while (!m_pstdout->ReadEOF() && chunks_written);
-			exec.m_pstdin->CloseWrite();
-
-			if (!chunks_written) {
-				if (m_pid > 0)
-					kill(m_pid, SIGTERM);
-				while (!m_pstdout->ReadEOF()) {
-					std::vector<char> discard(Pipe::MAX_READ_BYTES);
-					m_pstdout->Read(discard, Pipe::MAX_READ_BYTES);
-				}
-			}
+	const pid_t pid = m_pid;
+	auto terminate = [pid] {
+		if (pid > 0)
+			kill(pid, SIGTERM);
+	};
 #else
-			DWORD status;
-			std::vector<CHAR> buffer(Pipe::MAX_READ_BYTES);
-			DWORD bytes_read;
-			bool chunks_written = true;
-			do {
-				bytes_read = m_pstdout->Read(buffer, static_cast<DWORD>(Pipe::MAX_READ_BYTES));
-				if (bytes_read > 0)
-					chunks_written = exec.m_pstdin->WriteAtomic(std::string(buffer.data(), bytes_read));
-				status = WaitForSingleObject(m_piProcInfo.hProcess, 0);
-			} while (chunks_written && status == WAIT_TIMEOUT);
-
-			if (!chunks_written)
-				TerminateProcess(m_piProcInfo.hProcess, 0);
-			exec.m_pstdin->CloseWrite();
+	const HANDLE process = m_piProcInfo.hProcess;
+	auto terminate = [process] {
+		if (process != nullptr)
+			TerminateProcess(process, 0);
+	};
 #endif
-		}
-	);
+#ifdef STORMBYTE_SYSTEM_IO_URING
+	// Filters need the data in user space
+	Uring* uring = filters.empty() ? ActiveUring() : nullptr;
+	if (uring) {
+		Pipe* target = exec.m_pstdin.get();
+		m_forwarder = uring->Forward(m_pstdout->ReadHandle(), target->WriteHandle(),
+			[target, terminate](bool written) {
+				target->CloseWrite();
+				if (!written)
+					terminate();
+			}
+		);
+		return;
+	}
+#endif
+	// Kept in the options so the executor outlives the forwarding (never released on its own worker)
+	if (!m_options.executor)
+		m_options.executor = Executor::Default();
+	m_forwarder = Forwarder::Start(*m_pstdout, *exec.m_pstdin, std::move(filters), terminate, *m_options.executor, TraceId());
 }
 
 #ifdef WINDOWS
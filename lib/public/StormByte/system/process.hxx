@@ -19,11 +19,20 @@
 
 #pragma once
 
+#include <StormByte/system/capture.hxx>
+#include <StormByte/system/environment.hxx>
+#include <StormByte/system/filter.hxx>
 #include <StormByte/system/visibility.h>
 
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <thread>
 #ifdef WINDOWS
 #include <windows.h>
@@ -37,7 +46,18 @@
  * @brief System utilities: processes, pipes, environment variables.
  */
 namespace StormByte::System {
-	class Pipe;	///< Forward declaration
+	class CaptureBuffer;	///< Forward declaration
+	class ChunkLog;			///< Forward declaration
+	class Command;			///< Forward declaration
+	class Executor;			///< Forward declaration
+	#ifdef UNIX
+	class MemoryFile;		///< Forward declaration
+	#endif
+	class Pipe;				///< Forward declaration
+	#ifdef LINUX
+	class SharedChannel;	///< Forward declaration
+	#endif
+	class Watchdog;			///< Forward declaration
 
 	/**
 	 * @struct _EoF
@@ -56,10 +76,54 @@ namespace StormByte::System {
 	 *
 	 * Starts immediately on construction. Move-only.
 	 * Supports chaining (`p1 >> p2`), writing stdin, reading stdout/stderr,
-	 * Suspend/Resume. @ref Wait() blocks until exit (no timeout).
+	 * Suspend/Resume. @ref Wait() blocks until exit; a @ref Deadline bounds
+	 * how long the child may run.
 	 */
 	class STORMBYTE_SYSTEM_PUBLIC Process {
 		public:
+			/**
+			 * @struct Deadline
+			 * @brief Run time limit: the child gets SIGTERM once @ref timeout elapses
+			 * and SIGKILL if it is still alive @ref grace later (Windows terminates
+			 * at the timeout).
+			 */
+			struct Deadline {
+				std::chrono::milliseconds timeout { 0 };						///< Soft deadline from arming (0: none)
+				std::chrono::milliseconds grace { std::chrono::seconds(5) };	///< Delay before SIGKILL
+				std::function<void()> on_timeout;								///< Called once when the soft deadline fires, before signalling (timer thread; must not block)
+			};
+
+			#ifdef UNIX
+			/**
+			 * Completion callback of a detached process, with its exit code (-1 if it
+			 * did not exit normally).
+			 */
+			using ExitCallback = std::function<void(int)>;
+			#else
+			/**
+			 * Completion callback of a detached process, with its exit code.
+			 */
+			using ExitCallback = std::function<void(DWORD)>;
+			#endif
+
+			/**
+			 * @struct Options
+			 * @brief Spawn-time settings that must be known before the child starts.
+			 */
+			struct Options {
+				std::shared_ptr<Executor> executor;			///< Runs forwarding (`>>`) work; Executor::Default() if empty
+				Deadline deadline;							///< Armed when the child starts
+				bool merge_stderr = false;					///< Child stderr goes to the stdout pipe (`2>&1`); stderr reads EOF
+				std::optional<Environment> environment;		///< Child environment (prebuilt envp); inherits the parent one if empty
+				#ifdef LINUX
+				std::shared_ptr<SharedChannel> channel;		///< Bulk data channel inherited by the child (Linux only)
+				#endif
+				#ifdef UNIX
+				bool memory_stdout = false;					///< Child stdout is an anonymous memory file instead of the pipe, read with Mapped() after exit (UNIX only)
+				bool memory_stderr = false;					///< Same for stderr (ignored with merge_stderr)
+				#endif
+			};
+
 			/**
 			 * @param prog Executable path or name.
 			 * @param args Argument list (not including argv[0]).
@@ -72,6 +136,37 @@ namespace StormByte::System {
 			 */
 			Process(std::filesystem::path&& prog, std::vector<std::string>&& args = std::vector<std::string>());
 
+			/**
+			 * @param prog Executable path or name.
+			 * @param args Argument list (not including argv[0]).
+			 * @param opts Spawn options.
+			 */
+			Process(const std::filesystem::path& prog, const std::vector<std::string>& args, const Options& opts);
+
+			/**
+			 * @param prog Executable path or name (moved).
+			 * @param args Argument list (moved).
+			 * @param opts Spawn options (moved).
+			 */
+			Process(std::filesystem::path&& prog, std::vector<std::string>&& args, Options&& opts);
+
+			/**
+			 * Spawns a prepared command (cached resolution, prebuilt argv).
+			 * @param cmd Command.
+			 * @param subst Placeholder substitutions.
+			 * @throw ExecutableNotFound if the command can not be resolved.
+			 */
+			Process(const Command& cmd, const std::vector<std::string>& subst = std::vector<std::string>());
+
+			/**
+			 * Spawns a prepared command (cached resolution, prebuilt argv).
+			 * @param cmd Command.
+			 * @param subst Placeholder substitutions.
+			 * @param opts Spawn options (Options::environment, if set, replaces the command one).
+			 * @throw ExecutableNotFound if the command can not be resolved.
+			 */
+			Process(const Command& cmd, const std::vector<std::string>& subst, const Options& opts);
+
 			/**
 			 * Copy constructor (deleted).
 			 */
@@ -93,7 +188,8 @@ namespace StormByte::System {
 			Process& operator=(Process&& proc) noexcept;
 
 			/**
-			 * Destructor (waits if still owning a child, then frees pipes).
+			 * Destructor (waits if still owning a child, then frees pipes; see
+			 * @ref Detach() to avoid blocking).
 			 */
 			virtual ~Process() noexcept;
 
@@ -104,10 +200,24 @@ namespace StormByte::System {
 			 */
 			int Wait() noexcept;
 
+			/**
+			 * Reaps the process if it already exited, without blocking.
+			 * @return Exit code as @ref Wait() would return it, or std::nullopt while
+			 * the child is still running.
+			 */
+			std::optional<int> TryWait() noexcept;
+
 			/**
 			 * @return Child PID, or -1 if not owning a process.
 			 */
 			pid_t Pid() noexcept;
+
+			/**
+			 * @param pid PID of a detached process.
+			 * @return Its exit code once reaped in the background (std::nullopt while
+			 * running or unknown; recent exits only, PIDs are recycled).
+			 */
+			static std::optional<int> DetachedExit(pid_t pid) noexcept;
 			#else
 			/**
 			 * Blocks until the process exits (no timeout).
@@ -115,12 +225,38 @@ namespace StormByte::System {
 			 */
 			DWORD Wait() noexcept;
 
+			/**
+			 * Reaps the process if it already exited, without blocking.
+			 * @return Exit code as @ref Wait() would return it, or std::nullopt while
+			 * the child is still running.
+			 */
+			std::optional<DWORD> TryWait() noexcept;
+
 			/**
 			 * @return Windows PROCESS_INFORMATION (zeroed if moved-from).
 			 */
 			PROCESS_INFORMATION Pid();
+
+			/**
+			 * @param id Process id of a detached process.
+			 * @return Its exit code once reaped in the background (std::nullopt while
+			 * running or unknown; recent exits only, ids are recycled).
+			 */
+			static std::optional<DWORD> DetachedExit(DWORD id) noexcept;
 			#endif
 
+			/**
+			 * Gives up ownership without waiting: the child keeps running and is
+			 * reaped in the background (no zombie is left). Output nobody consumes
+			 * is drained and discarded so the child never blocks on it; stdin is
+			 * closed so a child reading it sees EOF, unless another process forwards
+			 * into it (that forwarding closes it at its own EOF). Afterwards this
+			 * object owns nothing.
+			 * @param on_exit Optional callback with the exit code, run on the reaper
+			 * thread once the child and its forwarding/capture finished; must not block.
+			 */
+			void Detach(ExitCallback on_exit = ExitCallback());
+
 			/**
 			 * Suspends the child process.
 			 */
@@ -132,12 +268,20 @@ namespace StormByte::System {
 			void Resume();
 
 			/**
-			 * Forwards this process stdout to @p proc stdin (background thread).
+			 * Forwards this process stdout to @p proc stdin (on the executor).
 			 * @param proc Target process.
 			 * @return Reference to @p proc.
 			 */
 			Process& operator>>(Process& proc);
 
+			/**
+			 * Starts an in-process filter chain on this process stdout; it runs
+			 * once terminated by a process (`p1 >> Filter(...) >> p2`).
+			 * @param filter First stage.
+			 * @return Pending chain.
+			 */
+			FilterStage operator>>(Filter filter);
+
 			/**
 			 * Reads remaining stdout into @p str.
 			 * @param str Destination string.
@@ -157,6 +301,67 @@ namespace StormByte::System {
 			 */
 			friend STORMBYTE_SYSTEM_PUBLIC std::ostream& operator<<(std::ostream& ostream, const Process& proc);
 
+			/**
+			 * @enum Stream
+			 * @brief Child output stream.
+			 */
+			enum class Stream: unsigned short {
+				STDOUT,		///< Standard output
+				STDERR		///< Standard error
+			};
+
+			/**
+			 * @struct Chunk
+			 * @brief Output read by @ref CaptureInterleaved().
+			 */
+			struct Chunk {
+				Stream stream;									///< Origin
+				std::chrono::steady_clock::time_point time;		///< When it was read
+				std::string data;								///< Bytes
+			};
+
+			/**
+			 * Starts draining @p stream in the background (on the executor), keeping
+			 * only what @p policy allows, so the child never blocks on a full pipe.
+			 * The stream must not be read or forwarded otherwise.
+			 * @param stream Stream.
+			 * @param policy What to keep.
+			 * @return false if @p stream is already captured or not owned.
+			 */
+			bool Capture(Stream stream, const CapturePolicy& policy);
+
+			/**
+			 * Starts draining stdout and stderr together in the background, tagging
+			 * each chunk with its stream and a monotonic timestamp so their relative
+			 * order is kept. Neither stream may be read or captured otherwise.
+			 * @return false if a stream is already captured or not owned.
+			 */
+			bool CaptureInterleaved();
+
+			/**
+			 * Blocks until both streams captured by @ref CaptureInterleaved() reach EOF.
+			 * @return Chunks in read order (empty if not captured).
+			 */
+			std::vector<Chunk> Interleaved();
+
+			/**
+			 * Blocks until the captured @p stream reaches EOF.
+			 * @param stream Stream.
+			 * @return Captured data (empty if @p stream was not captured).
+			 */
+			CaptureResult Captured(Stream stream);
+
+			#ifdef UNIX
+			/**
+			 * Maps the output of a stream sent to memory (Options::memory_stdout /
+			 * Options::memory_stderr): no pipe, copy or reallocation is involved. Waits
+			 * for the child first (see @ref Wait()) if it is still running.
+			 * @param stream Stream.
+			 * @return Read-only output (empty if @p stream was not sent to memory).
+			 */
+			MappedOutput Mapped(Stream stream);
+			#endif
+
 			/**
 			 * Writes @p str to process stdin.
 			 * @param str Data.
@@ -177,9 +382,57 @@ namespace StormByte::System {
 			enum class Status: unsigned short {
 				RUNNING,	///< Running
 				SUSPENDED,	///< Suspended
-				TERMINATED	///< Finished / cleaned up
+				TERMINATED,	///< Finished / cleaned up
+				TIMED_OUT	///< Terminated by its deadline and cleaned up
+			};
+
+			/**
+			 * @return Current status (TERMINATED / TIMED_OUT once waited).
+			 */
+			Status State() const noexcept;
+
+			/**
+			 * Arms this process deadline, counting from now and replacing any
+			 * previous one; a zero timeout disarms it. No effect once the current
+			 * deadline fired. @ref Wait() disarms it.
+			 * @param deadline Limits and callback.
+			 */
+			void SetDeadline(const Deadline& deadline);
+
+			/**
+			 * Arms one deadline shared by a pipeline: when it fires, every member
+			 * not yet waited is terminated and the callback runs once.
+			 * @param pipeline Member processes.
+			 * @param deadline Limits and callback.
+			 */
+			static void SetDeadline(const std::vector<Process*>& pipeline, const Deadline& deadline);
+
+			/**
+			 * @enum Engine
+			 * @brief I/O engine used for forwarding (`p1 >> p2`).
+			 *
+			 * Only forwarding changes with the engine: waiting, direct
+			 * stdin/stdout/stderr access (`<<`, `>> std::string`, Stderr()) and
+			 * capture drains use the same blocking system calls on every engine.
+			 */
+			enum class Engine: unsigned short {
+				POLL,		///< Blocking read/write with poll (default, portable)
+				IO_URING,	///< Linux io_uring: linked poll/splice forwarding
+				AUTO		///< IO_URING when available, POLL otherwise
 			};
 
+			/**
+			 * Selects the engine for processes started or chained afterwards.
+			 * @param engine Requested engine.
+			 * @return false if @p engine is not available (selection unchanged).
+			 */
+			static bool SetEngine(Engine engine) noexcept;
+
+			/**
+			 * @return Engine currently in use (never AUTO).
+			 */
+			static Engine ActiveEngine() noexcept;
+
 		protected:
 			Status m_status;									///< Current status
 			#ifdef UNIX
@@ -190,12 +443,25 @@ namespace StormByte::System {
 			#endif
 			std::unique_ptr<Pipe> m_pstdout;					///< stdout pipe
 			std::unique_ptr<Pipe> m_pstdin;						///< stdin pipe
+			bool m_stdin_forwarded;								///< stdin fed by another process (closed by its forwarding)
 			std::unique_ptr<Pipe> m_pstderr;					///< stderr pipe
 			std::filesystem::path m_program;					///< Program path
 			std::vector<std::string> m_arguments;				///< Arguments
-			std::unique_ptr<std::thread> m_forwarder;			///< Forwarder thread
+			std::future<void> m_forwarder;						///< Forwarding completion
+			Options m_options;									///< Spawn options
+			std::shared_ptr<Watchdog> m_watchdog;				///< Armed deadline (nullptr if none)
+			std::array<std::shared_ptr<CaptureBuffer>, 2> m_captures;	///< Capture per Stream
+			std::array<std::future<void>, 2> m_drains;			///< Capture completion per Stream
+			std::shared_ptr<ChunkLog> m_chunks;					///< Interleaved capture (nullptr if none)
+			#ifdef UNIX
+			std::array<std::unique_ptr<MemoryFile>, 2> m_memory;	///< Memory output per Stream (nullptr if piped)
+			#endif
 
 		private:
+			friend class Coprocess;
+			friend class FilterStage;
+			friend class HedgedProcess;
+
 			/**
 			 * Writes to stdin.
 			 * @param str Data.
@@ -207,17 +473,34 @@ namespace StormByte::System {
 			 */
 			void Run();
 
+			#ifdef UNIX
+			/**
+			 * Forks and execs; nothing is allocated in the child.
+			 * @param file Executable.
+			 * @param argv Null-terminated arguments.
+			 * @param envp Null-terminated environment, or nullptr to inherit.
+			 * @param search Look @p file up in PATH (execvp).
+			 */
+			void Spawn(const char* file, char* const* argv, char* const* envp, bool search);
+			#endif
+
 			/**
 			 * Consumes stdout and forwards to another process stdin.
 			 * @param exec Target process.
+			 * @param filters In-process stages applied in order (may be empty).
 			 */
-			void ConsumeAndForward(Process& exec);
+			void ConsumeAndForward(Process& exec, std::vector<Filter> filters = std::vector<Filter>());
 
 			/**
 			 * Clears ownership so Wait/destructor are no-ops.
 			 */
 			void ReleaseOwnership() noexcept;
 
+			/**
+			 * @return Id this process is traced under (its OS process id).
+			 */
+			int64_t TraceId() const noexcept;
+
 			#ifdef WINDOWS
 			/**
 			 * @return Full command line as wide string.
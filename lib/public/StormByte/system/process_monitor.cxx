@@ -0,0 +1,391 @@
+#include <StormByte/system/process.hxx>
+#include <StormByte/system/process_monitor.hxx>
+
+#ifdef LINUX
+#include <algorithm>
+#include <charconv>
+#include <fcntl.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unistd.h>
+
+using namespace StormByte::System;
+
+namespace {
+	constexpr const size_t READ_BUFFER = 1024;
+
+	const long TICKS_PER_SECOND = sysconf(_SC_CLK_TCK);
+	const long PAGE_SIZE = sysconf(_SC_PAGESIZE);
+
+	int OpenProc(pid_t pid, const char* file) noexcept {
+		const std::string path = "/proc/" + std::to_string(pid) + "/" + file;
+		return ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	}
+
+	/**
+	 * Reads the whole (small) /proc file from offset 0.
+	 */
+	std::string_view ReadAt(int fd, char (&buffer)[READ_BUFFER]) noexcept {
+		if (fd < 0)
+			return {};
+		const ssize_t bytes = ::pread(fd, buffer, sizeof(buffer), 0);
+		return bytes > 0 ? std::string_view(buffer, static_cast<size_t>(bytes)) : std::string_view();
+	}
+
+	/**
+	 * Parses the next space separated number of @p text, advancing it.
+	 */
+	uint64_t NextNumber(std::string_view& text) noexcept {
+		while (!text.empty() && text.front() == ' ')
+			text.remove_prefix(1);
+		uint64_t value = 0;
+		const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+		text.remove_prefix(static_cast<size_t>(end - text.data()));
+		return ec == std::errc() ? value : 0;
+	}
+
+	void SkipFields(std::string_view& text, size_t count) noexcept {
+		for (size_t i = 0; i < count; i++) {
+			while (!text.empty() && text.front() == ' ')
+				text.remove_prefix(1);
+			const size_t end = text.find(' ');
+			text.remove_prefix(end == std::string_view::npos ? text.size() : end);
+		}
+	}
+
+	bool ParseStat(std::string_view text, ProcessMonitor::Sample& sample) noexcept {
+		// The command name may contain anything, so fields are counted from its closing parenthesis
+		const size_t close = text.rfind(')');
+		if (close == std::string_view::npos || close + 2 >= text.size())
+			return false;
+		text.remove_prefix(close + 2);
+		sample.state = text.front();
+		SkipFields(text, 11);							// state .. cmajflt (fields 3-13)
+		const uint64_t ticks = NextNumber(text) + NextNumber(text);	// utime + stime (14-15)
+		SkipFields(text, 4);							// cutime .. nice (16-19)
+		sample.threads = static_cast<uint32_t>(NextNumber(text));	// num_threads (20)
+		sample.cpu_time = std::chrono::nanoseconds(ticks * (1000000000 / static_cast<uint64_t>(TICKS_PER_SECOND)));
+		return true;
+	}
+
+	bool ParseSchedstat(std::string_view text, ProcessMonitor::Sample& sample) noexcept {
+		// "run_ns wait_ns timeslices"
+		if (text.empty())
+			return false;
+		sample.cpu_time = std::chrono::nanoseconds(NextNumber(text));
+		return true;
+	}
+
+	void ParseStatm(std::string_view text, ProcessMonitor::Sample& sample) noexcept {
+		const uint64_t page = static_cast<uint64_t>(PAGE_SIZE);
+		sample.vm = NextNumber(text) * page;
+		sample.rss = NextNumber(text) * page;
+	}
+
+	void ParseIo(std::string_view text, ProcessMonitor::Sample& sample) noexcept {
+		// "rchar: N\nwchar: N\n..."
+		while (!text.empty()) {
+			const size_t end = std::min(text.find('\n'), text.size());
+			std::string_view line = text.substr(0, end);
+			text.remove_prefix(std::min(end + 1, text.size()));
+			uint64_t* target = nullptr;
+			if (line.starts_with("rchar:"))
+				target = &sample.read_bytes;
+			else if (line.starts_with("wchar:"))
+				target = &sample.write_bytes;
+			else
+				continue;
+			line.remove_prefix(line.find(':') + 1);
+			*target = NextNumber(line);
+		}
+	}
+
+	void Store(ProcessMonitor::Samples& ring, size_t index, const ProcessMonitor::Sample& sample) noexcept {
+		ring.pid[index] = sample.pid;
+		ring.time[index] = sample.time;
+		ring.state[index] = sample.state;
+		ring.threads[index] = sample.threads;
+		ring.cpu[index] = sample.cpu;
+		ring.cpu_time[index] = sample.cpu_time;
+		ring.rss[index] = sample.rss;
+		ring.vm[index] = sample.vm;
+		ring.read_bytes[index] = sample.read_bytes;
+		ring.write_bytes[index] = sample.write_bytes;
+	}
+}
+
+size_t ProcessMonitor::Samples::Size() const noexcept {
+	return pid.size();
+}
+
+ProcessMonitor::Sample ProcessMonitor::Samples::Row(size_t index) const {
+	return Sample { pid[index], time[index], state[index], threads[index], cpu[index], cpu_time[index],
+		rss[index], vm[index], read_bytes[index], write_bytes[index] };
+}
+
+void ProcessMonitor::Samples::Push(const Sample& sample) {
+	pid.push_back(sample.pid);
+	time.push_back(sample.time);
+	state.push_back(sample.state);
+	threads.push_back(sample.threads);
+	cpu.push_back(sample.cpu);
+	cpu_time.push_back(sample.cpu_time);
+	rss.push_back(sample.rss);
+	vm.push_back(sample.vm);
+	read_bytes.push_back(sample.read_bytes);
+	write_bytes.push_back(sample.write_bytes);
+}
+
+void ProcessMonitor::Samples::Clear() noexcept {
+	pid.clear();
+	time.clear();
+	state.clear();
+	threads.clear();
+	cpu.clear();
+	cpu_time.clear();
+	rss.clear();
+	vm.clear();
+	read_bytes.clear();
+	write_bytes.clear();
+}
+
+ProcessMonitor::ProcessMonitor(): ProcessMonitor(Options()) {}
+
+ProcessMonitor::ProcessMonitor(const Options& opts):
+	m_options(opts), m_head(0), m_rows(0), m_subscribers(std::make_shared<const Subscribers>()),
+	m_next_id(1), m_sweeping(false), m_stop(false) {
+	m_options.capacity = std::max<size_t>(m_options.capacity, 1);
+	const Sample empty;
+	for (size_t i = 0; i < m_options.capacity; i++)
+		m_ring.Push(empty);
+	if (m_options.interval.count() > 0)
+		m_thread = std::thread(&ProcessMonitor::Loop, this);
+}
+
+ProcessMonitor::~ProcessMonitor() noexcept {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wake.notify_one();
+	if (m_thread.joinable())
+		m_thread.join();
+	for (Entry& entry: m_entries)
+		Close(entry);
+}
+
+bool ProcessMonitor::Watch(pid_t pid) {
+	if (pid <= 0)
+		return false;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (const Entry& entry: m_entries) {
+			if (entry.pid == pid)
+				return true;
+		}
+	}
+
+	// Opened outside the lock: a sweep may be reading
+	Entry entry { pid, -1, OpenProc(pid, "schedstat"), -1, -1, std::nullopt };
+	if (m_options.state || entry.schedstat < 0)
+		entry.stat = OpenProc(pid, "stat");
+	if (m_options.memory)
+		entry.statm = OpenProc(pid, "statm");
+	if (m_options.io)
+		entry.io = OpenProc(pid, "io");
+	if ((entry.stat < 0 && entry.schedstat < 0) || (m_options.memory && entry.statm < 0)) {
+		Close(entry);
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (const Entry& existing: m_entries) {
+		if (existing.pid == pid) {
+			Close(entry);
+			return true;
+		}
+	}
+	m_entries.push_back(entry);
+	return true;
+}
+
+bool ProcessMonitor::Watch(Process& proc) {
+	return Watch(proc.Pid());
+}
+
+void ProcessMonitor::Unwatch(pid_t pid) noexcept {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const auto it = std::find_if(m_entries.begin(), m_entries.end(), [pid](const Entry& entry) { return entry.pid == pid; });
+	if (it == m_entries.end())
+		return;
+	// A sweep may be reading them: closed once it is done, so the numbers are not reused meanwhile
+	if (m_sweeping)
+		m_retired.push_back(*it);
+	else
+		Close(*it);
+	*it = std::move(m_entries.back());
+	m_entries.pop_back();
+}
+
+ProcessMonitor::SubscriberId ProcessMonitor::Subscribe(Subscriber subscriber) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto subscribers = std::make_shared<Subscribers>(*m_subscribers);
+	const SubscriberId id = m_next_id++;
+	subscribers->emplace_back(id, std::move(subscriber));
+	m_subscribers = std::move(subscribers);
+	return id;
+}
+
+void ProcessMonitor::Unsubscribe(SubscriberId id) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto subscribers = std::make_shared<Subscribers>(*m_subscribers);
+	std::erase_if(*subscribers, [id](const auto& item) { return item.first == id; });
+	m_subscribers = std::move(subscribers);
+}
+
+void ProcessMonitor::Sweep() {
+	std::lock_guard<std::mutex> sweep(m_sweep);
+	Clock::time_point now;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		now = Clock::now();
+		m_work = m_entries;
+		m_sweeping = true;
+	}
+
+	// Read without the lock: retired descriptors stay open until the merge
+	m_read.clear();
+	for (Entry& entry: m_work)
+		m_read.push_back(Read(entry, now));
+
+	std::shared_ptr<const Subscribers> subscribers;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		// Entries were only appended (Watch) or swapped out (Unwatch) meanwhile
+		std::unordered_map<pid_t, size_t> position;
+		position.reserve(m_entries.size());
+		for (size_t i = 0; i < m_entries.size(); i++)
+			position.emplace(m_entries[i].pid, i);
+
+		m_batch.Clear();
+		std::vector<pid_t> gone;
+		for (size_t i = 0; i < m_work.size(); i++) {
+			const Entry& read = m_work[i];
+			const auto it = position.find(read.pid);
+			// Unwatched (maybe watched again) during the sweep: the sample is stale
+			if (it == position.end() || m_entries[it->second].stat != read.stat || m_entries[it->second].schedstat != read.schedstat)
+				continue;
+			const std::optional<Sample>& sample = m_read[i];
+			if (!sample) {
+				gone.push_back(read.pid);
+				continue;
+			}
+			m_entries[it->second].last = sample;
+			m_batch.Push(*sample);
+			Store(m_ring, m_head, *sample);
+			m_head = (m_head + 1) % m_options.capacity;
+			m_rows = std::min(m_rows + 1, m_options.capacity);
+		}
+		// Reaped: its descriptors no longer resolve
+		for (pid_t pid: gone) {
+			const auto it = std::find_if(m_entries.begin(), m_entries.end(), [pid](const Entry& entry) { return entry.pid == pid; });
+			Close(*it);
+			*it = std::move(m_entries.back());
+			m_entries.pop_back();
+		}
+		for (Entry& entry: m_retired)
+			Close(entry);
+		m_retired.clear();
+		m_sweeping = false;
+
+		const Clock::duration spent = Clock::now() - now;
+		m_stats.sweeps++;
+		m_stats.last_sweep = spent;
+		m_stats.total_sweep += spent;
+		subscribers = m_subscribers;
+	}
+
+	// Without the lock, so subscribers may call back into the monitor
+	for (const auto& [id, subscriber]: *subscribers)
+		subscriber(m_batch);
+}
+
+std::optional<ProcessMonitor::Sample> ProcessMonitor::Latest(pid_t pid) const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (const Entry& entry: m_entries) {
+		if (entry.pid == pid)
+			return entry.last;
+	}
+	return std::nullopt;
+}
+
+std::vector<ProcessMonitor::Sample> ProcessMonitor::History(pid_t pid) const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::vector<Sample> history;
+	const size_t first = (m_head + m_options.capacity - m_rows) % m_options.capacity;
+	for (size_t i = 0; i < m_rows; i++) {
+		const size_t row = (first + i) % m_options.capacity;
+		if (m_ring.pid[row] == pid)
+			history.push_back(m_ring.Row(row));
+	}
+	return history;
+}
+
+ProcessMonitor::Samples ProcessMonitor::Snapshot() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	Samples snapshot;
+	const size_t first = (m_head + m_options.capacity - m_rows) % m_options.capacity;
+	for (size_t i = 0; i < m_rows; i++)
+		snapshot.Push(m_ring.Row((first + i) % m_options.capacity));
+	return snapshot;
+}
+
+ProcessMonitor::Stats ProcessMonitor::Statistics() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	Stats stats = m_stats;
+	stats.watched = m_entries.size();
+	return stats;
+}
+
+void ProcessMonitor::Loop() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_stop) {
+		// Fixed rate: the sweep duration does not drift the schedule
+		const Clock::time_point next = Clock::now() + m_options.interval;
+		lock.unlock();
+		Sweep();
+		lock.lock();
+		m_wake.wait_until(lock, next, [this] { return m_stop; });
+	}
+}
+
+std::optional<ProcessMonitor::Sample> ProcessMonitor::Read(Entry& entry, Clock::time_point now) noexcept {
+	char buffer[READ_BUFFER];
+	Sample sample;
+	sample.pid = entry.pid;
+	sample.time = now;
+	// A reaped process fails its first read
+	if (entry.stat >= 0 && !ParseStat(ReadAt(entry.stat, buffer), sample))
+		return std::nullopt;
+	if (entry.schedstat >= 0 && !ParseSchedstat(ReadAt(entry.schedstat, buffer), sample))
+		return std::nullopt;
+	ParseStatm(ReadAt(entry.statm, buffer), sample);
+	ParseIo(ReadAt(entry.io, buffer), sample);
+
+	if (entry.last) {
+		const auto wall = std::chrono::duration<double>(sample.time - entry.last->time).count();
+		const auto used = std::chrono::duration<double>(sample.cpu_time - entry.last->cpu_time).count();
+		sample.cpu = wall > 0 && used > 0 ? used / wall : 0;
+	}
+	entry.last = sample;
+	return sample;
+}
+
+void ProcessMonitor::Close(Entry& entry) noexcept {
+	for (int* fd: { &entry.stat, &entry.schedstat, &entry.statm, &entry.io }) {
+		if (*fd >= 0)
+			::close(*fd);
+		*fd = -1;
+	}
+}
+#endif
@@ -0,0 +1,304 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#ifdef LINUX
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sys/types.h>
+#include <thread>
+#include <vector>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	class Process;	///< Forward declaration
+
+	/**
+	 * @class ProcessMonitor
+	 * @brief Periodic CPU, memory and I/O sampler for running processes.
+	 *
+	 * Each watched process keeps its `/proc/<pid>` files open and every sweep
+	 * reads them with `pread()`, so sampling costs one read per file and no path
+	 * lookups. CPU time comes from `schedstat` (nanoseconds, and far cheaper for
+	 * the kernel to produce than `stat`), memory from `statm` and I/O from `io`;
+	 * `stat` is only read for the scheduler state and thread count (see
+	 * @ref Options) or when `schedstat` is missing. The descriptors stay bound to
+	 * the original process: once it is reaped its reads fail and it is dropped,
+	 * even if the pid is reused.
+	 *
+	 * Samples are stored column-wise in a fixed-capacity ring (oldest rows
+	 * overwritten) and each sweep is handed to the subscribers as one batch.
+	 * Sweeps run on a monitor thread every @ref Options::interval, or on demand
+	 * through @ref Sweep(). The /proc reads of a sweep run on a snapshot of the
+	 * watch list without the lock, so queries and (un)watching never wait for them.
+	 *
+	 * Linux only. Not copyable nor movable.
+	 */
+	class STORMBYTE_SYSTEM_PUBLIC ProcessMonitor {
+		public:
+			using Clock = std::chrono::steady_clock;	///< Time source
+			using SubscriberId = uint64_t;				///< Subscription handle (0 is never returned)
+
+			/**
+			 * @struct Options
+			 * @brief Sampling settings.
+			 */
+			struct Options {
+				std::chrono::milliseconds interval { 2000 };	///< Sweep period (0: no thread, only @ref Sweep())
+				size_t capacity = 65536;						///< Rows kept in the ring
+				bool memory = true;								///< Read `statm` (rss, vm)
+				bool io = true;									///< Read `io` (read_bytes, write_bytes)
+				bool state = false;								///< Read `stat` (state, threads)
+			};
+
+			/**
+			 * @struct Sample
+			 * @brief One process at one instant.
+			 */
+			struct Sample {
+				pid_t pid = 0;								///< Process id
+				Clock::time_point time;						///< Sampling time
+				char state = '?';							///< Scheduler state (`R`, `S`, `D`, `Z`, ...; `?` if `stat` is not read)
+				uint32_t threads = 0;						///< Thread count (0 if `stat` is not read)
+				double cpu = 0;								///< Cores used since the previous sample (0 on the first)
+				std::chrono::nanoseconds cpu_time { 0 };	///< User + system CPU time so far
+				uint64_t rss = 0;							///< Resident bytes (0 if `statm` is not read)
+				uint64_t vm = 0;							///< Virtual bytes (0 if `statm` is not read)
+				uint64_t read_bytes = 0;					///< Bytes read through syscalls (0 if `io` is not readable)
+				uint64_t write_bytes = 0;					///< Bytes written through syscalls (0 if `io` is not readable)
+			};
+
+			/**
+			 * @struct Samples
+			 * @brief Samples stored column by column (row @c i is made of element @c i of every column).
+			 */
+			struct STORMBYTE_SYSTEM_PUBLIC Samples {
+				std::vector<pid_t> pid;							///< Process ids
+				std::vector<Clock::time_point> time;			///< Sampling times
+				std::vector<char> state;						///< Scheduler states
+				std::vector<uint32_t> threads;					///< Thread counts
+				std::vector<double> cpu;						///< Cores used
+				std::vector<std::chrono::nanoseconds> cpu_time;	///< CPU times
+				std::vector<uint64_t> rss;						///< Resident bytes
+				std::vector<uint64_t> vm;						///< Virtual bytes
+				std::vector<uint64_t> read_bytes;				///< Bytes read
+				std::vector<uint64_t> write_bytes;				///< Bytes written
+
+				/**
+				 * @return Number of rows.
+				 */
+				size_t Size() const noexcept;
+
+				/**
+				 * @param index Row.
+				 * @return Row @p index gathered.
+				 */
+				Sample Row(size_t index) const;
+
+				/**
+				 * Appends a row.
+				 * @param sample Row.
+				 */
+				void Push(const Sample& sample);
+
+				/**
+				 * Removes every row, keeping the allocations.
+				 */
+				void Clear() noexcept;
+			};
+
+			/**
+			 * Subscriber callback receiving the rows of one sweep, on the sweeping thread.
+			 * The batch is only valid during the call and the callback must not block.
+			 */
+			using Subscriber = std::function<void(const Samples&)>;
+
+			/**
+			 * @struct Stats
+			 * @brief Monitor bookkeeping, to check the sampling overhead.
+			 */
+			struct Stats {
+				uint64_t sweeps = 0;							///< Sweeps done
+				size_t watched = 0;								///< Processes currently watched
+				std::chrono::nanoseconds last_sweep { 0 };		///< Duration of the last sweep
+				std::chrono::nanoseconds total_sweep { 0 };		///< Duration of all sweeps
+			};
+
+			/**
+			 * Starts the monitor thread with default options.
+			 */
+			ProcessMonitor();
+
+			/**
+			 * @param opts Options (the thread starts when the interval is not zero).
+			 */
+			explicit ProcessMonitor(const Options& opts);
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			ProcessMonitor(const ProcessMonitor&) = delete;
+
+			/**
+			 * Move constructor (deleted).
+			 */
+			ProcessMonitor(ProcessMonitor&&) = delete;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			ProcessMonitor& operator=(const ProcessMonitor&) = delete;
+
+			/**
+			 * Move assignment (deleted).
+			 */
+			ProcessMonitor& operator=(ProcessMonitor&&) = delete;
+
+			/**
+			 * Stops the thread and closes every descriptor.
+			 */
+			~ProcessMonitor() noexcept;
+
+			/**
+			 * Starts watching @p pid (no-op if already watched).
+			 * @param pid Process id.
+			 * @return false if its `/proc` entry can not be opened.
+			 */
+			bool Watch(pid_t pid);
+
+			/**
+			 * Starts watching a running child.
+			 * @param proc Process.
+			 * @return false if it is not running.
+			 */
+			bool Watch(Process& proc);
+
+			/**
+			 * Stops watching @p pid.
+			 * @param pid Process id.
+			 */
+			void Unwatch(pid_t pid) noexcept;
+
+			/**
+			 * Registers a subscriber for every following sweep.
+			 * @param subscriber Callback.
+			 * @return Handle for @ref Unsubscribe().
+			 */
+			SubscriberId Subscribe(Subscriber subscriber);
+
+			/**
+			 * Removes a subscriber (it may still see a sweep already in progress).
+			 * @param id Handle from @ref Subscribe().
+			 */
+			void Unsubscribe(SubscriberId id);
+
+			/**
+			 * Samples every watched process now, on the calling thread.
+			 */
+			void Sweep();
+
+			/**
+			 * @param pid Process id.
+			 * @return Most recent sample of @p pid, if it is watched and was sampled.
+			 */
+			std::optional<Sample> Latest(pid_t pid) const;
+
+			/**
+			 * @param pid Process id.
+			 * @return Samples of @p pid still in the ring, oldest first.
+			 */
+			std::vector<Sample> History(pid_t pid) const;
+
+			/**
+			 * @return Every row in the ring, oldest first.
+			 */
+			Samples Snapshot() const;
+
+			/**
+			 * @return Bookkeeping.
+			 */
+			Stats Statistics() const;
+
+		private:
+			/**
+			 * @struct Entry
+			 * @brief Watched process.
+			 */
+			struct Entry {
+				pid_t pid;								///< Process id
+				int stat;								///< /proc/<pid>/stat (-1 if not read)
+				int schedstat;							///< /proc/<pid>/schedstat (-1 if missing)
+				int statm;								///< /proc/<pid>/statm (-1 if not read)
+				int io;									///< /proc/<pid>/io (-1 if not read or not readable)
+				std::optional<Sample> last;				///< Previous sample
+			};
+
+			using Subscribers = std::vector<std::pair<SubscriberId, Subscriber>>;	///< Subscriber list
+
+			Options m_options;									///< Options
+			mutable std::mutex m_mutex;							///< Protects members below
+			std::vector<Entry> m_entries;						///< Watched processes
+			Samples m_ring;										///< Ring columns
+			size_t m_head;										///< Next ring row to write
+			size_t m_rows;										///< Rows stored
+			std::shared_ptr<const Subscribers> m_subscribers;	///< Copied on write
+			SubscriberId m_next_id;								///< Next subscriber handle
+			Stats m_stats;										///< Bookkeeping
+			bool m_sweeping;									///< A sweep is reading (descriptors of unwatched entries are retired)
+			std::vector<Entry> m_retired;						///< Unwatched during a sweep, closed when it merges
+			std::mutex m_sweep;									///< Serializes sweeps (guards the members below)
+			Samples m_batch;									///< Rows of the current sweep
+			std::vector<Entry> m_work;							///< Watch list copy read by the current sweep
+			std::vector<std::optional<Sample>> m_read;			///< Sample per m_work entry (nothing: gone)
+			std::condition_variable m_wake;						///< Stop signal
+			bool m_stop;										///< Stop flag
+			std::thread m_thread;								///< Monitor thread
+
+			/**
+			 * Thread loop.
+			 */
+			void Loop();
+
+			/**
+			 * Reads one process (without the lock, on a snapshot entry).
+			 * @param entry Process.
+			 * @param now Sweep time.
+			 * @return Sample, or nothing if the process is gone.
+			 */
+			static std::optional<Sample> Read(Entry& entry, Clock::time_point now) noexcept;
+
+			/**
+			 * Closes the descriptors of @p entry.
+			 * @param entry Process.
+			 */
+			static void Close(Entry& entry) noexcept;
+	};
+}
+#endif
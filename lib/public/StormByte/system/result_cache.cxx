@@ -0,0 +1,265 @@
+#include <StormByte/system/exception.hxx>
+#include <StormByte/system/mapped_file.hxx>
+#include <StormByte/system/result_cache.hxx>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#ifdef WINDOWS
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace StormByte::System;
+
+namespace {
+	constexpr const char MAGIC[4] = { 'S', 'B', 'R', 'C' };
+	constexpr const uint32_t VERSION = 1;
+	constexpr const char* SUFFIX = ".res";
+	constexpr const size_t HEX_DIGITS = 32;
+
+	/**
+	 * On-disk entry header, followed by stdout then stderr. Stored in host
+	 * byte order: a store is not meant to be shared across architectures.
+	 */
+	struct Header {
+		char magic[4];
+		uint32_t version;
+		uint64_t high;
+		uint64_t low;
+		int32_t code;
+		uint32_t reserved;
+		uint64_t out_size;
+		uint64_t err_size;
+	};
+	static_assert(sizeof(Header) == 48);
+
+	std::optional<CacheKey> ParseHex(std::string_view hex) noexcept {
+		if (hex.size() != HEX_DIGITS)
+			return std::nullopt;
+		CacheKey key;
+		for (size_t i = 0; i < HEX_DIGITS; i++) {
+			const char c = hex[i];
+			uint64_t digit;
+			if (c >= '0' && c <= '9')
+				digit = static_cast<uint64_t>(c - '0');
+			else if (c >= 'a' && c <= 'f')
+				digit = static_cast<uint64_t>(c - 'a' + 10);
+			else
+				return std::nullopt;
+			uint64_t& half = i < HEX_DIGITS / 2 ? key.high : key.low;
+			half = (half << 4) | digit;
+		}
+		return key;
+	}
+
+	unsigned long ProcessId() noexcept {
+	#ifdef WINDOWS
+		return GetCurrentProcessId();
+	#else
+		return static_cast<unsigned long>(getpid());
+	#endif
+	}
+}
+
+std::string CacheKey::Hex() const {
+	char hex[HEX_DIGITS + 1];
+	std::snprintf(hex, sizeof(hex), "%016llx%016llx", static_cast<unsigned long long>(high), static_cast<unsigned long long>(low));
+	return std::string(hex, HEX_DIGITS);
+}
+
+int CachedResult::ExitCode() const noexcept {
+	return m_code;
+}
+
+std::string_view CachedResult::Stdout() const noexcept {
+	return m_stdout;
+}
+
+std::string_view CachedResult::Stderr() const noexcept {
+	return m_stderr;
+}
+
+size_t ResultCache::KeyHash::operator()(const CacheKey& key) const noexcept {
+	return static_cast<size_t>(key.high ^ key.low);
+}
+
+ResultCache::ResultCache(const std::filesystem::path& directory, uint64_t max_bytes):
+	m_directory(directory), m_max_bytes(max_bytes) {
+	std::error_code ec;
+	std::filesystem::create_directories(m_directory, ec);
+	if (!std::filesystem::is_directory(m_directory, ec))
+		throw FileIOError(m_directory, FileIOError::Operation::Write);
+
+	// Newest first, so the recency order matches the last run
+	struct Found {
+		std::filesystem::file_time_type time;
+		Node node;
+	};
+	std::vector<Found> found;
+	for (const auto& item: std::filesystem::directory_iterator(m_directory, ec)) {
+		const std::string name = item.path().filename().string();
+		if (!item.is_regular_file(ec) || name.size() != HEX_DIGITS + std::strlen(SUFFIX) || !name.ends_with(SUFFIX))
+			continue;
+		const std::optional<CacheKey> key = ParseHex(std::string_view(name).substr(0, HEX_DIGITS));
+		const uint64_t size = item.file_size(ec);
+		if (key && !ec)
+			found.push_back(Found { item.last_write_time(ec), Node { *key, size, 0 } });
+	}
+	std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.time > b.time; });
+	for (const Found& entry: found) {
+		m_order.push_back(entry.node);
+		m_index.emplace(entry.node.key, std::prev(m_order.end()));
+		m_stats.bytes += entry.node.size;
+	}
+	Evict();
+}
+
+std::optional<CachedResult> ResultCache::Lookup(const CacheKey& key) {
+	uint64_t version;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const auto it = m_index.find(key);
+		if (it == m_index.end()) {
+			m_stats.misses++;
+			return std::nullopt;
+		}
+		m_order.splice(m_order.begin(), m_order, it->second);
+		version = it->second->version;
+	}
+
+	// Mapped outside the lock: a concurrent eviction only turns this into a miss
+	const std::filesystem::path file = PathOf(key);
+	std::shared_ptr<const MappedFile> mapped = MappedFile::Open(file);
+	const std::string_view view = mapped ? mapped->View() : std::string_view();
+	Header header;
+	bool intact = view.size() >= sizeof(Header);
+	if (intact) {
+		std::memcpy(&header, view.data(), sizeof(Header));
+		intact = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION &&
+			header.high == key.high && header.low == key.low &&
+			header.out_size <= view.size() - sizeof(Header) && header.err_size == view.size() - sizeof(Header) - header.out_size;
+	}
+
+	if (intact) {
+		// Recency for the next run
+		std::error_code ec;
+		std::filesystem::last_write_time(file, std::filesystem::file_time_type::clock::now(), ec);
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (!intact) {
+		// A concurrent Insert may have replaced the damaged file meanwhile: keep its entry
+		const auto it = m_index.find(key);
+		if (it != m_index.end() && it->second->version == version)
+			Remove(key);
+		m_stats.misses++;
+		return std::nullopt;
+	}
+	m_stats.hits++;
+
+	CachedResult result;
+	result.m_code = header.code;
+	result.m_stdout = view.substr(sizeof(Header), header.out_size);
+	result.m_stderr = view.substr(sizeof(Header) + header.out_size);
+	result.m_file = std::move(mapped);
+	return result;
+}
+
+bool ResultCache::Insert(const CacheKey& key, int code, std::string_view out, std::string_view err) {
+	const uint64_t size = sizeof(Header) + out.size() + err.size();
+	if (size > m_max_bytes)
+		return false;
+
+	Header header {};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.high = key.high;
+	header.low = key.low;
+	header.code = code;
+	header.out_size = out.size();
+	header.err_size = err.size();
+
+	// Written aside and renamed in: readers never see a partial entry
+	static std::atomic<uint64_t> sequence { 0 };
+	const std::filesystem::path file = PathOf(key);
+	std::filesystem::path temporary = file;
+	temporary += ".tmp." + std::to_string(ProcessId()) + "." + std::to_string(sequence++);
+	{
+		std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		stream.write(out.data(), static_cast<std::streamsize>(out.size()));
+		stream.write(err.data(), static_cast<std::streamsize>(err.size()));
+		stream.close();
+		if (!stream) {
+			std::error_code ec;
+			std::filesystem::remove(temporary, ec);
+			return false;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::error_code ec;
+	std::filesystem::rename(temporary, file, ec);
+	if (ec) {
+		std::filesystem::remove(temporary, ec);
+		return false;
+	}
+	const auto it = m_index.find(key);
+	if (it != m_index.end()) {
+		m_stats.bytes -= it->second->size;
+		m_order.erase(it->second);
+		m_index.erase(it);
+	}
+	m_order.push_front(Node { key, size, ++m_version });
+	m_index.emplace(key, m_order.begin());
+	m_stats.bytes += size;
+	m_stats.inserts++;
+	Evict();
+	return true;
+}
+
+void ResultCache::Clear() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	while (!m_order.empty())
+		Remove(m_order.back().key);
+}
+
+ResultCache::Stats ResultCache::Statistics() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	Stats stats = m_stats;
+	stats.entries = m_index.size();
+	return stats;
+}
+
+const std::filesystem::path& ResultCache::Directory() const noexcept {
+	return m_directory;
+}
+
+std::filesystem::path ResultCache::PathOf(const CacheKey& key) const {
+	return m_directory / (key.Hex() + SUFFIX);
+}
+
+void ResultCache::Remove(CacheKey key) {
+	const auto it = m_index.find(key);
+	if (it == m_index.end())
+		return;
+	m_stats.bytes -= it->second->size;
+	m_order.erase(it->second);
+	m_index.erase(it);
+	// Mapped results stay readable: the mapping holds the pages
+	std::error_code ec;
+	std::filesystem::remove(PathOf(key), ec);
+}
+
+void ResultCache::Evict() {
+	while (m_stats.bytes > m_max_bytes && !m_order.empty()) {
+		Remove(m_order.back().key);
+		m_stats.evictions++;
+	}
+}
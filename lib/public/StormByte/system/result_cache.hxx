@@ -0,0 +1,233 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	class MappedFile;	///< Forward declaration
+
+	/**
+	 * @struct CacheKey
+	 * @brief 128-bit content key (MurmurHash3 x64_128).
+	 */
+	struct STORMBYTE_SYSTEM_PUBLIC CacheKey {
+		uint64_t high = 0;		///< First half
+		uint64_t low = 0;		///< Second half
+
+		/**
+		 * @return 32 lowercase hex digits.
+		 */
+		std::string Hex() const;
+
+		/**
+		 * @param key Other key.
+		 * @return true if equal.
+		 */
+		bool operator==(const CacheKey& key) const noexcept = default;
+	};
+
+	/**
+	 * @class CachedResult
+	 * @brief Stored outcome of a command, viewed in place from the store.
+	 */
+	class STORMBYTE_SYSTEM_PUBLIC CachedResult {
+		public:
+			/**
+			 * @return Exit code.
+			 */
+			int ExitCode() const noexcept;
+
+			/**
+			 * @return Standard output (valid while this result lives).
+			 */
+			std::string_view Stdout() const noexcept;
+
+			/**
+			 * @return Standard error (valid while this result lives).
+			 */
+			std::string_view Stderr() const noexcept;
+
+		private:
+			friend class ResultCache;
+
+			std::shared_ptr<const MappedFile> m_file;	///< Backing mapping
+			int m_code = 0;								///< Exit code
+			std::string_view m_stdout;					///< Into m_file
+			std::string_view m_stderr;					///< Into m_file
+	};
+
+	/**
+	 * @class ResultCache
+	 * @brief Size-bounded, content-addressed on-disk store of command results.
+	 *
+	 * Each result is one file named after its key, holding a fixed header,
+	 * stdout and stderr. Files are written to a temporary name and renamed
+	 * into place, so readers (also in other processes) see either nothing or
+	 * a complete entry; hits are memory-mapped, not copied. When the stored
+	 * bytes exceed the limit the least recently used entries are removed;
+	 * recency survives restarts through the file modification times.
+	 * Several processes may share a directory; each indexes it when opened.
+	 */
+	class STORMBYTE_SYSTEM_PUBLIC ResultCache {
+		public:
+			/**
+			 * @struct Stats
+			 * @brief Counters since construction (entries and bytes are current).
+			 */
+			struct Stats {
+				uint64_t hits = 0;			///< Lookups served
+				uint64_t misses = 0;		///< Lookups not found
+				uint64_t inserts = 0;		///< Entries stored
+				uint64_t evictions = 0;		///< Entries evicted
+				size_t entries = 0;			///< Entries in the store
+				uint64_t bytes = 0;			///< Bytes in the store
+			};
+
+			/**
+			 * Opens (creating it if needed) a store and indexes the entries already in it.
+			 * @param directory Store directory.
+			 * @param max_bytes Size limit.
+			 * @throw FileIOError if @p directory can not be created.
+			 */
+			ResultCache(const std::filesystem::path& directory, uint64_t max_bytes);
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			ResultCache(const ResultCache&) = delete;
+
+			/**
+			 * Move constructor (deleted).
+			 */
+			ResultCache(ResultCache&&) = delete;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			ResultCache& operator=(const ResultCache&) = delete;
+
+			/**
+			 * Move assignment (deleted).
+			 */
+			ResultCache& operator=(ResultCache&&) = delete;
+
+			/**
+			 * Destructor (the store is kept on disk).
+			 */
+			~ResultCache() noexcept = default;
+
+			/**
+			 * @param key Key.
+			 * @return Stored result, if present and intact (a damaged entry is removed).
+			 */
+			std::optional<CachedResult> Lookup(const CacheKey& key);
+
+			/**
+			 * Stores a result, replacing any previous one, then evicts down to the limit.
+			 * @param key Key.
+			 * @param code Exit code.
+			 * @param out Standard output.
+			 * @param err Standard error.
+			 * @return false if it was not stored (larger than the limit, or write failure).
+			 */
+			bool Insert(const CacheKey& key, int code, std::string_view out, std::string_view err);
+
+			/**
+			 * Removes every entry.
+			 */
+			void Clear();
+
+			/**
+			 * @return Counters.
+			 */
+			Stats Statistics() const;
+
+			/**
+			 * @return Store directory.
+			 */
+			const std::filesystem::path& Directory() const noexcept;
+
+		private:
+			/**
+			 * @struct KeyHash
+			 * @brief Hash for the index (the key already is one).
+			 */
+			struct KeyHash {
+				/**
+				 * @param key Key.
+				 * @return Hash.
+				 */
+				size_t operator()(const CacheKey& key) const noexcept;
+			};
+
+			/**
+			 * @struct Node
+			 * @brief Indexed entry.
+			 */
+			struct Node {
+				CacheKey key;		///< Key
+				uint64_t size;		///< File size
+				uint64_t version;	///< Insert that wrote the file (0 if found on disk)
+			};
+
+			using Order = std::list<Node>;			///< Most recently used first
+
+			std::filesystem::path m_directory;									///< Store directory
+			uint64_t m_max_bytes;												///< Size limit
+			mutable std::mutex m_mutex;											///< Protects everything below
+			Order m_order;														///< Recency order
+			std::unordered_map<CacheKey, Order::iterator, KeyHash> m_index;		///< Key to node
+			Stats m_stats;														///< Counters
+			uint64_t m_version = 0;												///< Last Node::version handed out
+
+			/**
+			 * @param key Key.
+			 * @return Entry file.
+			 */
+			std::filesystem::path PathOf(const CacheKey& key) const;
+
+			/**
+			 * Drops @p key from the index and removes its file; caller holds the lock.
+			 * Taken by value: callers pass keys stored in the node being erased.
+			 * @param key Key.
+			 */
+			void Remove(CacheKey key);
+
+			/**
+			 * Evicts least recently used entries down to the limit; caller holds the lock.
+			 */
+			void Evict();
+	};
+}
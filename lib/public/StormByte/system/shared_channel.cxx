@@ -0,0 +1,179 @@
+#include <StormByte/system/exception.hxx>
+#include <StormByte/system/shared_channel.hxx>
+
+#ifdef LINUX
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace StormByte::System;
+
+SharedChannel::SharedChannel(size_t capacity):
+	m_channel{}, m_memfd(-1), m_bells{ { -1, -1 }, { -1, -1 } }, m_alive{ -1, -1 }, m_parent{ -1, -1 } {
+	capacity = std::bit_ceil(capacity < 4096 ? size_t(4096) : capacity);
+	const size_t size = SB_CHANNEL_HEADER_SIZE + 2 * capacity;
+
+	m_memfd = memfd_create("stormbyte-channel", MFD_CLOEXEC);
+	bool bells_ok = true;
+	for (auto& ring: m_bells) {
+		for (int& bell: ring) {
+			bell = eventfd(0, EFD_CLOEXEC);
+			bells_ok = bells_ok && bell >= 0;
+		}
+	}
+	if (pipe2(m_alive, O_CLOEXEC) < 0)
+		m_alive[0] = m_alive[1] = -1;
+	if (pipe2(m_parent, O_CLOEXEC) < 0)
+		m_parent[0] = m_parent[1] = -1;
+	if (m_memfd < 0 || !bells_ok || m_alive[0] < 0 || m_parent[0] < 0 || ftruncate(m_memfd, static_cast<off_t>(size)) < 0) {
+		const int error = errno;
+		Release();
+		throw Exception("Can not create shared channel: " + std::string(std::strerror(error)));
+	}
+
+	void* base = mmap(nullptr, SB_CHANNEL_HEADER_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, m_memfd, 0);
+	if (base == MAP_FAILED) {
+		const int error = errno;
+		Release();
+		throw Exception("Can not map shared channel: " + std::string(std::strerror(error)));
+	}
+	sb_channel_header* header = static_cast<sb_channel_header*>(base);
+	header->magic = SB_CHANNEL_MAGIC;
+	header->version = SB_CHANNEL_VERSION;
+	header->capacity = capacity;
+	munmap(base, SB_CHANNEL_HEADER_SIZE);
+
+	if (sb_channel_open(&m_channel, m_memfd, m_bells, SB_CHANNEL_SIDE_PARENT) < 0) {
+		const int error = errno;
+		Release();
+		throw Exception("Can not map shared channel: " + std::string(std::strerror(error)));
+	}
+	m_channel.peer = m_alive[0];
+}
+
+SharedChannel::~SharedChannel() noexcept {
+	Release();
+}
+
+void SharedChannel::Release() noexcept {
+	sb_channel_detach(&m_channel);
+	for (int* fd: { &m_memfd, &m_bells[0][0], &m_bells[0][1], &m_bells[1][0], &m_bells[1][1], &m_alive[0], &m_alive[1], &m_parent[0], &m_parent[1] }) {
+		if (*fd >= 0) {
+			close(*fd);
+			*fd = -1;
+		}
+	}
+}
+
+size_t SharedChannel::Capacity() const noexcept {
+	return static_cast<size_t>(m_channel.header->capacity);
+}
+
+std::span<char> SharedChannel::Reserve() noexcept {
+	char* ptr;
+	const size_t size = sb_channel_reserve(&m_channel, &ptr);
+	return { ptr, size };
+}
+
+void SharedChannel::Commit(size_t bytes) noexcept {
+	sb_channel_commit(&m_channel, bytes);
+}
+
+std::span<const char> SharedChannel::Peek() const noexcept {
+	const char* ptr;
+	const size_t size = sb_channel_peek(&m_channel, &ptr);
+	return { ptr, size };
+}
+
+void SharedChannel::Consume(size_t bytes) noexcept {
+	sb_channel_consume(&m_channel, bytes);
+}
+
+size_t SharedChannel::Write(std::string_view data, int timeout_ms) {
+	size_t written = 0;
+	while (written < data.size()) {
+		std::span<char> region = Reserve();
+		if (region.empty()) {
+			if (!WaitWritable(timeout_ms))
+				break;
+			continue;
+		}
+		const size_t chunk = std::min(region.size(), data.size() - written);
+		std::memcpy(region.data(), data.data() + written, chunk);
+		Commit(chunk);
+		written += chunk;
+	}
+	return written;
+}
+
+size_t SharedChannel::Read(std::string& out, int timeout_ms) {
+	size_t read = 0;
+	while (!EoF()) {
+		std::span<const char> region = Peek();
+		if (region.empty()) {
+			if (!WaitReadable(timeout_ms))
+				break;
+			continue;
+		}
+		out.append(region.data(), region.size());
+		Consume(region.size());
+		read += region.size();
+	}
+	return read;
+}
+
+bool SharedChannel::WaitReadable(int timeout_ms) const {
+	return sb_channel_wait(&m_channel, SB_CHANNEL_WANT_READ, timeout_ms) > 0;
+}
+
+bool SharedChannel::WaitWritable(int timeout_ms) const {
+	return sb_channel_wait(&m_channel, SB_CHANNEL_WANT_WRITE, timeout_ms) > 0;
+}
+
+void SharedChannel::Close() noexcept {
+	sb_channel_close(&m_channel);
+}
+
+bool SharedChannel::EoF() const noexcept {
+	// Also holds for a child that died without closing: nothing more will come
+	return sb_channel_eof(&m_channel) != 0;
+}
+
+void SharedChannel::BindChild() const noexcept {
+	// Move out of the way first: the sources may already sit on the target slots
+	int moved[2][2];
+	const int memfd = fcntl(m_memfd, F_DUPFD, 10);
+	for (int r = 0; r < 2; r++)
+		for (int k = 0; k < 2; k++)
+			moved[r][k] = fcntl(m_bells[r][k], F_DUPFD, 10);
+	const int alive = fcntl(m_alive[1], F_DUPFD, 10);
+	const int parent = fcntl(m_parent[0], F_DUPFD, 10);
+
+	dup2(memfd, SB_CHANNEL_FD_MEMORY);
+	close(memfd);
+	for (int r = 0; r < 2; r++) {
+		for (int k = 0; k < 2; k++) {
+			dup2(moved[r][k], SB_CHANNEL_FD_BELL(r, k));
+			close(moved[r][k]);
+		}
+	}
+	dup2(alive, SB_CHANNEL_FD_ALIVE);
+	close(alive);
+	dup2(parent, SB_CHANNEL_FD_PARENT);
+	close(parent);
+}
+
+void SharedChannel::Spawned() noexcept {
+	// The child holds these now; m_parent[1] stays open for as long as we live
+	for (int* fd: { &m_alive[1], &m_parent[0] }) {
+		if (*fd >= 0) {
+			close(*fd);
+			*fd = -1;
+		}
+	}
+}
+#endif
@@ -0,0 +1,359 @@
+/*
+ * Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+ *
+ * This file is part of StormByte.
+ *
+ * StormByte is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * StormByte is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file shared_channel.h
+ * @brief Child-side helper for @ref StormByte::System::SharedChannel (C and C++).
+ *
+ * Self-contained (no StormByte dependency) so cooperating workers can include it
+ * without linking the library. Linux only (memfd + eventfd).
+ *
+ * The parent maps the channel onto fixed descriptors before exec:
+ * - @ref SB_CHANNEL_FD_MEMORY: memfd holding the header and both rings
+ * - SB_CHANNEL_FD_BELL(ring, kind): eventfd doorbells, one per ring and role
+ * - @ref SB_CHANNEL_FD_ALIVE: write end of a pipe the parent watches to notice
+ *   the child is gone; the child keeps it open and never uses it
+ * - @ref SB_CHANNEL_FD_PARENT: read end of a pipe whose only write end the
+ *   parent holds; sb_channel_attach() watches it so a child notices the parent
+ *   is gone instead of waiting forever
+ *
+ * Each direction is a single-producer / single-consumer byte ring. Readers get
+ * contiguous views into shared memory (@ref sb_channel_peek) and writers get
+ * contiguous reservations (@ref sb_channel_reserve), so payloads are never
+ * copied by the channel itself. Doorbells are only rung when the other end
+ * announced it is waiting, and every doorbell has exactly one waiter (the
+ * consumer waits on the data bell, the producer on the space bell).
+ */
+
+#ifndef STORMBYTE_SYSTEM_SHARED_CHANNEL_H
+#define STORMBYTE_SYSTEM_SHARED_CHANNEL_H
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SB_CHANNEL_MAGIC			0x53424348u	/* "SBCH" */
+#define SB_CHANNEL_VERSION			2u
+#define SB_CHANNEL_HEADER_SIZE		4096u
+
+#define SB_CHANNEL_SIDE_PARENT		0
+#define SB_CHANNEL_SIDE_CHILD		1
+
+#define SB_CHANNEL_WANT_READ		1
+#define SB_CHANNEL_WANT_WRITE		2
+
+/** Ring indexes: 0 carries parent -> child, 1 carries child -> parent. */
+#define SB_CHANNEL_RING_TO_CHILD	0
+#define SB_CHANNEL_RING_TO_PARENT	1
+
+/** Doorbell kinds: rung on new data (consumer waits) / on freed space (producer waits). */
+#define SB_CHANNEL_BELL_DATA		0
+#define SB_CHANNEL_BELL_SPACE		1
+
+/** Descriptor slots in the child. */
+#define SB_CHANNEL_FD_MEMORY		3
+#define SB_CHANNEL_FD_BELL(ring, kind)	(4 + (ring) * 2 + (kind))
+#define SB_CHANNEL_FD_ALIVE			8
+#define SB_CHANNEL_FD_PARENT		9
+
+/**
+ * Per-direction ring state. Positions grow monotonically; the offset in the
+ * data area is `position & (capacity - 1)`.
+ */
+typedef struct sb_channel_ring {
+	uint64_t head;				/**< Bytes committed by the producer */
+	char pad0[56];
+	uint64_t tail;				/**< Bytes consumed by the consumer */
+	char pad1[56];
+	uint32_t closed;			/**< Producer closed its end */
+	uint32_t consumer_waiting;	/**< Consumer is (about to be) blocked on the data bell */
+	uint32_t producer_waiting;	/**< Producer is (about to be) blocked on the space bell */
+	char pad2[52];
+} sb_channel_ring;
+
+/**
+ * Shared header at offset 0 of the memfd. Ring data follows at
+ * @ref SB_CHANNEL_HEADER_SIZE (to-child ring) and
+ * SB_CHANNEL_HEADER_SIZE + capacity (to-parent ring).
+ */
+typedef struct sb_channel_header {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t capacity;			/**< Bytes per ring, power of two */
+	char pad[48];
+	sb_channel_ring rings[2];
+} sb_channel_header;
+
+/**
+ * One side's view of a mapped channel.
+ */
+typedef struct sb_channel {
+	sb_channel_header* header;
+	char* data[2];				/**< Ring data areas */
+	size_t map_size;
+	int bells[2][2];			/**< Eventfds by [ring][kind] */
+	int side;
+	int peer;					/**< Hangs up once the peer is gone (-1: not watched) */
+} sb_channel;
+
+static inline int sb_channel_priv_in(const sb_channel* ch) {
+	return ch->side == SB_CHANNEL_SIDE_PARENT ? SB_CHANNEL_RING_TO_PARENT : SB_CHANNEL_RING_TO_CHILD;
+}
+
+static inline int sb_channel_priv_out(const sb_channel* ch) {
+	return ch->side == SB_CHANNEL_SIDE_PARENT ? SB_CHANNEL_RING_TO_CHILD : SB_CHANNEL_RING_TO_PARENT;
+}
+
+/* Rings @p bell only if its single waiter announced itself through @p waiting (pairs with sb_channel_wait). */
+static inline void sb_channel_priv_notify(uint32_t* waiting, int bell) {
+	if (__atomic_exchange_n(waiting, 0u, __ATOMIC_SEQ_CST)) {
+		const uint64_t one = 1;
+		ssize_t r;
+		do {
+			r = write(bell, &one, sizeof(one));
+		} while (r < 0 && errno == EINTR);
+	}
+}
+
+/**
+ * Maps a channel from already-open descriptors.
+ * @param bells Eventfds by [ring][kind].
+ * @return 0 on success, -1 on failure (errno set).
+ */
+static inline int sb_channel_open(sb_channel* ch, int memfd, const int bells[2][2], int side) {
+	struct stat st;
+	void* base;
+	int r, k;
+	if (fstat(memfd, &st) < 0)
+		return -1;
+	base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+	if (base == MAP_FAILED)
+		return -1;
+	ch->header = (sb_channel_header*)base;
+	if (ch->header->magic != SB_CHANNEL_MAGIC || ch->header->version != SB_CHANNEL_VERSION) {
+		munmap(base, (size_t)st.st_size);
+		ch->header = NULL;
+		errno = EPROTO;
+		return -1;
+	}
+	ch->map_size = (size_t)st.st_size;
+	ch->data[0] = (char*)base + SB_CHANNEL_HEADER_SIZE;
+	ch->data[1] = ch->data[0] + ch->header->capacity;
+	for (r = 0; r < 2; r++)
+		for (k = 0; k < 2; k++)
+			ch->bells[r][k] = bells[r][k];
+	ch->side = side;
+	ch->peer = -1;
+	return 0;
+}
+
+/**
+ * Child side: maps the channel inherited on the fixed descriptors and watches
+ * @ref SB_CHANNEL_FD_PARENT (when inherited) for the parent going away.
+ * @return 0 on success, -1 on failure (errno set).
+ */
+static inline int sb_channel_attach(sb_channel* ch) {
+	const int bells[2][2] = {
+		{ SB_CHANNEL_FD_BELL(0, SB_CHANNEL_BELL_DATA), SB_CHANNEL_FD_BELL(0, SB_CHANNEL_BELL_SPACE) },
+		{ SB_CHANNEL_FD_BELL(1, SB_CHANNEL_BELL_DATA), SB_CHANNEL_FD_BELL(1, SB_CHANNEL_BELL_SPACE) }
+	};
+	if (sb_channel_open(ch, SB_CHANNEL_FD_MEMORY, bells, SB_CHANNEL_SIDE_CHILD) < 0)
+		return -1;
+	if (fcntl(SB_CHANNEL_FD_PARENT, F_GETFD) >= 0)
+		ch->peer = SB_CHANNEL_FD_PARENT;
+	return 0;
+}
+
+/**
+ * Unmaps the channel (descriptors are left open).
+ */
+static inline void sb_channel_detach(sb_channel* ch) {
+	if (ch->header) {
+		munmap(ch->header, ch->map_size);
+		ch->header = NULL;
+	}
+}
+
+/**
+ * Contiguous readable bytes from the peer.
+ * @param ptr Receives a pointer into shared memory.
+ * @return Readable bytes at @p ptr (0 if empty).
+ */
+static inline size_t sb_channel_peek(const sb_channel* ch, const char** ptr) {
+	const int in = sb_channel_priv_in(ch);
+	sb_channel_ring* ring = &ch->header->rings[in];
+	const uint64_t cap = ch->header->capacity;
+	const uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	const uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+	const uint64_t off = tail & (cap - 1);
+	uint64_t avail = head - tail;
+	if (avail > cap - off)
+		avail = cap - off;
+	*ptr = ch->data[in] + off;
+	return (size_t)avail;
+}
+
+/**
+ * Releases @p n bytes previously obtained with sb_channel_peek().
+ */
+static inline void sb_channel_consume(const sb_channel* ch, size_t n) {
+	const int in = sb_channel_priv_in(ch);
+	sb_channel_ring* ring = &ch->header->rings[in];
+	__atomic_add_fetch(&ring->tail, (uint64_t)n, __ATOMIC_SEQ_CST);
+	sb_channel_priv_notify(&ring->producer_waiting, ch->bells[in][SB_CHANNEL_BELL_SPACE]);
+}
+
+/**
+ * Contiguous writable bytes towards the peer.
+ * @param ptr Receives a pointer into shared memory.
+ * @return Writable bytes at @p ptr (0 if full).
+ */
+static inline size_t sb_channel_reserve(const sb_channel* ch, char** ptr) {
+	const int out = sb_channel_priv_out(ch);
+	sb_channel_ring* ring = &ch->header->rings[out];
+	const uint64_t cap = ch->header->capacity;
+	const uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+	const uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	const uint64_t off = head & (cap - 1);
+	uint64_t space = cap - (head - tail);
+	if (space > cap - off)
+		space = cap - off;
+	*ptr = ch->data[out] + off;
+	return (size_t)space;
+}
+
+/**
+ * Publishes @p n bytes written into a sb_channel_reserve() region.
+ */
+static inline void sb_channel_commit(const sb_channel* ch, size_t n) {
+	const int out = sb_channel_priv_out(ch);
+	sb_channel_ring* ring = &ch->header->rings[out];
+	__atomic_add_fetch(&ring->head, (uint64_t)n, __ATOMIC_SEQ_CST);
+	sb_channel_priv_notify(&ring->consumer_waiting, ch->bells[out][SB_CHANNEL_BELL_DATA]);
+}
+
+/**
+ * Marks this side's outgoing ring as finished.
+ */
+static inline void sb_channel_close(const sb_channel* ch) {
+	const int out = sb_channel_priv_out(ch);
+	sb_channel_ring* ring = &ch->header->rings[out];
+	__atomic_store_n(&ring->closed, 1u, __ATOMIC_SEQ_CST);
+	sb_channel_priv_notify(&ring->consumer_waiting, ch->bells[out][SB_CHANNEL_BELL_DATA]);
+}
+
+/**
+ * @return Non-zero once the peer closed (or the watched peer is gone) and
+ * every byte was consumed.
+ */
+static inline int sb_channel_eof(const sb_channel* ch) {
+	sb_channel_ring* ring = &ch->header->rings[sb_channel_priv_in(ch)];
+	const int closed = (int)__atomic_load_n(&ring->closed, __ATOMIC_ACQUIRE);
+	struct pollfd pfd;
+	if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) != __atomic_load_n(&ring->tail, __ATOMIC_RELAXED))
+		return 0;
+	if (closed || ch->peer < 0)
+		return closed;
+	/* Nothing is ever written: readable only once the peer hung up */
+	pfd.fd = ch->peer;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	if (poll(&pfd, 1, 0) <= 0)
+		return 0;
+	/* Data committed right before the peer went away is still delivered */
+	return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+}
+
+static inline int sb_channel_priv_ready(const sb_channel* ch, int want) {
+	const char* rp;
+	char* wp;
+	if ((want & SB_CHANNEL_WANT_READ) && (sb_channel_peek(ch, &rp) > 0 || __atomic_load_n(&ch->header->rings[sb_channel_priv_in(ch)].closed, __ATOMIC_ACQUIRE)))
+		return 1;
+	if ((want & SB_CHANNEL_WANT_WRITE) && sb_channel_reserve(ch, &wp) > 0)
+		return 1;
+	return 0;
+}
+
+/**
+ * Blocks until the wanted condition holds or @p timeout_ms elapses (-1: forever).
+ * @param want SB_CHANNEL_WANT_READ and/or SB_CHANNEL_WANT_WRITE.
+ * @return 1 if ready, 0 on timeout, -1 on error (errno EPIPE: the watched peer
+ * is gone and the condition can no longer hold).
+ * @note At most one thread may wait for reading and one for writing at a time.
+ */
+static inline int sb_channel_wait(const sb_channel* ch, int want, int timeout_ms) {
+	sb_channel_ring* in = &ch->header->rings[sb_channel_priv_in(ch)];
+	sb_channel_ring* out = &ch->header->rings[sb_channel_priv_out(ch)];
+	for (;;) {
+		struct pollfd pfd[3];
+		nfds_t n = 0, i, peer = 3;
+		uint64_t drained;
+		int r;
+		if (sb_channel_priv_ready(ch, want))
+			return 1;
+		if (want & SB_CHANNEL_WANT_READ) {
+			__atomic_store_n(&in->consumer_waiting, 1u, __ATOMIC_SEQ_CST);
+			pfd[n].fd = ch->bells[sb_channel_priv_in(ch)][SB_CHANNEL_BELL_DATA];
+			pfd[n].events = POLLIN;
+			pfd[n++].revents = 0;
+		}
+		if (want & SB_CHANNEL_WANT_WRITE) {
+			__atomic_store_n(&out->producer_waiting, 1u, __ATOMIC_SEQ_CST);
+			pfd[n].fd = ch->bells[sb_channel_priv_out(ch)][SB_CHANNEL_BELL_SPACE];
+			pfd[n].events = POLLIN;
+			pfd[n++].revents = 0;
+		}
+		if (ch->peer >= 0) {
+			peer = n;
+			pfd[n].fd = ch->peer;
+			pfd[n].events = POLLIN;
+			pfd[n++].revents = 0;
+		}
+		r = sb_channel_priv_ready(ch, want) ? 1 : poll(pfd, n, timeout_ms);
+		if (want & SB_CHANNEL_WANT_READ)
+			__atomic_store_n(&in->consumer_waiting, 0u, __ATOMIC_SEQ_CST);
+		if (want & SB_CHANNEL_WANT_WRITE)
+			__atomic_store_n(&out->producer_waiting, 0u, __ATOMIC_SEQ_CST);
+		if (r < 0 && errno != EINTR)
+			return -1;
+		if (r == 0)
+			return sb_channel_priv_ready(ch, want);
+		if (r > 0 && peer < n && pfd[peer].revents) {
+			/* Nothing is ever written: any event is the hang-up */
+			if (sb_channel_priv_ready(ch, want))
+				return 1;
+			errno = EPIPE;
+			return -1;
+		}
+		for (i = 0; i < n; i++)
+			if (i != peer && (pfd[i].revents & POLLIN))
+				(void)!read(pfd[i].fd, &drained, sizeof(drained));
+	}
+}
+
+#endif /* __linux__ */
+
+#endif /* STORMBYTE_SYSTEM_SHARED_CHANNEL_H */
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+ *
+ * This file is part of StormByte.
+ *
+ * StormByte is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * StormByte is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#ifdef LINUX
+#include <StormByte/system/shared_channel.h>
+
+#include <span>
+#include <string>
+#include <string_view>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	/**
+	 * @class SharedChannel
+	 * @brief Parent side of a memfd-backed bulk data channel shared with one child.
+	 *
+	 * Two single-producer / single-consumer rings (parent → child, child → parent)
+	 * live in one memfd; eventfd doorbells wake a blocked reader or writer. Attach it with
+	 * @ref Process::Options::channel; the child maps it with `sb_channel_attach()`
+	 * from `<StormByte/system/shared_channel.h>`. Stdio stays the control channel.
+	 * Waits end once the child exits, even if it never closed its end (crash,
+	 * `_exit`): remaining data is still delivered, then @ref EoF() holds.
+	 * Likewise a child blocked in `sb_channel_wait()` wakes with EOF once the
+	 * parent (or this object) is gone.
+	 *
+	 * Linux only. Not copyable nor movable (shared through `std::shared_ptr`).
+	 * @note A channel must be attached to a single process.
+	 */
+	class STORMBYTE_SYSTEM_PUBLIC SharedChannel {
+		public:
+			/**
+			 * Default bytes per ring (4 MiB).
+			 */
+			static constexpr const size_t DEFAULT_CAPACITY = 4 * 1024 * 1024;
+
+			/**
+			 * Creates the memfd and doorbells.
+			 * @param capacity Bytes per ring (rounded up to a power of two).
+			 * @throw Exception if the channel cannot be created.
+			 */
+			explicit SharedChannel(size_t capacity = DEFAULT_CAPACITY);
+
+			/**
+			 * Copy constructor (deleted).
+			 */
+			SharedChannel(const SharedChannel&) = delete;
+
+			/**
+			 * Move constructor (deleted).
+			 */
+			SharedChannel(SharedChannel&&) = delete;
+
+			/**
+			 * Copy assignment (deleted).
+			 */
+			SharedChannel& operator=(const SharedChannel&) = delete;
+
+			/**
+			 * Move assignment (deleted).
+			 */
+			SharedChannel& operator=(SharedChannel&&) = delete;
+
+			/**
+			 * Unmaps memory and closes descriptors.
+			 */
+			~SharedChannel() noexcept;
+
+			/**
+			 * @return Bytes per ring.
+			 */
+			size_t Capacity() const noexcept;
+
+			/**
+			 * Contiguous writable region towards the child (may be empty if full).
+			 * @return Span into shared memory.
+			 */
+			std::span<char> Reserve() noexcept;
+
+			/**
+			 * Publishes @p bytes written into the last @ref Reserve() region.
+			 * @param bytes Bytes written.
+			 */
+			void Commit(size_t bytes) noexcept;
+
+			/**
+			 * Contiguous readable region from the child (may be empty).
+			 * @return Span into shared memory.
+			 */
+			std::span<const char> Peek() const noexcept;
+
+			/**
+			 * Releases @p bytes obtained from @ref Peek().
+			 * @param bytes Bytes consumed.
+			 */
+			void Consume(size_t bytes) noexcept;
+
+			/**
+			 * Copies @p data into the ring, waiting for space as needed.
+			 * @param data Data.
+			 * @param timeout_ms Per-wait timeout (-1: forever).
+			 * @return Bytes written (less than size on timeout).
+			 */
+			size_t Write(std::string_view data, int timeout_ms = -1);
+
+			/**
+			 * Appends everything the child sends until it closes its end or exits.
+			 * @param str Destination.
+			 * @param timeout_ms Per-wait timeout (-1: forever).
+			 * @return Bytes read.
+			 */
+			size_t Read(std::string& str, int timeout_ms = -1);
+
+			/**
+			 * Waits until data (or EOF) is available from the child.
+			 * @note One reading thread and one writing thread at most.
+			 * @param timeout_ms Timeout (-1: forever).
+			 * @return true if readable, false on timeout or once the child is gone.
+			 */
+			bool WaitReadable(int timeout_ms = -1) const;
+
+			/**
+			 * Waits until there is space towards the child.
+			 * @param timeout_ms Timeout (-1: forever).
+			 * @return true if writable, false on timeout or once the child is gone.
+			 */
+			bool WaitWritable(int timeout_ms = -1) const;
+
+			/**
+			 * Closes the parent → child direction.
+			 */
+			void Close() noexcept;
+
+			/**
+			 * @return true once the child closed (or exited) and all its data was consumed.
+			 */
+			bool EoF() const noexcept;
+
+		private:
+			friend class Process;
+
+			sb_channel m_channel;		///< Mapped parent view
+			int m_memfd;				///< Backing memfd
+			int m_bells[2][2];			///< Doorbell eventfds by [ring][kind]
+			int m_alive[2];				///< Liveness pipe: the child holds the write end
+			int m_parent[2];			///< Parent liveness pipe: the child holds the read end
+
+			/**
+			 * Child side (after fork): maps descriptors onto the fixed SB_CHANNEL_FD_* slots.
+			 * @note Async-signal-safe.
+			 */
+			void BindChild() const noexcept;
+
+			/**
+			 * Parent side (after fork): drops the parent copies of the child's
+			 * liveness ends, so each pipe hangs up once its holder is gone.
+			 */
+			void Spawned() noexcept;
+
+			/**
+			 * Unmaps memory and closes descriptors.
+			 */
+			void Release() noexcept;
+	};
+}
+#endif
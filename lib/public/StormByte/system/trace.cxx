@@ -0,0 +1,60 @@
+#include <StormByte/system/exception.hxx>
+#include <StormByte/system/trace.hxx>
+#include <StormByte/system/tracer.hxx>
+
+#include <cstdio>
+#include <fstream>
+
+#ifdef WINDOWS
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace StormByte::System;
+
+void Trace::Enable() noexcept {
+	Tracer::s_on.store(true);
+}
+
+void Trace::Disable() noexcept {
+	Tracer::s_on.store(false);
+}
+
+bool Trace::Enabled() noexcept {
+	return Tracer::On();
+}
+
+size_t Trace::Flush(const std::filesystem::path& file) {
+	std::ofstream out(file, std::ios::binary | std::ios::trunc);
+	if (!out)
+		throw FileIOError(file, FileIOError::Operation::Write);
+
+#ifdef WINDOWS
+	const unsigned long pid = GetCurrentProcessId();
+#else
+	const unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	char line[320];
+	const size_t count = Tracer::Drain([&](uint32_t thread, const TraceEvent& event) {
+		// Chrome expects microseconds
+		int length = std::snprintf(line, sizeof(line),
+			"%s\n{\"name\":\"%s\",\"cat\":\"process\",\"ph\":\"%c\",\"ts\":%.3f,",
+			first ? "" : ",", event.name, event.phase, static_cast<double>(event.start) / 1000.0);
+		if (event.phase == 'X')
+			length += std::snprintf(line + length, sizeof(line) - static_cast<size_t>(length), "\"dur\":%.3f,", static_cast<double>(event.duration) / 1000.0);
+		else
+			length += std::snprintf(line + length, sizeof(line) - static_cast<size_t>(length), "\"s\":\"t\",");
+		std::snprintf(line + length, sizeof(line) - static_cast<size_t>(length),
+			"\"pid\":%lu,\"tid\":%u,\"args\":{\"process\":%lld,\"bytes\":%llu}}",
+			pid, thread, static_cast<long long>(event.id), static_cast<unsigned long long>(event.bytes));
+		out << line;
+		first = false;
+	});
+	out << "\n]}\n";
+	if (!out)
+		throw FileIOError(file, FileIOError::Operation::Write);
+	return count;
+}
@@ -0,0 +1,70 @@
+/*
+* Copyright (C) 2024-2026 David C. Manuelda (StormBytePP)
+*
+* This file is part of StormByte.
+*
+* StormByte is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* StormByte is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with StormByte. If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <StormByte/system/visibility.h>
+
+#include <cstddef>
+#include <filesystem>
+
+/**
+ * @namespace System
+ * @brief System utilities: processes, pipes, environment variables.
+ */
+namespace StormByte::System {
+	/**
+	 * @class Trace
+	 * @brief Opt-in recording of process lifecycle and forwarding events.
+	 *
+	 * Records fork/exec, forwarder reads and writes (with byte counts), first
+	 * byte, EOF, wait and reap events into per-thread buffers, and writes them
+	 * as Chrome trace-event JSON (chrome://tracing, Perfetto). While disabled
+	 * each probe costs one relaxed atomic load.
+	 */
+	class STORMBYTE_SYSTEM_PUBLIC Trace {
+		public:
+			/**
+			 * Constructor (deleted: static interface).
+			 */
+			Trace() = delete;
+
+			/**
+			 * Starts recording.
+			 */
+			static void Enable() noexcept;
+
+			/**
+			 * Stops recording; events already recorded are kept until flushed.
+			 */
+			static void Disable() noexcept;
+
+			/**
+			 * @return true while recording.
+			 */
+			static bool Enabled() noexcept;
+
+			/**
+			 * Writes every recorded event to @p file and drops them from memory.
+			 * @param file Output JSON file (overwritten).
+			 * @return Number of events written.
+			 * @throw FileIOError if @p file can not be written.
+			 */
+			static size_t Flush(const std::filesystem::path& file);
+	};
+}
@@ -18,6 +18,50 @@ std::string Variable::Expand(const std::string& var) {
 	return ExpandEnvironmentVariable(var);
 } 
 
+std::string Variable::Expand(const std::string& var, const Environment& env) {
+	std::string expanded;
+	expanded.reserve(var.size());
+	const auto is_name = [](char c, bool first) {
+		return c == '_' || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (!first && c >= '0' && c <= '9');
+	};
+	size_t i = 0;
+	// Only a `~` starting the string and followed by '/' (or nothing) is the home directory
+	if (!var.empty() && var[0] == '~' && (var.size() == 1 || var[1] == '/')) {
+		expanded.append(HomeOf(env));
+		i = 1;
+	}
+	while (i < var.size()) {
+		if (var[i] != '$' || i + 1 == var.size()) {
+			expanded.push_back(var[i++]);
+			continue;
+		}
+		const bool braced = var[i + 1] == '{';
+		const size_t start = braced ? i + 2 : i + 1;
+		size_t end = start;
+		while (end < var.size() && is_name(var[end], end == start))
+			end++;
+		// Not a name (or an unterminated `${`): the `$` is literal
+		if (end == start || (braced && (end == var.size() || var[end] != '}'))) {
+			expanded.push_back(var[i++]);
+			continue;
+		}
+		if (const auto value = env.Get(std::string_view(var).substr(start, end - start)))
+			expanded.append(*value);
+		i = braced ? end + 1 : end;
+	}
+	return expanded;
+}
+
+std::string Variable::HomeOf(const Environment& env) {
+	#ifdef WINDOWS
+	const auto home = env.Get("USERPROFILE");
+	return home ? std::string(*home) : std::string();
+	#else
+	const auto home = env.Get("HOME");
+	return home ? std::string(*home) : HomePath().string();
+	#endif
+}
+
 #ifdef WINDOWS
 std::string Variable::Expand(const std::wstring& var) {
 	return ExpandEnvironmentVariable(var);
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <StormByte/system/environment.hxx>
 #include <StormByte/system/visibility.h>
 
 #include <filesystem>
@@ -34,6 +35,8 @@ namespace StormByte::System {
 	 * @brief Environment variable expansion helpers.
 	 *
 	 * On Windows uses ExpandEnvironmentStrings; on UNIX expands `~` to the home path.
+	 * The @ref Environment overload resolves `$NAME`, `${NAME}` and `~` against
+	 * a snapshot instead of the process environment, on every platform.
 	 */
 	class STORMBYTE_SYSTEM_PUBLIC Variable {
 		public:
@@ -44,6 +47,15 @@ namespace StormByte::System {
 			 */
 			static std::string Expand(const std::string& str);
 
+			/**
+			 * Expands `$NAME`, `${NAME}` (unset names become empty) and a leading
+			 * `~` (from `HOME`, else the user home path) using @p env.
+			 * @param str Input string.
+			 * @param env Environment looked up.
+			 * @return Expanded string.
+			 */
+			static std::string Expand(const std::string& str, const Environment& env);
+
 			#ifdef WINDOWS
 			/**
 			 * Expands environment variables in a wide string.
@@ -61,6 +73,12 @@ namespace StormByte::System {
 			 */
 			static std::string ExpandEnvironmentVariable(const std::string& str);
 
+			/**
+			 * @param env Environment.
+			 * @return Home directory of @p env.
+			 */
+			static std::string HomeOf(const Environment& env);
+
 			#ifdef WINDOWS
 			/**
 			 * Platform implementation for wide strings.
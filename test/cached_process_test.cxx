@@ -0,0 +1,209 @@
+#include <StormByte/system/cached_process.hxx>
+#include <StormByte/system/result_cache.hxx>
+#include <StormByte/test_handlers.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using StormByte::System::CachedProcess;
+using StormByte::System::CacheKey;
+using StormByte::System::Process;
+using StormByte::System::ResultCache;
+
+#ifdef UNIX
+
+std::filesystem::path FreshStore(const std::string& name) {
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / ("stormbyte_" + name);
+	std::filesystem::remove_all(dir);
+	return dir;
+}
+
+int test_cached_hit_skips_spawn() {
+	const std::filesystem::path dir = FreshStore("cache_hit");
+	const std::filesystem::path counter = dir / "runs";
+	auto cache = std::make_shared<ResultCache>(dir, 1 << 20);
+	// Each real run appends to the counter file, so spawns can be counted
+	const std::vector<std::string> args = { "-c", "echo run >> " + counter.string() + "; tr a-z A-Z; echo oops >&2; exit 3" };
+
+	CachedProcess first(cache, "sh", args);
+	first << "hello ";
+	first << "world\n";
+	first << StormByte::System::EoF;
+	std::string out, err;
+	first >> out;
+	first.Stderr(err);
+	ASSERT_FALSE("test_cached_hit_skips_spawn", first.Hit());
+	ASSERT_EQUAL("test_cached_hit_skips_spawn", "HELLO WORLD\n", out);
+	ASSERT_EQUAL("test_cached_hit_skips_spawn", "oops\n", err);
+	ASSERT_EQUAL("test_cached_hit_skips_spawn", 3, first.Wait());
+
+	// Same stdin split differently: same key
+	CachedProcess second(cache, "sh", args);
+	second << "hello world\n";
+	std::string cached, cached_err;
+	second >> cached;
+	second.Stderr(cached_err);
+	ASSERT_TRUE("test_cached_hit_skips_spawn", second.Hit());
+	ASSERT_TRUE("test_cached_hit_skips_spawn", first.Key() == second.Key());
+	ASSERT_EQUAL("test_cached_hit_skips_spawn", out, cached);
+	ASSERT_EQUAL("test_cached_hit_skips_spawn", err, cached_err);
+	ASSERT_EQUAL("test_cached_hit_skips_spawn", 3, second.Wait());
+
+	// Output is handed out once, as with a pipe
+	std::string again;
+	second >> again;
+	ASSERT_TRUE("test_cached_hit_skips_spawn", again.empty());
+
+	std::ifstream runs(counter);
+	std::stringstream ss;
+	ss << runs.rdbuf();
+	ASSERT_EQUAL("test_cached_hit_skips_spawn", "run\n", ss.str());
+
+	const ResultCache::Stats stats = cache->Statistics();
+	ASSERT_EQUAL("test_cached_hit_skips_spawn", 1u, stats.hits);
+	ASSERT_EQUAL("test_cached_hit_skips_spawn", 1u, stats.misses);
+	ASSERT_EQUAL("test_cached_hit_skips_spawn", 1u, stats.entries);
+
+	std::filesystem::remove_all(dir);
+	RETURN_TEST("test_cached_hit_skips_spawn", 0);
+}
+
+int test_cached_key_inputs() {
+	const std::filesystem::path dir = FreshStore("cache_keys");
+	auto cache = std::make_shared<ResultCache>(dir, 1 << 20);
+
+	const auto key_of = [&cache](const std::vector<std::string>& args, const std::string& input, const std::string& value) {
+		Process::Options opts;
+		opts.environment = StormByte::System::Environment({ "SB_KEYED=" + value, "SB_IGNORED=" + input });
+		CachedProcess proc(cache, "/bin/cat", args, { "SB_KEYED" }, opts);
+		proc << input;
+		return proc.Key();
+	};
+	const CacheKey base = key_of({}, "data", "1");
+	ASSERT_TRUE("test_cached_key_inputs", base == key_of({}, "data", "1"));
+	ASSERT_FALSE("test_cached_key_inputs", base == key_of({ "-" }, "data", "1"));
+	ASSERT_FALSE("test_cached_key_inputs", base == key_of({}, "datA", "1"));
+	ASSERT_FALSE("test_cached_key_inputs", base == key_of({}, "data", "2"));
+	// Argument boundaries are part of the key
+	ASSERT_FALSE("test_cached_key_inputs", key_of({ "ab", "c" }, "", "1") == key_of({ "a", "bc" }, "", "1"));
+
+	std::filesystem::remove_all(dir);
+	RETURN_TEST("test_cached_key_inputs", 0);
+}
+
+int test_cached_not_stored_on_signal() {
+	const std::filesystem::path dir = FreshStore("cache_signal");
+	auto cache = std::make_shared<ResultCache>(dir, 1 << 20);
+
+	for (int i = 0; i < 2; i++) {
+		CachedProcess proc(cache, "/bin/sh", { "-c", "kill -KILL $$" });
+		ASSERT_EQUAL("test_cached_not_stored_on_signal", -1, proc.Wait());
+		ASSERT_FALSE("test_cached_not_stored_on_signal", proc.Hit());
+	}
+	ASSERT_EQUAL("test_cached_not_stored_on_signal", 0u, cache->Statistics().entries);
+
+	std::filesystem::remove_all(dir);
+	RETURN_TEST("test_cached_not_stored_on_signal", 0);
+}
+
+int test_cache_lru_eviction() {
+	const std::filesystem::path dir = FreshStore("cache_lru");
+	const std::string payload(1000, 'x');
+	{
+		// Room for two entries (48 byte header each)
+		ResultCache cache(dir, 2200);
+		ASSERT_TRUE("test_cache_lru_eviction", cache.Insert(CacheKey { 0, 1 }, 0, payload, ""));
+		ASSERT_TRUE("test_cache_lru_eviction", cache.Insert(CacheKey { 0, 2 }, 0, payload, ""));
+		// Touch 1 so 2 is the least recently used
+		ASSERT_TRUE("test_cache_lru_eviction", cache.Lookup(CacheKey { 0, 1 }).has_value());
+		ASSERT_TRUE("test_cache_lru_eviction", cache.Insert(CacheKey { 0, 3 }, 0, payload, ""));
+
+		ASSERT_TRUE("test_cache_lru_eviction", cache.Lookup(CacheKey { 0, 1 }).has_value());
+		ASSERT_FALSE("test_cache_lru_eviction", cache.Lookup(CacheKey { 0, 2 }).has_value());
+		ASSERT_TRUE("test_cache_lru_eviction", cache.Lookup(CacheKey { 0, 3 }).has_value());
+		ASSERT_EQUAL("test_cache_lru_eviction", 1u, cache.Statistics().evictions);
+		ASSERT_FALSE("test_cache_lru_eviction", cache.Insert(CacheKey { 0, 4 }, 0, std::string(3000, 'y'), ""));
+	}
+
+	// Reopened: entries are indexed again, damaged ones dropped on lookup
+	{
+		std::ofstream damaged(dir / (CacheKey { 0, 3 }.Hex() + ".res"), std::ios::binary | std::ios::trunc);
+		damaged << "garbage";
+	}
+	ResultCache reopened(dir, 2200);
+	ASSERT_EQUAL("test_cache_lru_eviction", 2u, reopened.Statistics().entries);
+	const auto kept = reopened.Lookup(CacheKey { 0, 1 });
+	ASSERT_TRUE("test_cache_lru_eviction", kept.has_value());
+	ASSERT_EQUAL("test_cache_lru_eviction", payload, std::string(kept->Stdout()));
+	ASSERT_FALSE("test_cache_lru_eviction", reopened.Lookup(CacheKey { 0, 3 }).has_value());
+	ASSERT_EQUAL("test_cache_lru_eviction", 1u, reopened.Statistics().entries);
+
+	// A mapped result outlives its entry
+	reopened.Clear();
+	ASSERT_EQUAL("test_cache_lru_eviction", payload, std::string(kept->Stdout()));
+	ASSERT_EQUAL("test_cache_lru_eviction", 0u, reopened.Statistics().bytes);
+
+	std::filesystem::remove_all(dir);
+	RETURN_TEST("test_cache_lru_eviction", 0);
+}
+
+int test_cache_corrupt_sizes() {
+	const std::filesystem::path dir = FreshStore("cache_corrupt");
+	const CacheKey key { 0, 1 };
+	{
+		ResultCache cache(dir, 1 << 20);
+		ASSERT_TRUE("test_cache_corrupt_sizes", cache.Insert(key, 0, "out", "err"));
+	}
+
+	// Sizes whose difference wraps around: must be a miss, not an out of range read
+	const std::filesystem::path file = dir / (key.Hex() + ".res");
+	std::string entry;
+	{
+		std::ifstream in(file, std::ios::binary);
+		entry.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+	entry.resize(48);
+	const uint64_t out_size = 1, err_size = UINT64_MAX;
+	std::memcpy(entry.data() + 32, &out_size, sizeof(out_size));
+	std::memcpy(entry.data() + 40, &err_size, sizeof(err_size));
+	{
+		std::ofstream out(file, std::ios::binary | std::ios::trunc);
+		out << entry;
+	}
+
+	ResultCache reopened(dir, 1 << 20);
+	ASSERT_FALSE("test_cache_corrupt_sizes", reopened.Lookup(key).has_value());
+	ASSERT_EQUAL("test_cache_corrupt_sizes", 0u, reopened.Statistics().entries);
+	ASSERT_FALSE("test_cache_corrupt_sizes", std::filesystem::exists(file));
+
+	std::filesystem::remove_all(dir);
+	RETURN_TEST("test_cache_corrupt_sizes", 0);
+}
+
+#endif
+
+int main() {
+	int result = 0;
+
+#ifdef UNIX
+	result += test_cached_hit_skips_spawn();
+	result += test_cached_key_inputs();
+	result += test_cached_not_stored_on_signal();
+	result += test_cache_lru_eviction();
+	result += test_cache_corrupt_sizes();
+#endif
+
+	if (result == 0) {
+		std::cout << "All tests passed!" << std::endl;
+	} else {
+		std::cout << result << " tests failed." << std::endl;
+	}
+	return result;
+}
@@ -0,0 +1,225 @@
+#include <StormByte/system/process.hxx>
+#include <StormByte/test_handlers.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using StormByte::System::CapturePolicy;
+using StormByte::System::CaptureResult;
+using StormByte::System::MappedOutput;
+using StormByte::System::Process;
+
+#ifdef UNIX
+
+// `seq 1 100000` writes 588895 bytes
+constexpr const uint64_t SEQ_BYTES = 588895;
+
+int test_capture_full() {
+	Process proc("/bin/sh", { "-c", "printf 'out'; printf 'err' >&2" });
+	ASSERT_TRUE("test_capture_full", proc.Capture(Process::Stream::STDOUT, CapturePolicy::Full()));
+	ASSERT_TRUE("test_capture_full", proc.Capture(Process::Stream::STDERR, CapturePolicy::Full()));
+	ASSERT_FALSE("test_capture_full", proc.Capture(Process::Stream::STDERR, CapturePolicy::Full()));
+
+	const CaptureResult out = proc.Captured(Process::Stream::STDOUT);
+	const CaptureResult err = proc.Captured(Process::Stream::STDERR);
+	ASSERT_EQUAL("test_capture_full", 0, proc.Wait());
+	ASSERT_EQUAL("test_capture_full", "out", out.data);
+	ASSERT_EQUAL("test_capture_full", "err", err.data);
+	ASSERT_FALSE("test_capture_full", out.truncated);
+
+	RETURN_TEST("test_capture_full", 0);
+}
+
+int test_capture_head() {
+	Process proc("/usr/bin/seq", { "1", "100000" });
+	proc.Capture(Process::Stream::STDOUT, CapturePolicy::Head(10));
+
+	const CaptureResult result = proc.Captured(Process::Stream::STDOUT);
+	ASSERT_EQUAL("test_capture_head", 0, proc.Wait());
+	ASSERT_EQUAL("test_capture_head", "1\n2\n3\n4\n5\n", result.data);
+	ASSERT_EQUAL("test_capture_head", SEQ_BYTES, result.total);
+	ASSERT_TRUE("test_capture_head", result.truncated);
+
+	RETURN_TEST("test_capture_head", 0);
+}
+
+int test_capture_tail() {
+	Process proc("/usr/bin/seq", { "1", "100000" });
+	proc.Capture(Process::Stream::STDOUT, CapturePolicy::Tail(13));
+
+	const CaptureResult result = proc.Captured(Process::Stream::STDOUT);
+	ASSERT_EQUAL("test_capture_tail", 0, proc.Wait());
+	ASSERT_EQUAL("test_capture_tail", "99999\n100000\n", result.data);
+	ASSERT_EQUAL("test_capture_tail", SEQ_BYTES, result.total);
+
+	RETURN_TEST("test_capture_tail", 0);
+}
+
+int test_capture_head_tail() {
+	Process proc("/usr/bin/seq", { "1", "100000" });
+	proc.Capture(Process::Stream::STDOUT, CapturePolicy::HeadTail(4, 7));
+
+	const CaptureResult result = proc.Captured(Process::Stream::STDOUT);
+	ASSERT_EQUAL("test_capture_head_tail", 0, proc.Wait());
+	const std::string expected = "1\n2\n\n[... " + std::to_string(SEQ_BYTES - 11) + " bytes truncated ...]\n100000\n";
+	ASSERT_EQUAL("test_capture_head_tail", expected, result.data);
+	ASSERT_TRUE("test_capture_head_tail", result.truncated);
+
+	RETURN_TEST("test_capture_head_tail", 0);
+}
+
+int test_capture_head_tail_fits() {
+	// Everything kept: no marker
+	Process proc("/usr/bin/seq", { "1", "5" });
+	proc.Capture(Process::Stream::STDOUT, CapturePolicy::HeadTail(4, 64));
+
+	const CaptureResult result = proc.Captured(Process::Stream::STDOUT);
+	ASSERT_EQUAL("test_capture_head_tail_fits", "1\n2\n3\n4\n5\n", result.data);
+	ASSERT_FALSE("test_capture_head_tail_fits", result.truncated);
+
+	RETURN_TEST("test_capture_head_tail_fits", 0);
+}
+
+int test_capture_discard_large() {
+	// 64 MiB on stderr while stdout is kept: the child never blocks
+	Process proc("/bin/sh", { "-c", "head -c 67108864 /dev/zero >&2; echo done" });
+	proc.Capture(Process::Stream::STDERR, CapturePolicy::Discard());
+	proc.Capture(Process::Stream::STDOUT, CapturePolicy::Tail(64));
+
+	ASSERT_EQUAL("test_capture_discard_large", 0, proc.Wait());
+	const CaptureResult err = proc.Captured(Process::Stream::STDERR);
+	ASSERT_EQUAL("test_capture_discard_large", 67108864u, err.total);
+	ASSERT_TRUE("test_capture_discard_large", err.data.empty());
+	ASSERT_EQUAL("test_capture_discard_large", "done\n", proc.Captured(Process::Stream::STDOUT).data);
+
+	RETURN_TEST("test_capture_discard_large", 0);
+}
+
+int test_merged_stderr() {
+	Process::Options opts;
+	opts.merge_stderr = true;
+	Process proc("/bin/sh", { "-c", "echo a; echo b >&2; echo c" }, opts);
+
+	std::string out, err;
+	proc >> out;
+	proc.Stderr(err);
+	ASSERT_EQUAL("test_merged_stderr", 0, proc.Wait());
+	ASSERT_EQUAL("test_merged_stderr", "a\nb\nc\n", out);
+	ASSERT_TRUE("test_merged_stderr", err.empty());
+
+	RETURN_TEST("test_merged_stderr", 0);
+}
+
+int test_capture_interleaved_order() {
+	Process proc("/bin/sh", { "-c", "echo a; sleep 0.1; echo b >&2; sleep 0.1; echo c" });
+	ASSERT_TRUE("test_capture_interleaved_order", proc.CaptureInterleaved());
+	ASSERT_FALSE("test_capture_interleaved_order", proc.Capture(Process::Stream::STDOUT, CapturePolicy::Full()));
+
+	const std::vector<Process::Chunk> chunks = proc.Interleaved();
+	ASSERT_EQUAL("test_capture_interleaved_order", 0, proc.Wait());
+	ASSERT_EQUAL("test_capture_interleaved_order", 3u, chunks.size());
+	ASSERT_TRUE("test_capture_interleaved_order", chunks[0].stream == Process::Stream::STDOUT);
+	ASSERT_EQUAL("test_capture_interleaved_order", "a\n", chunks[0].data);
+	ASSERT_TRUE("test_capture_interleaved_order", chunks[1].stream == Process::Stream::STDERR);
+	ASSERT_EQUAL("test_capture_interleaved_order", "b\n", chunks[1].data);
+	ASSERT_TRUE("test_capture_interleaved_order", chunks[2].stream == Process::Stream::STDOUT);
+	ASSERT_EQUAL("test_capture_interleaved_order", "c\n", chunks[2].data);
+	ASSERT_TRUE("test_capture_interleaved_order", chunks[0].time <= chunks[1].time && chunks[1].time <= chunks[2].time);
+
+	RETURN_TEST("test_capture_interleaved_order", 0);
+}
+
+int test_capture_interleaved_no_deadlock() {
+	// stderr filled first: reading stdout to EOF first would block forever
+	Process proc("/bin/sh", { "-c", "head -c 4194304 /dev/zero >&2; head -c 4194304 /dev/zero" });
+	proc.CaptureInterleaved();
+
+	size_t out = 0, err = 0;
+	for (const Process::Chunk& chunk: proc.Interleaved())
+		(chunk.stream == Process::Stream::STDOUT ? out : err) += chunk.data.size();
+	ASSERT_EQUAL("test_capture_interleaved_no_deadlock", 0, proc.Wait());
+	ASSERT_EQUAL("test_capture_interleaved_no_deadlock", 4194304u, out);
+	ASSERT_EQUAL("test_capture_interleaved_no_deadlock", 4194304u, err);
+
+	RETURN_TEST("test_capture_interleaved_no_deadlock", 0);
+}
+
+int test_memory_output() {
+	Process::Options opts;
+	opts.memory_stdout = true;
+	opts.memory_stderr = true;
+	Process proc("/bin/sh", { "-c", "seq 1 100000; printf err >&2; exit 4" }, opts);
+
+	// The pipes are left unused
+	std::string piped;
+	proc >> piped;
+	ASSERT_TRUE("test_memory_output", piped.empty());
+	ASSERT_EQUAL("test_memory_output", 4, proc.Wait());
+
+	const MappedOutput out = proc.Mapped(Process::Stream::STDOUT);
+	ASSERT_EQUAL("test_memory_output", SEQ_BYTES, out.Size());
+	ASSERT_TRUE("test_memory_output", out.View().starts_with("1\n2\n3\n"));
+	ASSERT_TRUE("test_memory_output", out.View().ends_with("\n100000\n"));
+	ASSERT_EQUAL("test_memory_output", out.Size(), out.Span().size());
+	// Same mapping on later calls
+	ASSERT_TRUE("test_memory_output", proc.Mapped(Process::Stream::STDOUT).View().data() == out.View().data());
+	ASSERT_EQUAL("test_memory_output", "err", std::string(proc.Mapped(Process::Stream::STDERR).View()));
+
+	RETURN_TEST("test_memory_output", 0);
+}
+
+int test_memory_output_outlives_process() {
+	MappedOutput out;
+	{
+		Process::Options opts;
+		opts.memory_stdout = true;
+		opts.merge_stderr = true;
+		opts.memory_stderr = true;
+		// Mapped() waits for the child itself
+		Process proc("/bin/sh", { "-c", "echo a; echo b >&2; echo c" }, opts);
+		Process moved(std::move(proc));
+		ASSERT_TRUE("test_memory_output_outlives_process", proc.Mapped(Process::Stream::STDOUT).View().empty());
+		out = moved.Mapped(Process::Stream::STDOUT);
+		// Merged: stderr went to the stdout file
+		ASSERT_TRUE("test_memory_output_outlives_process", moved.Mapped(Process::Stream::STDERR).View().empty());
+	}
+	ASSERT_EQUAL("test_memory_output_outlives_process", "a\nb\nc\n", std::string(out.View()));
+
+	// Not sent to memory (or nothing written): empty
+	Process piped("/bin/true");
+	ASSERT_EQUAL("test_memory_output_outlives_process", 0u, piped.Mapped(Process::Stream::STDOUT).Size());
+	Process::Options opts;
+	opts.memory_stdout = true;
+	Process silent("/bin/true", {}, opts);
+	ASSERT_EQUAL("test_memory_output_outlives_process", 0u, silent.Mapped(Process::Stream::STDOUT).Size());
+
+	RETURN_TEST("test_memory_output_outlives_process", 0);
+}
+
+#endif
+
+int main() {
+	int result = 0;
+
+#ifdef UNIX
+	result += test_capture_full();
+	result += test_capture_head();
+	result += test_capture_tail();
+	result += test_capture_head_tail();
+	result += test_capture_head_tail_fits();
+	result += test_capture_discard_large();
+	result += test_merged_stderr();
+	result += test_capture_interleaved_order();
+	result += test_capture_interleaved_no_deadlock();
+	result += test_memory_output();
+	result += test_memory_output_outlives_process();
+#endif
+
+	if (result == 0) {
+		std::cout << "All tests passed!" << std::endl;
+	} else {
+		std::cout << result << " tests failed." << std::endl;
+	}
+	return result;
+}
@@ -0,0 +1,234 @@
+#include <StormByte/system/command.hxx>
+#include <StormByte/system/exception.hxx>
+#include <StormByte/system/process.hxx>
+#include <StormByte/test_handlers.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef UNIX
+
+namespace {
+
+// Writes an executable shell script printing @p text into @p dir
+void write_script(const std::filesystem::path& dir, const std::string& text) {
+	std::filesystem::create_directories(dir);
+	const std::filesystem::path file = dir / "sb-command-test";
+	std::ofstream(file) << "#!/bin/sh\necho " << text << "\n";
+	std::filesystem::permissions(file, std::filesystem::perms::owner_all);
+}
+
+// Replaces @p file with a new inode holding a script printing @p text
+void replace_script(const std::filesystem::path& file, const std::string& text, std::filesystem::perms perms) {
+	// Written aside while the old file still exists, so the inodes differ
+	const std::filesystem::path aside = file.string() + ".new";
+	std::ofstream(aside) << "#!/bin/sh\necho " << text << "\n";
+	std::filesystem::permissions(aside, perms);
+	std::filesystem::rename(aside, file);
+}
+
+} // namespace
+
+int test_command_resolves_path() {
+	StormByte::System::Command cmd("sh", { "-c", "echo resolved" });
+	const std::filesystem::path resolved = cmd.Resolve();
+	ASSERT_TRUE("test_command_resolves_path", resolved.is_absolute());
+	ASSERT_EQUAL("test_command_resolves_path", "sh", resolved.filename().string());
+	ASSERT_EQUAL("test_command_resolves_path", resolved, cmd.Resolve());
+
+	StormByte::System::Process proc(cmd);
+	std::string output;
+	proc >> output;
+	ASSERT_EQUAL("test_command_resolves_path", "resolved\n", output);
+	ASSERT_EQUAL("test_command_resolves_path", 0, proc.Wait());
+
+	RETURN_TEST("test_command_resolves_path", 0);
+}
+
+int test_command_substitutions() {
+	StormByte::System::Command cmd("printf", { "%s|%s", "{}", "x{}y" });
+	ASSERT_EQUAL("test_command_substitutions", 2u, cmd.Placeholders());
+
+	for (int i = 0; i < 50; i++) {
+		StormByte::System::Process proc(cmd, { std::to_string(i), "-" });
+		std::string output;
+		proc >> output;
+		ASSERT_EQUAL("test_command_substitutions", std::to_string(i) + "|x-y", output);
+		ASSERT_EQUAL("test_command_substitutions", 0, proc.Wait());
+	}
+
+	bool thrown = false;
+	try {
+		StormByte::System::Process proc(cmd, { "only one" });
+	} catch (const StormByte::System::Exception&) {
+		thrown = true;
+	}
+	ASSERT_TRUE("test_command_substitutions", thrown);
+
+	RETURN_TEST("test_command_substitutions", 0);
+}
+
+int test_command_environment() {
+	StormByte::System::Command cmd("/bin/sh", { "-c", "echo \"$SB_VALUE:$HOME\"" }, { "SB_VALUE=prepared" });
+	StormByte::System::Command copy = cmd;
+
+	StormByte::System::Process proc(copy);
+	std::string output;
+	proc >> output;
+	ASSERT_EQUAL("test_command_environment", "prepared:\n", output);
+	ASSERT_EQUAL("test_command_environment", 0, proc.Wait());
+
+	RETURN_TEST("test_command_environment", 0);
+}
+
+int test_command_not_found() {
+	StormByte::System::Command cmd("sb-command-does-not-exist");
+	bool thrown = false;
+	try {
+		StormByte::System::Process proc(cmd);
+	} catch (const StormByte::System::ExecutableNotFound&) {
+		thrown = true;
+	}
+	ASSERT_TRUE("test_command_not_found", thrown);
+
+	RETURN_TEST("test_command_not_found", 0);
+}
+
+int test_command_path_change() {
+	const std::filesystem::path base = std::filesystem::temp_directory_path() / ("sb-command-" + std::to_string(getpid()));
+	write_script(base / "first", "first");
+	write_script(base / "second", "second");
+
+	const char* saved = std::getenv("PATH");
+	const std::string original = saved ? saved : "";
+	StormByte::System::Command cmd("sb-command-test");
+
+	setenv("PATH", (base / "first").c_str(), 1);
+	const std::filesystem::path first = cmd.Resolve();
+	setenv("PATH", (base / "second").c_str(), 1);
+	const std::filesystem::path second = cmd.Resolve();
+
+	StormByte::System::Process proc(cmd);
+	std::string output;
+	proc >> output;
+	proc.Wait();
+
+	setenv("PATH", original.c_str(), 1);
+	std::filesystem::remove_all(base);
+
+	ASSERT_EQUAL("test_command_path_change", base / "first" / "sb-command-test", first);
+	ASSERT_EQUAL("test_command_path_change", base / "second" / "sb-command-test", second);
+	ASSERT_EQUAL("test_command_path_change", "second\n", output);
+
+	RETURN_TEST("test_command_path_change", 0);
+}
+
+int test_command_file_replaced() {
+	const std::filesystem::path base = std::filesystem::temp_directory_path() / ("sb-command-replaced-" + std::to_string(getpid()));
+	write_script(base / "first", "first");
+	write_script(base / "second", "second");
+	const std::filesystem::path script = base / "first" / "sb-command-test";
+
+	const char* saved = std::getenv("PATH");
+	const std::string original = saved ? saved : "";
+	setenv("PATH", ((base / "first").string() + ":" + (base / "second").string()).c_str(), 1);
+	StormByte::System::Command cmd("sb-command-test");
+
+	const auto run = [&cmd] {
+		StormByte::System::Process proc(cmd);
+		std::string output;
+		proc >> output;
+		proc.Wait();
+		return output;
+	};
+	const std::string before = run();
+
+	// Same path, new inode: the next spawn runs the new file
+	replace_script(script, "replaced", std::filesystem::perms::owner_all);
+	const std::filesystem::path same = cmd.Resolve();
+	const std::string replaced = run();
+
+	// New inode that is not executable: resolution moves on along PATH
+	replace_script(script, "unusable", std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+	const std::filesystem::path moved = cmd.Resolve();
+	const std::string fallback = run();
+
+	setenv("PATH", original.c_str(), 1);
+	std::filesystem::remove_all(base);
+
+	ASSERT_EQUAL("test_command_file_replaced", "first\n", before);
+	ASSERT_EQUAL("test_command_file_replaced", script, same);
+	ASSERT_EQUAL("test_command_file_replaced", "replaced\n", replaced);
+	ASSERT_EQUAL("test_command_file_replaced", base / "second" / "sb-command-test", moved);
+	ASSERT_EQUAL("test_command_file_replaced", "second\n", fallback);
+
+	RETURN_TEST("test_command_file_replaced", 0);
+}
+
+int test_command_child_path() {
+	using StormByte::System::Environment;
+	const std::filesystem::path base = std::filesystem::temp_directory_path() / ("sb-command-child-" + std::to_string(getpid()));
+	write_script(base / "parent", "parent");
+	write_script(base / "child", "child");
+
+	const char* saved = std::getenv("PATH");
+	const std::string original = saved ? saved : "";
+	setenv("PATH", (base / "parent").c_str(), 1);
+	const Environment child = Environment::Current().Set("PATH", (base / "child").string());
+
+	const auto run = [](const StormByte::System::Command& cmd, const StormByte::System::Process::Options& opts) {
+		StormByte::System::Process proc(cmd, {}, opts);
+		std::string output;
+		proc >> output;
+		proc.Wait();
+		return output;
+	};
+
+	// The PATH of the environment the child gets decides, whichever carries it
+	const StormByte::System::Command own("sb-command-test", {}, child);
+	const std::filesystem::path resolved = own.Resolve();
+	const std::string own_output = run(own, {});
+
+	const StormByte::System::Command plain("sb-command-test");
+	StormByte::System::Process::Options opts;
+	opts.environment = child;
+	const std::string options_output = run(plain, opts);
+	const std::string parent_output = run(plain, {});
+
+	setenv("PATH", original.c_str(), 1);
+	std::filesystem::remove_all(base);
+
+	ASSERT_EQUAL("test_command_child_path", base / "child" / "sb-command-test", resolved);
+	ASSERT_EQUAL("test_command_child_path", "child\n", own_output);
+	ASSERT_EQUAL("test_command_child_path", "child\n", options_output);
+	ASSERT_EQUAL("test_command_child_path", "parent\n", parent_output);
+
+	RETURN_TEST("test_command_child_path", 0);
+}
+
+#endif
+
+int main() {
+	int result = 0;
+
+#ifdef UNIX
+	result += test_command_resolves_path();
+	result += test_command_substitutions();
+	result += test_command_environment();
+	result += test_command_not_found();
+	result += test_command_path_change();
+	result += test_command_file_replaced();
+	result += test_command_child_path();
+#endif
+
+	if (result == 0) {
+		std::cout << "All tests passed!" << std::endl;
+	} else {
+		std::cout << result << " tests failed." << std::endl;
+	}
+	return result;
+}
@@ -0,0 +1,93 @@
+#include <StormByte/system/coprocess.hxx>
+#include <StormByte/system/exception.hxx>
+#include <StormByte/test_handlers.h>
+
+#include <future>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef UNIX
+
+int test_coprocess_pipelined() {
+	StormByte::System::Coprocess cat("/bin/cat");
+
+	std::vector<std::future<std::string>> responses;
+	for (int i = 0; i < 2000; i++)
+		responses.push_back(cat.Submit("request-" + std::to_string(i)));
+
+	for (int i = 0; i < 2000; i++)
+		ASSERT_EQUAL("test_coprocess_pipelined", "request-" + std::to_string(i), responses[i].get());
+	ASSERT_EQUAL("test_coprocess_pipelined", 0u, cat.Restarts());
+
+	RETURN_TEST("test_coprocess_pipelined", 0);
+}
+
+int test_coprocess_custom_delimiter() {
+	StormByte::System::Coprocess::Options opts;
+	opts.delimiter = '\0';
+	StormByte::System::Coprocess cat("/bin/cat", {}, opts);
+
+	auto first = cat.Submit("multi\nline");
+	auto second = cat.Submit("abc");
+
+	ASSERT_EQUAL("test_coprocess_custom_delimiter", "multi\nline", first.get());
+	ASSERT_EQUAL("test_coprocess_custom_delimiter", "abc", second.get());
+
+	RETURN_TEST("test_coprocess_custom_delimiter", 0);
+}
+
+int test_coprocess_restart() {
+	// Child answers two requests, then exits: unanswered requests must be resent
+	StormByte::System::Coprocess::Options opts;
+	opts.max_restarts = 10;
+	StormByte::System::Coprocess sh("/bin/sh", { "-c", "read l; echo \"$l\"; read l; echo \"$l\"" }, opts);
+
+	std::vector<std::future<std::string>> responses;
+	for (int i = 0; i < 6; i++)
+		responses.push_back(sh.Submit(std::to_string(i)));
+
+	for (int i = 0; i < 6; i++)
+		ASSERT_EQUAL("test_coprocess_restart", std::to_string(i), responses[i].get());
+	ASSERT_TRUE("test_coprocess_restart", sh.Restarts() >= 2);
+
+	RETURN_TEST("test_coprocess_restart", 0);
+}
+
+int test_coprocess_restarts_exhausted() {
+	StormByte::System::Coprocess::Options opts;
+	opts.max_restarts = 2;
+	StormByte::System::Coprocess broken("/usr/bin/false", {}, opts);
+
+	auto response = broken.Submit("anything");
+	bool thrown = false;
+	try {
+		response.get();
+	} catch (const StormByte::System::Exception&) {
+		thrown = true;
+	}
+	ASSERT_TRUE("test_coprocess_restarts_exhausted", thrown);
+	ASSERT_EQUAL("test_coprocess_restarts_exhausted", 2u, broken.Restarts());
+
+	RETURN_TEST("test_coprocess_restarts_exhausted", 0);
+}
+
+#endif
+
+int main() {
+	int result = 0;
+
+#ifdef UNIX
+	result += test_coprocess_pipelined();
+	result += test_coprocess_custom_delimiter();
+	result += test_coprocess_restart();
+	result += test_coprocess_restarts_exhausted();
+#endif
+
+	if (result == 0) {
+		std::cout << "All tests passed!" << std::endl;
+	} else {
+		std::cout << result << " tests failed." << std::endl;
+	}
+	return result;
+}
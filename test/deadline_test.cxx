@@ -0,0 +1,159 @@
+#include <StormByte/system/process.hxx>
+#include <StormByte/test_handlers.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using StormByte::System::Process;
+using namespace std::chrono_literals;
+
+#ifdef UNIX
+
+int test_deadline_terminates() {
+	std::atomic<int> fired { 0 };
+	Process::Options opts;
+	opts.deadline.timeout = 100ms;
+	opts.deadline.on_timeout = [&fired] { fired++; };
+
+	const auto start = std::chrono::steady_clock::now();
+	Process proc("/bin/sleep", { "10" }, opts);
+	ASSERT_EQUAL("test_deadline_terminates", -1, proc.Wait());
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+
+	ASSERT_TRUE("test_deadline_terminates", proc.State() == Process::Status::TIMED_OUT);
+	ASSERT_EQUAL("test_deadline_terminates", 1, fired.load());
+	ASSERT_TRUE("test_deadline_terminates", elapsed >= 100ms && elapsed < 5s);
+
+	RETURN_TEST("test_deadline_terminates", 0);
+}
+
+int test_deadline_not_reached() {
+	bool fired = false;
+	Process::Options opts;
+	opts.deadline.timeout = 10s;
+	opts.deadline.on_timeout = [&fired] { fired = true; };
+
+	Process proc("/bin/sh", { "-c", "exit 3" }, opts);
+	ASSERT_EQUAL("test_deadline_not_reached", 3, proc.Wait());
+	ASSERT_TRUE("test_deadline_not_reached", proc.State() == Process::Status::TERMINATED);
+	ASSERT_FALSE("test_deadline_not_reached", fired);
+
+	RETURN_TEST("test_deadline_not_reached", 0);
+}
+
+int test_deadline_grace_kill() {
+	// SIGTERM is ignored: only the SIGKILL after the grace period ends it
+	Process proc("/bin/sh", { "-c", "trap '' TERM; while :; do sleep 0.05; done" });
+	// Let the shell install its trap
+	std::this_thread::sleep_for(200ms);
+
+	const auto start = std::chrono::steady_clock::now();
+	proc.SetDeadline({ 50ms, 300ms, nullptr });
+	ASSERT_EQUAL("test_deadline_grace_kill", -1, proc.Wait());
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+
+	ASSERT_TRUE("test_deadline_grace_kill", proc.State() == Process::Status::TIMED_OUT);
+	ASSERT_TRUE("test_deadline_grace_kill", elapsed >= 350ms);
+
+	RETURN_TEST("test_deadline_grace_kill", 0);
+}
+
+int test_deadline_suspended() {
+	// A stopped child is continued so it can act on SIGTERM
+	Process proc("/bin/sleep", { "10" });
+	proc.Suspend();
+	proc.SetDeadline({ 50ms, 10s, nullptr });
+
+	const auto start = std::chrono::steady_clock::now();
+	ASSERT_EQUAL("test_deadline_suspended", -1, proc.Wait());
+	ASSERT_TRUE("test_deadline_suspended", std::chrono::steady_clock::now() - start < 5s);
+	ASSERT_TRUE("test_deadline_suspended", proc.State() == Process::Status::TIMED_OUT);
+
+	RETURN_TEST("test_deadline_suspended", 0);
+}
+
+int test_deadline_disarm() {
+	Process proc("/bin/sleep", { "0.3" });
+	proc.SetDeadline({ 100ms, 1s, nullptr });
+	proc.SetDeadline({ 0ms, 1s, nullptr });
+
+	ASSERT_EQUAL("test_deadline_disarm", 0, proc.Wait());
+	ASSERT_TRUE("test_deadline_disarm", proc.State() == Process::Status::TERMINATED);
+
+	RETURN_TEST("test_deadline_disarm", 0);
+}
+
+int test_deadline_pipeline() {
+	std::atomic<int> fired { 0 };
+	Process proc1("/usr/bin/yes");
+	Process proc2("/bin/cat");
+	Process proc3("/bin/sleep", { "10" });
+	proc1 >> proc2;
+
+	Process::SetDeadline({ &proc1, &proc2, &proc3 }, { 100ms, 5s, [&fired] { fired++; } });
+
+	proc1.Wait();
+	proc2.Wait();
+	proc3.Wait();
+	ASSERT_EQUAL("test_deadline_pipeline", 1, fired.load());
+	ASSERT_TRUE("test_deadline_pipeline", proc1.State() == Process::Status::TIMED_OUT);
+	ASSERT_TRUE("test_deadline_pipeline", proc2.State() == Process::Status::TIMED_OUT);
+	ASSERT_TRUE("test_deadline_pipeline", proc3.State() == Process::Status::TIMED_OUT);
+
+	RETURN_TEST("test_deadline_pipeline", 0);
+}
+
+int test_deadline_many() {
+	// Many armed timers: the early ones fire, the rest are cancelled on Wait()
+	constexpr const int count = 200;
+	std::atomic<int> fired { 0 };
+	std::vector<std::unique_ptr<Process>> procs;
+	for (int i = 0; i < count; i++) {
+		Process::Options opts;
+		opts.deadline.timeout = i % 2 ? 100ms : 60s;
+		opts.deadline.on_timeout = [&fired] { fired++; };
+		procs.push_back(std::make_unique<Process>("/bin/sleep", std::vector<std::string> { i % 2 ? "10" : "0.5" }, opts));
+	}
+
+	int timed_out = 0, exited = 0;
+	for (auto& proc: procs) {
+		const int code = proc->Wait();
+		if (proc->State() == Process::Status::TIMED_OUT)
+			timed_out++;
+		else if (code == 0)
+			exited++;
+	}
+	ASSERT_EQUAL("test_deadline_many", count / 2, timed_out);
+	ASSERT_EQUAL("test_deadline_many", count / 2, exited);
+	ASSERT_EQUAL("test_deadline_many", count / 2, fired.load());
+
+	RETURN_TEST("test_deadline_many", 0);
+}
+
+#endif
+
+int main() {
+	int result = 0;
+
+#ifdef UNIX
+	result += test_deadline_terminates();
+	result += test_deadline_not_reached();
+	result += test_deadline_grace_kill();
+	result += test_deadline_suspended();
+	result += test_deadline_disarm();
+	result += test_deadline_pipeline();
+	result += test_deadline_many();
+#endif
+
+	if (result == 0) {
+		std::cout << "All tests passed!" << std::endl;
+	} else {
+		std::cout << result << " tests failed." << std::endl;
+	}
+	return result;
+}
@@ -0,0 +1,155 @@
+#include <StormByte/system/process.hxx>
+#include <StormByte/test_handlers.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#ifdef UNIX
+#include <cerrno>
+#include <sys/wait.h>
+#endif
+
+using StormByte::System::Process;
+using namespace std::chrono_literals;
+
+#ifdef UNIX
+
+int test_detach_does_not_block() {
+	std::promise<int> exited;
+	std::future<int> code = exited.get_future();
+	pid_t pid;
+
+	const auto start = std::chrono::steady_clock::now();
+	{
+		Process proc("/bin/sh", { "-c", "sleep 0.3; exit 7" });
+		pid = proc.Pid();
+		proc.Detach([&exited](int status) { exited.set_value(status); });
+		ASSERT_EQUAL("test_detach_does_not_block", -1, proc.Pid());
+		ASSERT_EQUAL("test_detach_does_not_block", -1, proc.Wait());
+	}
+	ASSERT_TRUE("test_detach_does_not_block", std::chrono::steady_clock::now() - start < 250ms);
+
+	ASSERT_EQUAL("test_detach_does_not_block", 7, code.get());
+	ASSERT_TRUE("test_detach_does_not_block", Process::DetachedExit(pid) == 7);
+
+	RETURN_TEST("test_detach_does_not_block", 0);
+}
+
+int test_detach_drains_output() {
+	// Far more output than a pipe holds: the child only exits if it is drained
+	std::promise<int> exited;
+	std::future<int> code = exited.get_future();
+	Process proc("/usr/bin/seq", { "1", "1000000" });
+	proc.Detach([&exited](int status) { exited.set_value(status); });
+
+	ASSERT_TRUE("test_detach_drains_output", code.wait_for(30s) == std::future_status::ready);
+	ASSERT_EQUAL("test_detach_drains_output", 0, code.get());
+
+	RETURN_TEST("test_detach_drains_output", 0);
+}
+
+int test_detach_no_zombies() {
+	constexpr const int count = 200;
+	std::atomic<int> done { 0 };
+	for (int i = 0; i < count; i++) {
+		Process proc("/bin/true");
+		proc.Detach([&done](int) { done++; });
+	}
+
+	const auto limit = std::chrono::steady_clock::now() + 30s;
+	while (done.load() < count && std::chrono::steady_clock::now() < limit)
+		std::this_thread::sleep_for(10ms);
+	ASSERT_EQUAL("test_detach_no_zombies", count, done.load());
+	// Every child was reaped: none left to wait for
+	ASSERT_EQUAL("test_detach_no_zombies", -1, waitpid(-1, nullptr, WNOHANG));
+	ASSERT_EQUAL("test_detach_no_zombies", ECHILD, errno);
+
+	RETURN_TEST("test_detach_no_zombies", 0);
+}
+
+int test_detach_stdin_eof() {
+	// A child reading stdin only exits once it sees EOF
+	std::promise<int> exited;
+	std::future<int> code = exited.get_future();
+	Process proc("/bin/cat");
+	proc.Detach([&exited](int status) { exited.set_value(status); });
+
+	ASSERT_TRUE("test_detach_stdin_eof", code.wait_for(10s) == std::future_status::ready);
+	ASSERT_EQUAL("test_detach_stdin_eof", 0, code.get());
+
+	// A forwarded stdin is closed by the producer instead
+	std::promise<int> consumed;
+	std::future<int> consumer_code = consumed.get_future();
+	Process producer("/bin/cat");
+	Process consumer("/bin/cat");
+	producer >> consumer;
+	consumer.Detach([&consumed](int status) { consumed.set_value(status); });
+	producer << "data";
+	producer.Detach();
+
+	ASSERT_TRUE("test_detach_stdin_eof", consumer_code.wait_for(10s) == std::future_status::ready);
+	ASSERT_EQUAL("test_detach_stdin_eof", 0, consumer_code.get());
+
+	RETURN_TEST("test_detach_stdin_eof", 0);
+}
+
+int test_try_wait() {
+	Process proc("/bin/sleep", { "0.2" });
+	ASSERT_FALSE("test_try_wait", proc.TryWait().has_value());
+
+	std::optional<int> code;
+	const auto limit = std::chrono::steady_clock::now() + 10s;
+	while (!(code = proc.TryWait()) && std::chrono::steady_clock::now() < limit)
+		std::this_thread::sleep_for(10ms);
+	ASSERT_TRUE("test_try_wait", code == 0);
+	ASSERT_TRUE("test_try_wait", proc.State() == Process::Status::TERMINATED);
+	ASSERT_TRUE("test_try_wait", proc.TryWait() == -1);
+
+	RETURN_TEST("test_try_wait", 0);
+}
+
+int test_detach_held_pipes() {
+	// Each exits at once but leaves a background child holding its output pipes
+	for (int i = 0; i < 100; i++) {
+		Process daemon("/bin/sh", { "-c", "sleep 3 & exit 0" });
+		daemon.Detach();
+	}
+	std::this_thread::sleep_for(100ms);
+
+	// Unfinished completions must not delay an unrelated one
+	std::promise<int> exited;
+	std::future<int> code = exited.get_future();
+	const auto start = std::chrono::steady_clock::now();
+	Process proc("/bin/true");
+	proc.Detach([&exited](int status) { exited.set_value(status); });
+	ASSERT_TRUE("test_detach_held_pipes", code.wait_for(10s) == std::future_status::ready);
+	ASSERT_TRUE("test_detach_held_pipes", std::chrono::steady_clock::now() - start < 250ms);
+
+	RETURN_TEST("test_detach_held_pipes", 0);
+}
+
+#endif
+
+int main() {
+	int result = 0;
+
+#ifdef UNIX
+	result += test_detach_does_not_block();
+	result += test_detach_drains_output();
+	result += test_detach_no_zombies();
+	result += test_detach_stdin_eof();
+	result += test_try_wait();
+	result += test_detach_held_pipes();
+#endif
+
+	if (result == 0) {
+		std::cout << "All tests passed!" << std::endl;
+	} else {
+		std::cout << result << " tests failed." << std::endl;
+	}
+	return result;
+}
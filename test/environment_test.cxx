@@ -0,0 +1,124 @@
+#include <StormByte/system/command.hxx>
+#include <StormByte/system/environment.hxx>
+#include <StormByte/system/process.hxx>
+#include <StormByte/system/variable.hxx>
+#include <StormByte/test_handlers.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using StormByte::System::Command;
+using StormByte::System::Environment;
+using StormByte::System::Process;
+using StormByte::System::Variable;
+
+int test_environment_snapshot() {
+	const Environment env({ "A=1", "B=2", "A=3", "BROKEN" });
+	ASSERT_EQUAL("test_environment_snapshot", 2, env.Size());
+	ASSERT_TRUE("test_environment_snapshot", env.Get("A") == "3");
+	ASSERT_TRUE("test_environment_snapshot", env.Get("B") == "2");
+	ASSERT_FALSE("test_environment_snapshot", env.Get("BROKEN").has_value());
+	ASSERT_TRUE("test_environment_snapshot", env.Entries() == std::vector<std::string>({ "A=3", "B=2" }));
+
+	const Environment empty;
+	ASSERT_EQUAL("test_environment_snapshot", 0, empty.Size());
+	ASSERT_TRUE("test_environment_snapshot", empty.Entries().empty());
+
+	RETURN_TEST("test_environment_snapshot", 0);
+}
+
+int test_environment_overlay() {
+	const Environment base({ "A=1", "B=2", "C=3" });
+	const Environment first = base.Set("B", "two").Set("D", "4");
+	const Environment second = first.Unset("A").Set("D", "four");
+
+	// The base is untouched
+	ASSERT_EQUAL("test_environment_overlay", 3, base.Size());
+	ASSERT_TRUE("test_environment_overlay", base.Get("B") == "2");
+	ASSERT_FALSE("test_environment_overlay", base.Get("D").has_value());
+
+	ASSERT_EQUAL("test_environment_overlay", 4, first.Size());
+	ASSERT_TRUE("test_environment_overlay", first.Get("B") == "two");
+	ASSERT_TRUE("test_environment_overlay", first.Get("D") == "4");
+
+	ASSERT_EQUAL("test_environment_overlay", 3, second.Size());
+	ASSERT_FALSE("test_environment_overlay", second.Get("A").has_value());
+	ASSERT_TRUE("test_environment_overlay", second.Get("D") == "four");
+	std::vector<std::string> entries = second.Entries();
+	std::sort(entries.begin(), entries.end());
+	ASSERT_TRUE("test_environment_overlay", entries == std::vector<std::string>({ "B=two", "C=3", "D=four" }));
+
+	RETURN_TEST("test_environment_overlay", 0);
+}
+
+int test_environment_expand() {
+	const Environment env({ "NAME=world", "HOME=/home/sb", "EMPTY=" });
+	ASSERT_EQUAL("test_environment_expand", "hello world!", Variable::Expand("hello $NAME!", env));
+	ASSERT_EQUAL("test_environment_expand", "worlds", Variable::Expand("${NAME}s", env));
+	ASSERT_EQUAL("test_environment_expand", "/home/sb/bin", Variable::Expand("~/bin", env));
+	ASSERT_EQUAL("test_environment_expand", "a~b", Variable::Expand("a~b", env));
+	ASSERT_EQUAL("test_environment_expand", "[]", Variable::Expand("[$MISSING$EMPTY]", env));
+	ASSERT_EQUAL("test_environment_expand", "$ ${ ${} $1", Variable::Expand("$ ${ ${} $1", env));
+
+	RETURN_TEST("test_environment_expand", 0);
+}
+
+#ifdef UNIX
+int test_environment_spawn() {
+	const Environment base = Environment::Current().Set("SB_BASE", "base");
+	Process::Options opts;
+	opts.environment = base.Set("SB_JOB", "job").Unset("HOME");
+
+	// PATH comes from the snapshot, so "sh" is still found
+	Process proc("sh", { "-c", "echo \"$SB_BASE:$SB_JOB:${HOME-unset}\"" }, opts);
+	std::string output;
+	proc >> output;
+	ASSERT_EQUAL("test_environment_spawn", "base:job:unset\n", output);
+	ASSERT_EQUAL("test_environment_spawn", 0, proc.Wait());
+
+	RETURN_TEST("test_environment_spawn", 0);
+}
+
+int test_environment_command() {
+	const Environment env({ "SB_VALUE=shared" });
+	Command cmd("/bin/sh", { "-c", "echo \"$SB_VALUE:$SB_OTHER\"" }, env);
+
+	Process first(cmd);
+	std::string output;
+	first >> output;
+	ASSERT_EQUAL("test_environment_command", "shared:\n", output);
+	ASSERT_EQUAL("test_environment_command", 0, first.Wait());
+
+	// Options::environment replaces the command one
+	Process::Options opts;
+	opts.environment = env.Set("SB_OTHER", "override");
+	Process second(cmd, {}, opts);
+	output.clear();
+	second >> output;
+	ASSERT_EQUAL("test_environment_command", "shared:override\n", output);
+	ASSERT_EQUAL("test_environment_command", 0, second.Wait());
+
+	RETURN_TEST("test_environment_command", 0);
+}
+#endif
+
+int main() {
+	int result = 0;
+
+	result += test_environment_snapshot();
+	result += test_environment_overlay();
+	result += test_environment_expand();
+#ifdef UNIX
+	result += test_environment_spawn();
+	result += test_environment_command();
+#endif
+
+	if (result == 0) {
+		std::cout << "All tests passed!" << std::endl;
+	} else {
+		std::cout << result << " tests failed." << std::endl;
+	}
+	return result;
+}
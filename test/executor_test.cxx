@@ -0,0 +1,207 @@
+#include <StormByte/system/executor.hxx>
+#include <StormByte/system/process.hxx>
+#include <StormByte/test_handlers.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using StormByte::System::Executor;
+using StormByte::System::Process;
+using StormByte::System::ThreadPool;
+
+namespace {
+
+// Adapter standing in for an application pool: counts what the library hands it
+class CountingExecutor final: public Executor {
+	public:
+		CountingExecutor(): m_pool(std::make_shared<ThreadPool>(ThreadPool::Options { 2, {}, 16 })), m_posted(0) {}
+
+		void Post(std::function<void()> task) override {
+			m_posted++;
+			m_pool->Post(std::move(task));
+		}
+
+		void PostBlocking(std::function<void()> task) override {
+			m_posted++;
+			m_pool->PostBlocking(std::move(task));
+		}
+
+		Metrics Stats() const override {
+			return m_pool->Stats();
+		}
+
+		size_t Posted() const noexcept {
+			return m_posted.load();
+		}
+
+	private:
+		std::shared_ptr<ThreadPool> m_pool;
+		std::atomic<size_t> m_posted;
+};
+
+std::string Trim(const std::string& str) {
+	const size_t end = str.find_last_not_of(" \n\t");
+	const size_t start = str.find_first_not_of(" \n\t");
+	return start == std::string::npos ? std::string() : str.substr(start, end - start + 1);
+}
+
+} // namespace
+
+int test_pool_runs_everything() {
+	std::atomic<int> counter = 0;
+	{
+		ThreadPool pool(ThreadPool::Options { 4, {}, 8 });
+		std::vector<std::future<void>> done;
+		for (int i = 0; i < 100; i++) {
+			auto promise = std::make_shared<std::promise<void>>();
+			done.push_back(promise->get_future());
+			// Tasks posted from a worker land on its queue and get stolen by idle ones
+			pool.Post([&pool, &counter, promise] {
+				for (int j = 0; j < 10; j++)
+					pool.Post([&counter] { counter++; });
+				promise->set_value();
+			});
+		}
+		for (auto& future: done)
+			future.get();
+	}
+	ASSERT_EQUAL("test_pool_runs_everything", 1000, counter.load());
+
+	RETURN_TEST("test_pool_runs_everything", 0);
+}
+
+int test_pool_blocking_tasks_do_not_starve() {
+	// Declared before the pool so they outlive its blocking threads
+	std::promise<void> first, second;
+	std::future<void> first_ready = first.get_future(), second_ready = second.get_future();
+	ThreadPool pool(ThreadPool::Options { 1, {}, 8 });
+
+	// Each blocking task waits for the other: they need two blocking threads
+	pool.PostBlocking([&] { first.set_value(); second_ready.wait(); });
+	pool.PostBlocking([&] { first_ready.wait(); second.set_value(); });
+	std::promise<void> worker;
+	pool.Post([&] { worker.set_value(); });
+	worker.get_future().get();
+	second_ready.wait();
+
+	const Executor::Metrics metrics = pool.Stats();
+	ASSERT_EQUAL("test_pool_blocking_tasks_do_not_starve", 1u, metrics.workers);
+	ASSERT_EQUAL("test_pool_blocking_tasks_do_not_starve", 1u, metrics.queue_depths.size());
+	ASSERT_EQUAL("test_pool_blocking_tasks_do_not_starve", 2u, metrics.blocking_threads);
+
+	RETURN_TEST("test_pool_blocking_tasks_do_not_starve", 0);
+}
+
+int test_pool_long_running_exceeds_bound() {
+	// Declared before the pool so they outlive its blocking threads
+	constexpr const int links = 4;
+	std::vector<std::promise<void>> released(links);
+	std::promise<void> last;
+	std::future<void> done = last.get_future();
+	ThreadPool pool(ThreadPool::Options { 1, {}, 1 });
+
+	// Each waits for the one queued after it: a pool capped at one thread would hang
+	for (int i = 0; i < links; i++) {
+		pool.PostLongRunning([&, i] {
+			if (i + 1 < links)
+				released[static_cast<size_t>(i) + 1].get_future().wait();
+			released[static_cast<size_t>(i)].set_value();
+			if (i == 0)
+				last.set_value();
+		});
+	}
+	ASSERT_TRUE("test_pool_long_running_exceeds_bound", done.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+	ASSERT_EQUAL("test_pool_long_running_exceeds_bound", static_cast<size_t>(links), pool.Stats().blocking_threads);
+
+	RETURN_TEST("test_pool_long_running_exceeds_bound", 0);
+}
+
+#ifdef UNIX
+int test_injected_executor_runs_pipelines() {
+	auto executor = std::make_shared<CountingExecutor>();
+	Process::Options opts;
+	opts.executor = executor;
+
+	Process proc1("/usr/bin/printf", { "%s", "one\ntwo\nthree\n" }, opts);
+	Process proc2("/usr/bin/wc", { "-l" });
+	proc1 >> proc2;
+
+	std::string output;
+	proc2 >> output;
+	ASSERT_EQUAL("test_injected_executor_runs_pipelines", "3", Trim(output));
+	ASSERT_EQUAL("test_injected_executor_runs_pipelines", 0, proc1.Wait());
+	ASSERT_EQUAL("test_injected_executor_runs_pipelines", 0, proc2.Wait());
+	ASSERT_TRUE("test_injected_executor_runs_pipelines", executor->Posted() > 0);
+
+	RETURN_TEST("test_injected_executor_runs_pipelines", 0);
+}
+#endif
+
+#ifdef LINUX
+int test_many_chains_bounded_threads() {
+	auto count_threads = [] {
+		std::ifstream status("/proc/self/status");
+		std::string line;
+		while (std::getline(status, line)) {
+			if (line.rfind("Threads:", 0) == 0)
+				return std::stoi(line.substr(8));
+		}
+		return -1;
+	};
+	Executor::SetDefault(std::make_shared<ThreadPool>(ThreadPool::Options { 2, {}, 16 }));
+
+	constexpr const int CHAINS = 60;
+	std::vector<std::unique_ptr<Process>> procs;
+	for (int i = 0; i < CHAINS; i++) {
+		procs.push_back(std::make_unique<Process>("/usr/bin/head", std::vector<std::string> { "-c", "200000", "/dev/zero" }));
+		procs.push_back(std::make_unique<Process>("/bin/cat"));
+		procs.push_back(std::make_unique<Process>("/usr/bin/wc", std::vector<std::string> { "-c" }));
+		*procs[procs.size() - 3] >> *procs[procs.size() - 2] >> *procs[procs.size() - 1];
+	}
+	// 120 links in flight on a 2-worker pool plus the reactor
+	const int threads = count_threads();
+
+	int result = 0;
+	for (int i = 0; i < CHAINS; i++) {
+		std::string output;
+		*procs[i * 3 + 2] >> output;
+		if (Trim(output) != "200000")
+			result = 1;
+	}
+	for (auto& proc: procs)
+		proc->Wait();
+	Executor::SetDefault(nullptr);
+
+	ASSERT_EQUAL("test_many_chains_bounded_threads", 0, result);
+	ASSERT_TRUE("test_many_chains_bounded_threads", threads > 0 && threads < 16);
+
+	RETURN_TEST("test_many_chains_bounded_threads", 0);
+}
+#endif
+
+int main() {
+	int result = 0;
+
+	result += test_pool_runs_everything();
+	result += test_pool_blocking_tasks_do_not_starve();
+	result += test_pool_long_running_exceeds_bound();
+#ifdef UNIX
+	result += test_injected_executor_runs_pipelines();
+#endif
+#ifdef LINUX
+	result += test_many_chains_bounded_threads();
+#endif
+
+	if (result == 0) {
+		std::cout << "All tests passed!" << std::endl;
+	} else {
+		std::cout << result << " tests failed." << std::endl;
+	}
+	return result;
+}
@@ -0,0 +1,124 @@
+#include <StormByte/system/process.hxx>
+#include <StormByte/test_handlers.h>
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using StormByte::System::Filter;
+using StormByte::System::Process;
+using StormByte::System::Sink;
+
+#ifdef UNIX
+
+int test_filter_chunk_transform() {
+	Process proc1("/usr/bin/printf", { "%s", "hello filter" });
+	Process proc2("/bin/cat");
+
+	proc1 >> Filter([](std::string_view chunk, Sink& out) {
+		std::string upper(chunk);
+		std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return std::toupper(c); });
+		out << upper;
+	}) >> proc2;
+
+	std::string output;
+	proc2 >> output;
+	ASSERT_EQUAL("test_filter_chunk_transform", "HELLO FILTER", output);
+	ASSERT_EQUAL("test_filter_chunk_transform", 0, proc1.Wait());
+	ASSERT_EQUAL("test_filter_chunk_transform", 0, proc2.Wait());
+
+	RETURN_TEST("test_filter_chunk_transform", 0);
+}
+
+int test_filter_lines_chain() {
+	// Lines crossing read boundaries must arrive whole; the byte counter flushes at EOF
+	Process proc1("/usr/bin/seq", { "1", "100000" });
+	Process proc2("/bin/cat");
+	size_t lines = 0, bytes = 0;
+
+	proc1 >> Filter::Lines([&lines](std::string_view line, Sink& out) {
+		lines++;
+		if (line.size() >= 2 && line[line.size() - 2] == '0')
+			out << line;
+	}) >> Filter([&bytes](std::string_view chunk, Sink&) {
+		bytes += chunk.size();
+	}, [&bytes](Sink& out) {
+		out << std::to_string(bytes);
+	}) >> proc2;
+
+	std::string output;
+	proc2 >> output;
+	proc1.Wait();
+	proc2.Wait();
+
+	// Multiples of 10 up to 100000: 9*3 + 90*4 + 900*5 + 9000*6 + 1*7 bytes
+	ASSERT_EQUAL("test_filter_lines_chain", 100000u, lines);
+	ASSERT_EQUAL("test_filter_lines_chain", "58894", output);
+
+	RETURN_TEST("test_filter_lines_chain", 0);
+}
+
+int test_filter_lines_reused() {
+	// One Lines filter in two concurrent pipelines: each keeps its own half-lines
+	const Filter lines = Filter::Lines([](std::string_view line, Sink& out) { out << line; });
+	Process first("/usr/bin/seq", { "1", "100000" });
+	Process second("/usr/bin/seq", { "500000", "600000" });
+	Process first_out("/bin/cat");
+	Process second_out("/bin/cat");
+	first >> lines >> first_out;
+	second >> lines >> second_out;
+
+	std::string expected_first, expected_second, output_first, output_second;
+	for (int i = 1; i <= 100000; i++)
+		expected_first += std::to_string(i) + "\n";
+	for (int i = 500000; i <= 600000; i++)
+		expected_second += std::to_string(i) + "\n";
+	first_out >> output_first;
+	second_out >> output_second;
+	first.Wait();
+	second.Wait();
+	first_out.Wait();
+	second_out.Wait();
+
+	ASSERT_TRUE("test_filter_lines_reused", expected_first == output_first);
+	ASSERT_TRUE("test_filter_lines_reused", expected_second == output_second);
+
+	RETURN_TEST("test_filter_lines_reused", 0);
+}
+
+int test_filter_consumer_exits() {
+	Process proc1("/usr/bin/yes");
+	Process proc2("/usr/bin/head", { "-n", "2" });
+
+	proc1 >> Filter([](std::string_view chunk, Sink& out) { out << chunk; }) >> proc2;
+
+	std::string output;
+	proc2 >> output;
+	ASSERT_EQUAL("test_filter_consumer_exits", "y\ny\n", output);
+	ASSERT_EQUAL("test_filter_consumer_exits", 0, proc2.Wait());
+	ASSERT_EQUAL("test_filter_consumer_exits", -1, proc1.Wait());
+
+	RETURN_TEST("test_filter_consumer_exits", 0);
+}
+
+#endif
+
+int main() {
+	int result = 0;
+
+#ifdef UNIX
+	result += test_filter_chunk_transform();
+	result += test_filter_lines_chain();
+	result += test_filter_lines_reused();
+	result += test_filter_consumer_exits();
+#endif
+
+	if (result == 0) {
+		std::cout << "All tests passed!" << std::endl;
+	} else {
+		std::cout << result << " tests failed." << std::endl;
+	}
+	return result;
+}
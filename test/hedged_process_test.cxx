@@ -0,0 +1,141 @@
+#include <StormByte/system/command.hxx>
+#include <StormByte/system/hedged_process.hxx>
+#include <StormByte/test_handlers.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#ifdef UNIX
+#include <unistd.h>
+#endif
+
+using StormByte::System::Command;
+using StormByte::System::HedgedProcess;
+
+#ifdef UNIX
+
+using Clock = std::chrono::steady_clock;
+
+std::filesystem::path Counter(const std::string& name) {
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / ("stormbyte_hedged_" + std::to_string(getpid()) + "_" + name);
+	std::filesystem::remove(path);
+	return path;
+}
+
+std::string Read(const std::filesystem::path& path) {
+	std::ifstream file(path);
+	std::string content;
+	std::getline(file, content);
+	return content;
+}
+
+int test_hedged_backup_wins() {
+	// The first run hangs, later ones answer at once
+	const Command cmd("/bin/sh", { "-c", "n=$(cat \"$1\" 2>/dev/null || echo 0); echo $((n + 1)) > \"$1\"; "
+		"[ \"$n\" = 0 ] && exec sleep 10; tr a-z A-Z", "sh", Command::PLACEHOLDER });
+	const std::filesystem::path counter = Counter("backup");
+	HedgedProcess::Options opts;
+	opts.initial_delay = std::chrono::milliseconds(100);
+
+	const Clock::time_point start = Clock::now();
+	HedgedProcess proc(cmd, { counter.string() }, opts);
+	proc << "replayed";
+	proc << StormByte::System::EoF;
+	std::string out;
+	proc >> out;
+	ASSERT_EQUAL("test_hedged_backup_wins", "REPLAYED", out);
+	ASSERT_EQUAL("test_hedged_backup_wins", 0, proc.Wait());
+	ASSERT_TRUE("test_hedged_backup_wins", proc.Hedged());
+	ASSERT_EQUAL("test_hedged_backup_wins", 1u, proc.Winner());
+	ASSERT_TRUE("test_hedged_backup_wins", Clock::now() - start < std::chrono::seconds(5));
+	ASSERT_EQUAL("test_hedged_backup_wins", "2", Read(counter));
+	std::filesystem::remove(counter);
+	RETURN_TEST("test_hedged_backup_wins", 0);
+}
+
+int test_hedged_fast_primary() {
+	const Command cmd("/bin/sh", { "-c", "tr a-z A-Z; echo done >&2; exit 3" });
+	HedgedProcess::Options opts;
+	opts.initial_delay = std::chrono::seconds(2);
+	HedgedProcess proc(cmd, {}, opts);
+	proc << "abc";
+	std::string out, err;
+	// Reading closes stdin
+	proc >> out;
+	proc.Stderr(err);
+	ASSERT_EQUAL("test_hedged_fast_primary", "ABC", out);
+	ASSERT_EQUAL("test_hedged_fast_primary", "done\n", err);
+	ASSERT_EQUAL("test_hedged_fast_primary", 3, proc.Wait());
+	ASSERT_FALSE("test_hedged_fast_primary", proc.Hedged());
+	ASSERT_EQUAL("test_hedged_fast_primary", 0u, proc.Winner());
+
+	// Handed out once
+	out.clear();
+	proc >> out;
+	ASSERT_TRUE("test_hedged_fast_primary", out.empty());
+	RETURN_TEST("test_hedged_fast_primary", 0);
+}
+
+int test_hedged_first_byte() {
+	// Answers quickly but finishes late: only FIRST_BYTE avoids the backup
+	const Command cmd("/bin/sh", { "-c", "echo a; sleep 0.6; echo b" });
+	HedgedProcess::Options opts;
+	opts.trigger = HedgedProcess::Options::Trigger::FIRST_BYTE;
+	opts.initial_delay = std::chrono::milliseconds(300);
+	HedgedProcess proc(cmd, {}, opts);
+	std::string out;
+	proc >> out;
+	ASSERT_EQUAL("test_hedged_first_byte", "a\nb\n", out);
+	ASSERT_FALSE("test_hedged_first_byte", proc.Hedged());
+	ASSERT_EQUAL("test_hedged_first_byte", 0u, proc.Winner());
+	RETURN_TEST("test_hedged_first_byte", 0);
+}
+
+int test_hedged_latency_profile() {
+	const Command cmd("/bin/sh", { "-c", "sleep 0.05" });
+	HedgedProcess::Options opts;
+	opts.min_samples = 3;
+	opts.percentile = 0.5;
+	opts.initial_delay = std::chrono::seconds(10);
+	ASSERT_TRUE("test_hedged_latency_profile", HedgedProcess::Delay(cmd, opts) == opts.initial_delay);
+
+	// Recorded through a copy: copies share the distribution
+	const Command copy = cmd;
+	for (int i = 0; i < 3; i++)
+		ASSERT_EQUAL("test_hedged_latency_profile", 0, HedgedProcess(copy, {}, opts).Wait());
+	const std::chrono::nanoseconds delay = HedgedProcess::Delay(cmd, opts);
+	ASSERT_TRUE("test_hedged_latency_profile", delay >= std::chrono::milliseconds(50));
+	ASSERT_TRUE("test_hedged_latency_profile", delay < std::chrono::seconds(2));
+
+	// No output at all: the first byte trigger keeps its initial delay
+	opts.trigger = HedgedProcess::Options::Trigger::FIRST_BYTE;
+	ASSERT_TRUE("test_hedged_latency_profile", HedgedProcess::Delay(cmd, opts) == opts.initial_delay);
+
+	// A different invocation starts from scratch
+	opts.trigger = HedgedProcess::Options::Trigger::EXIT;
+	ASSERT_TRUE("test_hedged_latency_profile", HedgedProcess::Delay(cmd.Append("x"), opts) == opts.initial_delay);
+	RETURN_TEST("test_hedged_latency_profile", 0);
+}
+
+#endif
+
+int main() {
+	int result = 0;
+
+#ifdef UNIX
+	result += test_hedged_backup_wins();
+	result += test_hedged_fast_primary();
+	result += test_hedged_first_byte();
+	result += test_hedged_latency_profile();
+#endif
+
+	if (result == 0) {
+		std::cout << "All tests passed!" << std::endl;
+	} else {
+		std::cout << result << " tests failed." << std::endl;
+	}
+	return result;
+}
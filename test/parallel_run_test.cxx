@@ -0,0 +1,162 @@
+#include <StormByte/system/command.hxx>
+#include <StormByte/system/parallel_run.hxx>
+#include <StormByte/test_handlers.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using StormByte::System::Command;
+using StormByte::System::ParallelOptions;
+using StormByte::System::ParallelResult;
+using StormByte::System::ParallelRun;
+using StormByte::System::ParallelStats;
+
+#ifdef UNIX
+
+int test_parallel_ordered() {
+	// Earlier inputs sleep longer, so they finish last
+	const Command cmd("/bin/sh", { "-c", "sleep 0.$1; echo $1", "sh" });
+	ParallelOptions opts;
+	opts.jobs = 4;
+	opts.ordered = true;
+	std::vector<std::string> outputs;
+	std::vector<size_t> indexes;
+	const ParallelStats stats = ParallelRun(cmd, { "3", "2", "1", "0" }, [&](ParallelResult& result) {
+		indexes.push_back(result.index);
+		outputs.push_back(result.out);
+	}, opts);
+
+	ASSERT_TRUE("test_parallel_ordered", indexes == std::vector<size_t>({ 0, 1, 2, 3 }));
+	ASSERT_TRUE("test_parallel_ordered", outputs == std::vector<std::string>({ "3\n", "2\n", "1\n", "0\n" }));
+	ASSERT_EQUAL("test_parallel_ordered", 4u, stats.launched);
+	ASSERT_EQUAL("test_parallel_ordered", 4u, stats.succeeded);
+	ASSERT_EQUAL("test_parallel_ordered", 0u, stats.skipped);
+	ASSERT_TRUE("test_parallel_ordered", stats.p50.count() > 0);
+	ASSERT_TRUE("test_parallel_ordered", stats.p50 <= stats.p90 && stats.p90 <= stats.p99 && stats.p99 <= stats.max);
+	ASSERT_TRUE("test_parallel_ordered", stats.throughput > 0);
+	RETURN_TEST("test_parallel_ordered", 0);
+}
+
+int test_parallel_bounded() {
+	const Command cmd("/bin/sleep");
+	ParallelOptions opts;
+	opts.jobs = 2;
+	const std::vector<std::string> inputs(4, "0.2");
+	const ParallelStats stats = ParallelRun(cmd, inputs, nullptr, opts);
+
+	// Two waves of two
+	ASSERT_EQUAL("test_parallel_bounded", 2u, stats.jobs);
+	ASSERT_EQUAL("test_parallel_bounded", 4u, stats.succeeded);
+	ASSERT_TRUE("test_parallel_bounded", stats.elapsed >= std::chrono::milliseconds(400));
+	ASSERT_TRUE("test_parallel_bounded", stats.elapsed < std::chrono::milliseconds(790));
+	RETURN_TEST("test_parallel_bounded", 0);
+}
+
+int test_parallel_placeholders() {
+	// Every placeholder gets the input
+	const Command twice("/bin/echo", { "{}-{}" });
+	std::string out;
+	ParallelRun(twice, { "x" }, [&](ParallelResult& result) { out = result.out; });
+	ASSERT_EQUAL("test_parallel_placeholders", "x-x\n", out);
+
+	// None: appended
+	const Command append("/bin/echo", { "arg" });
+	ParallelRun(append, { "y" }, [&](ParallelResult& result) { out = result.out; });
+	ASSERT_EQUAL("test_parallel_placeholders", "arg y\n", out);
+	ASSERT_EQUAL("test_parallel_placeholders", 0u, append.Placeholders());
+	ASSERT_EQUAL("test_parallel_placeholders", 1u, append.Append("{}").Placeholders());
+	RETURN_TEST("test_parallel_placeholders", 0);
+}
+
+int test_parallel_continue() {
+	const Command cmd("/bin/sh", { "-c", "echo err$1 >&2; exit $1", "sh" });
+	ParallelOptions opts;
+	opts.jobs = 3;
+	std::vector<std::string> errors(3);
+	const ParallelStats stats = ParallelRun(cmd, { "0", "1", "2" }, [&](ParallelResult& result) {
+		errors[result.index] = result.err;
+		if (result.index > 0 && result.exit_code != static_cast<int>(result.index))
+			errors[result.index] = "wrong code";
+	}, opts);
+
+	ASSERT_EQUAL("test_parallel_continue", 1u, stats.succeeded);
+	ASSERT_EQUAL("test_parallel_continue", 2u, stats.failed);
+	ASSERT_EQUAL("test_parallel_continue", 0u, stats.skipped);
+	ASSERT_TRUE("test_parallel_continue", errors == std::vector<std::string>({ "err0\n", "err1\n", "err2\n" }));
+	RETURN_TEST("test_parallel_continue", 0);
+}
+
+int test_parallel_fail_fast() {
+	// Input "f" fails at once while "s" runs for a long time
+	const Command cmd("/bin/sh", { "-c", "[ $1 = f ] && exit 1; exec sleep 10", "sh" });
+	ParallelOptions opts;
+	opts.jobs = 2;
+	opts.failure = ParallelOptions::Failure::FAIL_FAST;
+	opts.grace = std::chrono::milliseconds(200);
+	size_t cancelled = 0;
+	const ParallelStats stats = ParallelRun(cmd, { "s", "f", "s", "s" }, [&](ParallelResult& result) {
+		if (result.cancelled)
+			cancelled++;
+	}, opts);
+
+	ASSERT_EQUAL("test_parallel_fail_fast", 2u, stats.launched);
+	ASSERT_EQUAL("test_parallel_fail_fast", 2u, stats.skipped);
+	ASSERT_EQUAL("test_parallel_fail_fast", 2u, stats.failed);
+	ASSERT_EQUAL("test_parallel_fail_fast", 1u, cancelled);
+	ASSERT_TRUE("test_parallel_fail_fast", stats.elapsed < std::chrono::seconds(5));
+	RETURN_TEST("test_parallel_fail_fast", 0);
+}
+
+int test_parallel_spawn_error() {
+	const Command cmd("/nonexistent/stormbyte");
+	std::string err;
+	int code = 0;
+	const ParallelStats stats = ParallelRun(cmd, { "a" }, [&](ParallelResult& result) {
+		err = result.err;
+		code = result.exit_code;
+	});
+	ASSERT_EQUAL("test_parallel_spawn_error", 1u, stats.failed);
+	ASSERT_TRUE("test_parallel_spawn_error", code != 0);
+	RETURN_TEST("test_parallel_spawn_error", 0);
+}
+
+int test_parallel_stdin_closed() {
+	// A child reading stdin must see EOF instead of waiting forever
+	const Command cmd("/bin/sh", { "-c", "read x; echo got$x {}" });
+	ParallelOptions opts;
+	opts.jobs = 2;
+	opts.ordered = true;
+	std::vector<std::string> outputs;
+	const ParallelStats stats = ParallelRun(cmd, { "a", "b" }, [&](ParallelResult& result) {
+		outputs.push_back(result.out);
+	}, opts);
+
+	ASSERT_EQUAL("test_parallel_stdin_closed", 2u, stats.succeeded);
+	ASSERT_TRUE("test_parallel_stdin_closed", outputs == std::vector<std::string>({ "got a\n", "got b\n" }));
+	RETURN_TEST("test_parallel_stdin_closed", 0);
+}
+
+#endif
+
+int main() {
+	int result = 0;
+
+#ifdef UNIX
+	result += test_parallel_ordered();
+	result += test_parallel_bounded();
+	result += test_parallel_placeholders();
+	result += test_parallel_continue();
+	result += test_parallel_fail_fast();
+	result += test_parallel_spawn_error();
+	result += test_parallel_stdin_closed();
+#endif
+
+	if (result == 0) {
+		std::cout << "All tests passed!" << std::endl;
+	} else {
+		std::cout << result << " tests failed." << std::endl;
+	}
+	return result;
+}
@@ -0,0 +1,195 @@
+#include <StormByte/system/process.hxx>
+#include <StormByte/system/process_monitor.hxx>
+#include <StormByte/test_handlers.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef LINUX
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+using StormByte::System::Process;
+using StormByte::System::ProcessMonitor;
+
+#ifdef LINUX
+
+ProcessMonitor::Options Manual(size_t capacity = 1024) {
+	ProcessMonitor::Options opts;
+	opts.interval = std::chrono::milliseconds(0);
+	opts.capacity = capacity;
+	return opts;
+}
+
+int test_monitor_cpu_and_memory() {
+	ProcessMonitor::Options monitor_opts = Manual();
+	monitor_opts.state = true;
+	ProcessMonitor monitor(monitor_opts);
+	Process::Options opts;
+	opts.deadline = Process::Deadline { std::chrono::milliseconds(400), std::chrono::milliseconds(100), nullptr };
+	Process busy("/bin/sh", { "-c", "while :; do :; done" }, opts);
+	ASSERT_TRUE("test_monitor_cpu_and_memory", monitor.Watch(busy));
+
+	monitor.Sweep();
+	const auto first = monitor.Latest(busy.Pid());
+	ASSERT_TRUE("test_monitor_cpu_and_memory", first.has_value());
+	ASSERT_EQUAL("test_monitor_cpu_and_memory", busy.Pid(), first->pid);
+	ASSERT_TRUE("test_monitor_cpu_and_memory", first->rss > 0);
+	ASSERT_TRUE("test_monitor_cpu_and_memory", first->vm >= first->rss);
+	ASSERT_EQUAL("test_monitor_cpu_and_memory", 1u, first->threads);
+	ASSERT_TRUE("test_monitor_cpu_and_memory", first->state == 'R' || first->state == 'S');
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	monitor.Sweep();
+	const auto second = monitor.Latest(busy.Pid());
+	ASSERT_TRUE("test_monitor_cpu_and_memory", second->cpu_time > first->cpu_time);
+	ASSERT_TRUE("test_monitor_cpu_and_memory", second->cpu > 0.2);
+	ASSERT_EQUAL("test_monitor_cpu_and_memory", 2u, monitor.History(busy.Pid()).size());
+
+	// Reaped processes are dropped on the next sweep
+	busy.Wait();
+	monitor.Sweep();
+	ASSERT_EQUAL("test_monitor_cpu_and_memory", 0u, monitor.Statistics().watched);
+	ASSERT_FALSE("test_monitor_cpu_and_memory", monitor.Latest(busy.Pid()).has_value());
+	RETURN_TEST("test_monitor_cpu_and_memory", 0);
+}
+
+int test_monitor_io() {
+	ProcessMonitor monitor(Manual());
+	Process cat("/bin/cat");
+	cat.Capture(Process::Stream::STDOUT, StormByte::System::CapturePolicy::Discard());
+	ASSERT_TRUE("test_monitor_io", monitor.Watch(cat));
+	cat << std::string(100000, 'x');
+
+	// cat copies in the background: sample until it caught up
+	std::optional<ProcessMonitor::Sample> sample;
+	for (int i = 0; i < 200; i++) {
+		monitor.Sweep();
+		sample = monitor.Latest(cat.Pid());
+		if (sample && sample->write_bytes >= 100000)
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	ASSERT_TRUE("test_monitor_io", sample.has_value());
+	// Includes what the loader read while starting cat
+	ASSERT_TRUE("test_monitor_io", sample->read_bytes >= 100000);
+	ASSERT_TRUE("test_monitor_io", sample->write_bytes >= 100000);
+
+	cat << StormByte::System::EoF;
+	ASSERT_EQUAL("test_monitor_io", 0, cat.Wait());
+	RETURN_TEST("test_monitor_io", 0);
+}
+
+int test_monitor_ring_and_subscribers() {
+	ProcessMonitor monitor(Manual(4));
+	const pid_t self = getpid();
+	ASSERT_TRUE("test_monitor_ring_and_subscribers", monitor.Watch(self));
+	ASSERT_TRUE("test_monitor_ring_and_subscribers", monitor.Watch(self));
+	ASSERT_FALSE("test_monitor_ring_and_subscribers", monitor.Watch(-1));
+	ASSERT_FALSE("test_monitor_ring_and_subscribers", monitor.Watch(0x3ffffff));
+
+	size_t batches = 0, rows = 0;
+	const auto id = monitor.Subscribe([&](const ProcessMonitor::Samples& batch) {
+		batches++;
+		rows += batch.Size();
+	});
+	for (int i = 0; i < 6; i++)
+		monitor.Sweep();
+	ASSERT_EQUAL("test_monitor_ring_and_subscribers", 6u, batches);
+	ASSERT_EQUAL("test_monitor_ring_and_subscribers", 6u, rows);
+
+	// Only the last four rows are kept, oldest first
+	const ProcessMonitor::Samples snapshot = monitor.Snapshot();
+	ASSERT_EQUAL("test_monitor_ring_and_subscribers", 4u, snapshot.Size());
+	// stat is not read by default
+	ASSERT_TRUE("test_monitor_ring_and_subscribers", snapshot.state.back() == '?');
+	for (size_t i = 1; i < snapshot.Size(); i++)
+		ASSERT_TRUE("test_monitor_ring_and_subscribers", snapshot.time[i - 1] < snapshot.time[i]);
+	ASSERT_EQUAL("test_monitor_ring_and_subscribers", 4u, monitor.History(self).size());
+	ASSERT_TRUE("test_monitor_ring_and_subscribers", monitor.History(self).back().time == snapshot.time.back());
+
+	monitor.Unsubscribe(id);
+	monitor.Sweep();
+	ASSERT_EQUAL("test_monitor_ring_and_subscribers", 6u, batches);
+
+	monitor.Unwatch(self);
+	ASSERT_EQUAL("test_monitor_ring_and_subscribers", 0u, monitor.Statistics().watched);
+	ASSERT_EQUAL("test_monitor_ring_and_subscribers", 7u, monitor.Statistics().sweeps);
+	RETURN_TEST("test_monitor_ring_and_subscribers", 0);
+}
+
+int test_monitor_thread() {
+	ProcessMonitor::Options opts;
+	opts.interval = std::chrono::milliseconds(20);
+	std::atomic<size_t> rows { 0 };
+	{
+		ProcessMonitor monitor(opts);
+		monitor.Subscribe([&rows](const ProcessMonitor::Samples& batch) { rows += batch.Size(); });
+		ASSERT_TRUE("test_monitor_thread", monitor.Watch(getpid()));
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		ASSERT_TRUE("test_monitor_thread", monitor.Statistics().sweeps >= 3);
+	}
+	ASSERT_TRUE("test_monitor_thread", rows >= 3);
+	RETURN_TEST("test_monitor_thread", 0);
+}
+
+int test_monitor_unwatch_during_sweep() {
+	ProcessMonitor monitor(Manual());
+	std::vector<std::unique_ptr<Process>> sleepers;
+	for (int i = 0; i < 8; i++) {
+		sleepers.push_back(std::make_unique<Process>("/bin/sleep", std::vector<std::string> { "5" }));
+		ASSERT_TRUE("test_monitor_unwatch_during_sweep", monitor.Watch(*sleepers.back()));
+	}
+	const pid_t toggled = sleepers.front()->Pid();
+
+	// Reads run unlocked: the watch list changes under a sweep in progress
+	std::atomic<bool> done { false };
+	std::thread sweeper([&] {
+		while (!done.load())
+			monitor.Sweep();
+	});
+	for (int i = 0; i < 500; i++) {
+		monitor.Unwatch(toggled);
+		monitor.Watch(toggled);
+		monitor.Statistics();
+	}
+	done = true;
+	sweeper.join();
+
+	monitor.Sweep();
+	ASSERT_EQUAL("test_monitor_unwatch_during_sweep", 8u, monitor.Statistics().watched);
+	for (const auto& sleeper: sleepers) {
+		const auto latest = monitor.Latest(sleeper->Pid());
+		ASSERT_TRUE("test_monitor_unwatch_during_sweep", latest.has_value() && latest->pid == sleeper->Pid());
+		kill(sleeper->Pid(), SIGTERM);
+	}
+	RETURN_TEST("test_monitor_unwatch_during_sweep", 0);
+}
+
+#endif
+
+int main() {
+	int result = 0;
+
+#ifdef LINUX
+	result += test_monitor_cpu_and_memory();
+	result += test_monitor_io();
+	result += test_monitor_ring_and_subscribers();
+	result += test_monitor_thread();
+	result += test_monitor_unwatch_during_sweep();
+#endif
+
+	if (result == 0) {
+		std::cout << "All tests passed!" << std::endl;
+	} else {
+		std::cout << result << " tests failed." << std::endl;
+	}
+	return result;
+}
@@ -228,6 +228,68 @@ int test_tr_pipeline() {
 	RETURN_TEST("test_tr_pipeline", 0);
 }
 
+int test_pipeline_shared_stdin() {
+	// Direct writes to a forwarding target stay blocking: nothing is dropped
+	StormByte::System::Process proc1("/bin/sh", { "-c", "head -c 5000000 /dev/zero; sleep 0.5" });
+	StormByte::System::Process proc2("/usr/bin/wc", { "-c" });
+
+	proc1 >> proc2;
+	proc2 << std::string(1 << 20, 'x');
+
+	std::string output;
+	proc2 >> output;
+	ASSERT_EQUAL("test_pipeline_shared_stdin", "6048576", Trim(output));
+	ASSERT_EQUAL("test_pipeline_shared_stdin", 0, proc1.Wait());
+	ASSERT_EQUAL("test_pipeline_shared_stdin", 0, proc2.Wait());
+
+	RETURN_TEST("test_pipeline_shared_stdin", 0);
+}
+
+int test_io_uring_engine() {
+	using StormByte::System::Process;
+	if (!Process::SetEngine(Process::Engine::IO_URING)) {
+		// Kernel without io_uring (or disabled): nothing to test
+		Process::SetEngine(Process::Engine::POLL);
+		RETURN_TEST("test_io_uring_engine", 0);
+	}
+	ASSERT_TRUE("test_io_uring_engine", Process::ActiveEngine() == Process::Engine::IO_URING);
+
+	{
+		Process proc1("/usr/bin/head", { "-c", "3000000", "/dev/zero" });
+		Process proc2("/bin/cat");
+		Process proc3("/usr/bin/wc", { "-c" });
+		proc1 >> proc2 >> proc3;
+
+		std::string output;
+		proc3 >> output;
+		ASSERT_EQUAL("test_io_uring_engine", "3000000", Trim(output));
+		ASSERT_EQUAL("test_io_uring_engine", 0, proc1.Wait());
+		ASSERT_EQUAL("test_io_uring_engine", 0, proc2.Wait());
+		ASSERT_EQUAL("test_io_uring_engine", 0, proc3.Wait());
+	}
+
+	{
+		// Consumer exits early: producer is terminated and drained
+		Process proc1("/usr/bin/yes");
+		Process proc2("/usr/bin/head", { "-n", "3" });
+		proc1 >> proc2;
+
+		std::string output;
+		proc2 >> output;
+		ASSERT_EQUAL("test_io_uring_engine", "y\ny\ny\n", output);
+		ASSERT_EQUAL("test_io_uring_engine", 0, proc2.Wait());
+		ASSERT_EQUAL("test_io_uring_engine", -1, proc1.Wait());
+	}
+
+	{
+		Process proc("/bin/false");
+		ASSERT_EQUAL("test_io_uring_engine", 1, proc.Wait());
+	}
+
+	Process::SetEngine(Process::Engine::POLL);
+	RETURN_TEST("test_io_uring_engine", 0);
+}
+
 #elifdef WINDOWS
 
 int test_basic_execution_windows() {
@@ -334,6 +396,8 @@ int main() {
 	result += test_exit_code_true();
 	result += test_move_process();
 	result += test_tr_pipeline();
+	result += test_pipeline_shared_stdin();
+	result += test_io_uring_engine();
 #elif defined(WINDOWS)
 	result += test_basic_execution_windows();
 	result += test_stdin_roundtrip_windows();
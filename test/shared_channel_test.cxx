@@ -0,0 +1,226 @@
+#include <StormByte/system/process.hxx>
+#include <StormByte/system/shared_channel.hxx>
+#include <StormByte/test_handlers.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef LINUX
+
+namespace {
+
+// Child side: echoes every byte received on the channel back to the parent
+int run_channel_child() {
+	sb_channel ch;
+	if (sb_channel_attach(&ch) < 0)
+		return 2;
+
+	for (;;) {
+		const char* in;
+		const size_t avail = sb_channel_peek(&ch, &in);
+		if (avail == 0) {
+			if (sb_channel_eof(&ch))
+				break;
+			sb_channel_wait(&ch, SB_CHANNEL_WANT_READ, -1);
+			continue;
+		}
+		char* out;
+		const size_t space = sb_channel_reserve(&ch, &out);
+		if (space == 0) {
+			sb_channel_wait(&ch, SB_CHANNEL_WANT_WRITE, -1);
+			continue;
+		}
+		const size_t chunk = avail < space ? avail : space;
+		std::memcpy(out, in, chunk);
+		sb_channel_commit(&ch, chunk);
+		sb_channel_consume(&ch, chunk);
+	}
+	sb_channel_close(&ch);
+	sb_channel_detach(&ch);
+	return 0;
+}
+
+// Child side: sends part of a stream, then hangs without closing the channel
+int run_channel_hang() {
+	sb_channel ch;
+	if (sb_channel_attach(&ch) < 0)
+		return 2;
+	char* out;
+	if (sb_channel_reserve(&ch, &out) < 7)
+		return 3;
+	std::memcpy(out, "partial", 7);
+	sb_channel_commit(&ch, 7);
+	for (;;)
+		pause();
+}
+
+// Grandchild side: reports to @p path once attached and once the channel hits EOF
+int run_channel_orphan(const char* path) {
+	sb_channel ch;
+	if (sb_channel_attach(&ch) < 0)
+		return 2;
+	std::ofstream(path, std::ios::app) << "attached\n";
+	for (;;) {
+		const char* in;
+		const size_t avail = sb_channel_peek(&ch, &in);
+		if (avail > 0) {
+			sb_channel_consume(&ch, avail);
+			continue;
+		}
+		if (sb_channel_eof(&ch))
+			break;
+		sb_channel_wait(&ch, SB_CHANNEL_WANT_READ, -1);
+	}
+	std::ofstream(path, std::ios::app) << "eof\n";
+	sb_channel_detach(&ch);
+	return 0;
+}
+
+// Child side: owns a channel shared with an orphan grandchild, then hangs until killed
+int run_channel_parent(const char* path) {
+	auto channel = std::make_shared<StormByte::System::SharedChannel>();
+	StormByte::System::Process::Options opts;
+	opts.channel = channel;
+	StormByte::System::Process proc("/proc/self/exe", { "--channel-orphan", path }, opts);
+	for (;;)
+		pause();
+}
+
+std::string read_file(const std::filesystem::path& path) {
+	std::ifstream file(path);
+	std::stringstream content;
+	content << file.rdbuf();
+	return content.str();
+}
+
+// Polls @p path until it holds @p expected or about 5 s went by
+bool wait_file(const std::filesystem::path& path, const std::string& expected) {
+	for (int i = 0; i < 500 && read_file(path) != expected; i++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	return read_file(path) == expected;
+}
+
+} // namespace
+
+int test_channel_roundtrip() {
+	auto channel = std::make_shared<StormByte::System::SharedChannel>(64 * 1024);
+	StormByte::System::Process::Options opts;
+	opts.channel = channel;
+	StormByte::System::Process proc("/proc/self/exe", { "--channel-child" }, opts);
+
+	std::string payload(3 * 1024 * 1024 + 17, '\0');
+	for (size_t i = 0; i < payload.size(); i++)
+		payload[i] = static_cast<char>('a' + i % 23);
+
+	std::thread writer([&] {
+		channel->Write(payload);
+		channel->Close();
+	});
+	std::string received;
+	channel->Read(received);
+	writer.join();
+
+	ASSERT_EQUAL("test_channel_roundtrip", payload.size(), received.size());
+	ASSERT_TRUE("test_channel_roundtrip", payload == received);
+
+	int exit_code = proc.Wait();
+	ASSERT_EQUAL("test_channel_roundtrip", 0, exit_code);
+
+	RETURN_TEST("test_channel_roundtrip", 0);
+}
+
+int test_channel_stdio_untouched() {
+	auto channel = std::make_shared<StormByte::System::SharedChannel>();
+	StormByte::System::Process::Options opts;
+	opts.channel = channel;
+	StormByte::System::Process proc("/bin/echo", { "control" }, opts);
+
+	std::string output;
+	proc >> output;
+	ASSERT_EQUAL("test_channel_stdio_untouched", "control\n", output);
+	ASSERT_EQUAL("test_channel_stdio_untouched", 0, proc.Wait());
+
+	RETURN_TEST("test_channel_stdio_untouched", 0);
+}
+
+int test_channel_child_killed() {
+	auto channel = std::make_shared<StormByte::System::SharedChannel>(4096);
+	StormByte::System::Process::Options opts;
+	opts.channel = channel;
+	StormByte::System::Process proc("/proc/self/exe", { "--channel-hang" }, opts);
+
+	// Killed mid-stream: it never calls sb_channel_close
+	const pid_t pid = proc.Pid();
+	std::thread killer([pid] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		kill(pid, SIGKILL);
+	});
+	std::string received;
+	channel->Read(received);
+	killer.join();
+
+	ASSERT_EQUAL("test_channel_child_killed", "partial", received);
+	ASSERT_TRUE("test_channel_child_killed", channel->EoF());
+	ASSERT_FALSE("test_channel_child_killed", channel->WaitReadable());
+	// Writes stop once the ring is full instead of waiting forever
+	ASSERT_TRUE("test_channel_child_killed", channel->Write(std::string(64 * 1024, 'x')) < 64 * 1024);
+	ASSERT_EQUAL("test_channel_child_killed", -1, proc.Wait());
+
+	RETURN_TEST("test_channel_child_killed", 0);
+}
+
+int test_channel_parent_killed() {
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / ("sb-channel-orphan-" + std::to_string(getpid()));
+	std::filesystem::remove(path);
+	StormByte::System::Process proc("/proc/self/exe", { "--channel-parent", path.string() });
+
+	ASSERT_TRUE("test_channel_parent_killed", wait_file(path, "attached\n"));
+	// The owner dies without closing: the grandchild must not wait forever
+	kill(proc.Pid(), SIGKILL);
+	ASSERT_EQUAL("test_channel_parent_killed", -1, proc.Wait());
+	const bool eof = wait_file(path, "attached\neof\n");
+	std::filesystem::remove(path);
+	ASSERT_TRUE("test_channel_parent_killed", eof);
+
+	RETURN_TEST("test_channel_parent_killed", 0);
+}
+
+#endif
+
+int main(int argc, char** argv) {
+	int result = 0;
+
+#ifdef LINUX
+	if (argc > 1 && std::string(argv[1]) == "--channel-child")
+		return run_channel_child();
+	if (argc > 1 && std::string(argv[1]) == "--channel-hang")
+		return run_channel_hang();
+	if (argc > 2 && std::string(argv[1]) == "--channel-orphan")
+		return run_channel_orphan(argv[2]);
+	if (argc > 2 && std::string(argv[1]) == "--channel-parent")
+		return run_channel_parent(argv[2]);
+
+	result += test_channel_roundtrip();
+	result += test_channel_stdio_untouched();
+	result += test_channel_child_killed();
+	result += test_channel_parent_killed();
+#else
+	(void)argc;
+	(void)argv;
+#endif
+
+	if (result == 0) {
+		std::cout << "All tests passed!" << std::endl;
+	} else {
+		std::cout << result << " tests failed." << std::endl;
+	}
+	return result;
+}
@@ -0,0 +1,138 @@
+#include <StormByte/system/process.hxx>
+#include <StormByte/system/trace.hxx>
+#include <StormByte/test_handlers.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using StormByte::System::CapturePolicy;
+using StormByte::System::Process;
+using StormByte::System::Trace;
+using namespace std::chrono_literals;
+
+#ifdef UNIX
+
+std::string ReadFile(const std::filesystem::path& file) {
+	std::ifstream in(file, std::ios::binary);
+	std::stringstream ss;
+	ss << in.rdbuf();
+	return ss.str();
+}
+
+bool HasEvent(const std::string& json, const std::string& name) {
+	return json.find("\"name\":\"" + name + "\"") != std::string::npos;
+}
+
+int test_trace_pipeline() {
+	const std::filesystem::path file = std::filesystem::temp_directory_path() / "stormbyte_trace_pipeline.json";
+	Trace::Enable();
+	ASSERT_TRUE("test_trace_pipeline", Trace::Enabled());
+
+	Process proc1("/usr/bin/seq", { "1", "10000" });
+	Process proc2("/bin/cat");
+	proc1 >> proc2;
+	proc2.Capture(Process::Stream::STDOUT, CapturePolicy::Discard());
+	ASSERT_EQUAL("test_trace_pipeline", 0, proc1.Wait());
+	ASSERT_EQUAL("test_trace_pipeline", 0, proc2.Wait());
+
+	Trace::Disable();
+	const size_t count = Trace::Flush(file);
+	const std::string json = ReadFile(file);
+	std::filesystem::remove(file);
+
+	ASSERT_TRUE("test_trace_pipeline", count > 0);
+	ASSERT_EQUAL("test_trace_pipeline", 0, json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+	for (const char* name: { "fork", "exec", "first-byte", "read", "write", "eof", "forward", "wait" })
+		ASSERT_TRUE("test_trace_pipeline", HasEvent(json, name));
+
+	RETURN_TEST("test_trace_pipeline", 0);
+}
+
+int test_trace_reap() {
+	const std::filesystem::path file = std::filesystem::temp_directory_path() / "stormbyte_trace_reap.json";
+	Trace::Enable();
+	std::atomic<bool> exited { false };
+	Process proc("/bin/true");
+	proc.Detach([&exited](int) { exited = true; });
+	for (int i = 0; i < 500 && !exited; i++)
+		std::this_thread::sleep_for(10ms);
+	Trace::Disable();
+
+	Trace::Flush(file);
+	const std::string json = ReadFile(file);
+	std::filesystem::remove(file);
+	ASSERT_TRUE("test_trace_reap", exited.load());
+	ASSERT_TRUE("test_trace_reap", HasEvent(json, "reap"));
+
+	RETURN_TEST("test_trace_reap", 0);
+}
+
+int test_trace_disabled() {
+	const std::filesystem::path file = std::filesystem::temp_directory_path() / "stormbyte_trace_disabled.json";
+	ASSERT_FALSE("test_trace_disabled", Trace::Enabled());
+
+	Process proc("/bin/echo", { "hello" });
+	proc.Capture(Process::Stream::STDOUT, CapturePolicy::Full());
+	ASSERT_EQUAL("test_trace_disabled", 0, proc.Wait());
+
+	ASSERT_EQUAL("test_trace_disabled", 0, Trace::Flush(file));
+	const std::string json = ReadFile(file);
+	std::filesystem::remove(file);
+	ASSERT_EQUAL("test_trace_disabled", "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n]}\n", json);
+
+	RETURN_TEST("test_trace_disabled", 0);
+}
+
+int test_trace_threads() {
+	// Several threads record at once; every event is flushed exactly once
+	const std::filesystem::path file = std::filesystem::temp_directory_path() / "stormbyte_trace_threads.json";
+	Trace::Enable();
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++) {
+		threads.emplace_back([] {
+			for (int i = 0; i < 5; i++) {
+				Process proc("/bin/true");
+				proc.Wait();
+			}
+		});
+	}
+	for (auto& thread: threads)
+		thread.join();
+	Trace::Disable();
+
+	const size_t count = Trace::Flush(file);
+	std::filesystem::remove(file);
+	// fork, exec and wait for each of the 20 processes
+	ASSERT_EQUAL("test_trace_threads", 60, count);
+	ASSERT_EQUAL("test_trace_threads", 0, Trace::Flush(file));
+	std::filesystem::remove(file);
+
+	RETURN_TEST("test_trace_threads", 0);
+}
+
+#endif
+
+int main() {
+	int result = 0;
+
+#ifdef UNIX
+	result += test_trace_pipeline();
+	result += test_trace_reap();
+	result += test_trace_disabled();
+	result += test_trace_threads();
+#endif
+
+	if (result == 0) {
+		std::cout << "All tests passed!" << std::endl;
+	} else {
+		std::cout << result << " tests failed." << std::endl;
+	}
+	return result;
+}